@@ -210,7 +210,12 @@ local function FFIBytearray_as_string(bytes)
     end
 end
 
+local function FFIBytearray_istype(value)
+    return FFI.istype(bytearray_type, value)
+end
+
 return {
     FFIBytearray = setmetatable(FFIBytearray, FFIBytearray),
-    FFIBytearray_as_string = FFIBytearray_as_string
+    FFIBytearray_as_string = FFIBytearray_as_string,
+    FFIBytearray_istype = FFIBytearray_istype
 }
@@ -39,6 +39,12 @@ end
 local Socket = {__index={
     send=function(self, ...) return network.__send(self.id, ...) end,
     recv=function(self, ...) return network.__recv(self.id, ...) end,
+    recv_into=function(self, ...) return network.__recv_into(self.id, ...) end,
+    stream_chunk=function(self, ...) return network.__stream_chunk(self.id, ...) end,
+    unstream_chunk=function(self, ...) return network.__unstream_chunk(self.id, ...) end,
+    receive_chunks=function(self) return network.__receive_chunks(self.id) end,
+    send_message=function(self, ...) return network.__send_message(self.id, ...) end,
+    recv_message=function(self, ...) return network.__recv_message(self.id, ...) end,
     close=function(self) return network.__close(self.id) end,
     available=function(self) return network.__available(self.id) or 0 end,
     is_alive=function(self) return network.__is_alive(self.id) end,
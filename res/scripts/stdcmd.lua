@@ -147,6 +147,79 @@ console.add_command(
     end
 )
 
+console.add_command(
+    "world.pregen x:int z:int width:int depth:int",
+    "Generate, light and save area of chunks (x, z - first chunk)",
+    function(args, kwargs)
+        local x, z, width, depth = unpack(args)
+        if width <= 0 or depth <= 0 then
+            return "area size must be positive"
+        end
+        world.pregenerate(x, z, width, depth)
+        return string.format(
+            "pre-generating %sx%s chunks, see log for progress", width, depth
+        )
+    end
+)
+
+console.add_command(
+    "world.pregen.status",
+    "Show world pre-generation progress",
+    function(args, kwargs)
+        local done, total = world.get_pregen_progress()
+        if done == nil then
+            return "pre-generation is not active"
+        end
+        return string.format(
+            "%s/%s chunks (%s%%)", done, total, math.floor(done * 100 / total)
+        )
+    end
+)
+
+local GENERATOR_STAGES = {
+    "wide-structures", "biomes", "heightmap", "structures",
+    "land", "density", "placements", "plants"
+}
+
+console.add_command(
+    "world.genprofile",
+    "Show world generator stages time of the last second",
+    function(args, kwargs)
+        local profile = generation.get_profile()
+        if profile == nil then
+            return "no world open"
+        end
+        local text = string.format(
+            "interval: %.0f ms", profile.interval / 1000
+        )
+        local function format_stats(name, stats)
+            return string.format(
+                "\n%s: %s calls, %.2f ms (script %.2f ms, native %.2f ms)",
+                name, stats.calls, stats.time / 1000,
+                stats["script-time"] / 1000, stats["native-time"] / 1000
+            )
+        end
+        for _, name in ipairs(GENERATOR_STAGES) do
+            text = text .. format_stats(name, profile.stages[name])
+        end
+        return text .. format_stats("total", profile.total)
+    end
+)
+
+console.add_command(
+    "world.genprofile.dump name:str='genprofile'",
+    "Save world generator stages time of the last second to a JSON file",
+    function(args, kwargs)
+        local profile = generation.get_profile()
+        if profile == nil then
+            return "no world open"
+        end
+        local filename = 'export:'..args[1]..'.json'
+        file.write(filename, json.tostring(profile, true))
+        return "generator profile has been saved as "..file.resolve(filename)
+    end
+)
+
 console.add_command(
     "player.respawn player:sel=$obj.id",
     "Respawn player entity",
@@ -313,4 +386,5 @@ console.cheats = {
     "entity.despawn",
     "player.respawn",
     "weather.set",
+    "world.pregen",
 }
@@ -282,6 +282,7 @@ end
 local bytearray = require "core:internal/bytearray"
 Bytearray = bytearray.FFIBytearray
 Bytearray_as_string = bytearray.FFIBytearray_as_string
+Bytearray_istype = bytearray.FFIBytearray_istype
 Bytearray_construct = function(...) return Bytearray(...) end
 ffi = nil
 
@@ -1,5 +1,6 @@
 #include "AssetsLoader.hpp"
 
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -47,6 +48,7 @@ void AssetsLoader::add(
     const std::string& alias,
     std::shared_ptr<AssetCfg> settings
 ) {
+    std::lock_guard lock(entriesMutex);
     if (enqueued.find({tag, alias}) != enqueued.end()){
         return;
     }
@@ -55,6 +57,7 @@ void AssetsLoader::add(
 }
 
 bool AssetsLoader::hasNext() const {
+    std::lock_guard lock(entriesMutex);
     return !entries.empty();
 }
 
@@ -69,21 +72,23 @@ aloader_func AssetsLoader::getLoader(AssetType tag) {
 }
 
 void AssetsLoader::loadNext() {
-    const aloader_entry& entry = entries.front();
+    aloader_entry entry;
+    {
+        std::lock_guard lock(entriesMutex);
+        entry = std::move(entries.front());
+        entries.pop();
+    }
     logger.info() << "loading " << entry.filename << " as " << entry.alias;
     try {
         aloader_func loader = getLoader(entry.tag);
         auto postfunc =
             loader(this, paths, entry.filename, entry.alias, entry.config);
         postfunc(&assets);
-        entries.pop();
     } catch (std::runtime_error& err) {
         logger.error() << err.what();
-        auto type = entry.tag;
-        std::string filename = entry.filename;
-        std::string reason = err.what();
-        entries.pop();
-        throw assetload::error(type, std::move(filename), std::move(reason));
+        throw assetload::error(
+            entry.tag, std::move(entry.filename), err.what()
+        );
     }
 }
 
@@ -116,6 +121,20 @@ void AssetsLoader::tryAddSound(const std::string& name) {
     add(AssetType::SOUND, file, name);
 }
 
+static const char* asset_type_name(AssetType tag) {
+    switch (tag) {
+        case AssetType::TEXTURE: return "textures";
+        case AssetType::SHADER: return "shaders";
+        case AssetType::FONT: return "fonts";
+        case AssetType::ATLAS: return "atlases";
+        case AssetType::LAYOUT: return "layouts";
+        case AssetType::SOUND: return "sounds";
+        case AssetType::MODEL: return "models";
+        case AssetType::POST_EFFECT: return "post-effects";
+    }
+    return "<error>";
+}
+
 static std::string assets_def_folder(AssetType tag) {
     switch (tag) {
         case AssetType::FONT:
@@ -323,37 +342,137 @@ const ResPaths& AssetsLoader::getPaths() const {
     return paths;
 }
 
-class LoaderWorker : public util::Worker<aloader_entry, assetload::postfunc> {
+struct AssetLoadJob {
+    /// @brief Enqueue order index
+    size_t index;
+    aloader_entry entry;
+    assetload::postfunc postfunc;
+    std::string error;
+    /// @brief Decode stage duration in microseconds
+    int64_t decodeTime = 0;
+};
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static int64_t elapsed_micros(clock_type::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        clock_type::now() - start
+    ).count();
+}
+
+class LoaderWorker : public util::Worker<
+                         std::shared_ptr<AssetLoadJob>,
+                         std::shared_ptr<AssetLoadJob>> {
     AssetsLoader* loader;
 public:
     LoaderWorker(AssetsLoader* loader) : loader(loader) {
     }
 
-    assetload::postfunc operator()(const aloader_entry& entry
+    std::shared_ptr<AssetLoadJob> operator()(
+        const std::shared_ptr<AssetLoadJob>& job
     ) override {
-        aloader_func loadfunc = loader->getLoader(entry.tag);
-        return loadfunc(
-            loader,
-            loader->getPaths(),
-            entry.filename,
-            entry.alias,
-            entry.config
-        );
+        auto startTime = clock_type::now();
+        const auto& entry = job->entry;
+        try {
+            aloader_func loadfunc = loader->getLoader(entry.tag);
+            job->postfunc = loadfunc(
+                loader,
+                loader->getPaths(),
+                entry.filename,
+                entry.alias,
+                entry.config
+            );
+        } catch (const std::exception& err) {
+            job->error = err.what();
+        }
+        job->decodeTime = elapsed_micros(startTime);
+        return job;
     }
 };
 
-std::shared_ptr<Task> AssetsLoader::startTask(runnable onDone) {
-    auto pool =
-        std::make_shared<util::ThreadPool<aloader_entry, assetload::postfunc>>(
+void AssetsLoader::finalize(AssetLoadJob& job) {
+    const auto& entry = job.entry;
+    logger.info() << "loading " << entry.filename << " as " << entry.alias;
+    try {
+        if (!job.error.empty()) {
+            throw std::runtime_error(job.error);
+        }
+        job.postfunc(&assets);
+    } catch (std::runtime_error& err) {
+        logger.error() << err.what();
+        throw assetload::error(entry.tag, entry.filename, err.what());
+    }
+}
+
+void AssetsLoader::loadAll(int maxWorkers) {
+    struct TypeStats {
+        size_t count = 0;
+        int64_t decodeTime = 0;
+        int64_t finalizeTime = 0;
+    };
+    std::map<AssetType, TypeStats> stats;
+    auto startTime = clock_type::now();
+
+    // decoded assets waiting for the previous ones to be finalized
+    std::map<size_t, std::shared_ptr<AssetLoadJob>> decoded;
+    util::ThreadPool<
+        std::shared_ptr<AssetLoadJob>,
+        std::shared_ptr<AssetLoadJob>>
+        pool(
             "assets-loader-pool",
-            [=]() { return std::make_shared<LoaderWorker>(this); },
-            [this](const assetload::postfunc& func) { func(&assets); }
+            [this]() { return std::make_shared<LoaderWorker>(this); },
+            [&decoded](std::shared_ptr<AssetLoadJob>& job) {
+                decoded[job->index] = job;
+            },
+            maxWorkers
         );
-    pool->setOnComplete(std::move(onDone));
-    while (!entries.empty()) {
-        aloader_entry entry = std::move(entries.front());
-        entries.pop();
-        pool->enqueueJob(std::move(entry));
+    pool.setStopOnFail(false);
+
+    size_t enqueuedCount = 0;
+    size_t finalizedCount = 0;
+    while (true) {
+        {
+            std::lock_guard lock(entriesMutex);
+            while (!entries.empty()) {
+                auto job = std::make_shared<AssetLoadJob>();
+                job->index = enqueuedCount++;
+                job->entry = std::move(entries.front());
+                entries.pop();
+                pool.enqueueJob(std::move(job));
+            }
+            if (finalizedCount == enqueuedCount) {
+                break;
+            }
+        }
+        pool.update();
+
+        bool finalized = false;
+        while (!decoded.empty() && decoded.begin()->first == finalizedCount) {
+            auto job = std::move(decoded.begin()->second);
+            decoded.erase(decoded.begin());
+
+            auto finalizeStart = clock_type::now();
+            finalize(*job);
+            auto& typeStats = stats[job->entry.tag];
+            typeStats.count++;
+            typeStats.decodeTime += job->decodeTime;
+            typeStats.finalizeTime += elapsed_micros(finalizeStart);
+
+            finalizedCount++;
+            finalized = true;
+        }
+        if (!finalized) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    logger.info() << "loaded " << finalizedCount << " assets in "
+                  << elapsed_micros(startTime) / 1000 << " ms using "
+                  << pool.getWorkersCount() << " thread(s)";
+    for (const auto& [type, typeStats] : stats) {
+        logger.info() << asset_type_name(type) << ": " << typeStats.count
+                      << ", decode " << typeStats.decodeTime / 1000
+                      << " ms, finalize " << typeStats.finalizeTime / 1000
+                      << " ms";
     }
-    return pool;
 }
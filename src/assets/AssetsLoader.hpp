@@ -4,6 +4,7 @@
 #include <map>
 #include <set>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 #include <utility>
@@ -70,15 +71,20 @@ struct aloader_entry {
     std::shared_ptr<AssetCfg> config;
 };
 
+struct AssetLoadJob;
+
 class AssetsLoader {
     Engine& engine;
     Assets& assets;
     std::map<AssetType, aloader_func> loaders;
     std::queue<aloader_entry> entries;
     std::set<std::pair<AssetType, std::string>> enqueued;
+    /// @brief Loaders may enqueue assets from worker threads
+    mutable std::mutex entriesMutex;
     const ResPaths& paths;
 
     void tryAddSound(const std::string& name);
+    void finalize(AssetLoadJob& job);
 
     void processPreload(
         AssetType tag, const std::string& name, const dv::value& map
@@ -107,7 +113,13 @@ public:
     /// @throws assetload::error
     void loadNext();
 
-    std::shared_ptr<Task> startTask(runnable onDone);
+    /// @brief Load all enqueued assets, including ones enqueued while
+    /// loading. Files are read and decoded in worker threads, then
+    /// finalized (GPU objects creation) in the current thread in the
+    /// enqueue order, so log messages order matches sequential loading
+    /// @param maxWorkers max number of worker threads (see util::ThreadPool)
+    /// @throws assetload::error
+    void loadAll(int maxWorkers = 0);
 
     const ResPaths& getPaths() const;
     aloader_func getLoader(AssetType tag);
@@ -1,6 +1,7 @@
 #include "assetload_funcs.hpp"
 
 #include <array>
+#include <cctype>
 #include <filesystem>
 #include <iostream>
 #include <stdexcept>
@@ -29,17 +30,33 @@
 #include "util/stringutil.hpp"
 #include "Assets.hpp"
 #include "AssetsLoader.hpp"
+#include "atlas_cache.hpp"
 
 static debug::Logger logger("assetload-funcs");
 
+static constexpr uint ATLAS_EXTRUSION = 2;
+
 namespace EngineFilesystem = std::filesystem;
 
-static bool load_animation(
-    Assets* assets,
+namespace {
+    /// @brief Packed animation frames of an atlas texture
+    struct AnimationSource {
+        std::string name;
+        std::unique_ptr<Atlas> atlas;
+        std::vector<std::pair<std::string, int>> frames;
+    };
+}
+
+static std::vector<AnimationSource> read_animations(
     const ResPaths& paths,
-    const std::string& atlasName,
     const std::string& directory,
-    const std::string& name,
+    const std::set<std::string>& names
+);
+
+static void store_animation(
+    Assets* assets,
+    const std::string& atlasName,
+    AnimationSource& source,
     Atlas* dstAtlas
 );
 
@@ -62,20 +79,6 @@ assetload::postfunc assetload::texture(
     }
 }
 
-static auto process_program(const ResPaths& paths, const std::string& filename) {
-    io::path vertexFile = paths.find(filename + ".glslv");
-    io::path fragmentFile = paths.find(filename + ".glslf");
-
-    std::string vertexSource = io::read_string(vertexFile);
-    std::string fragmentSource = io::read_string(fragmentFile);
-
-    auto& preprocessor = *Shader::preprocessor;
-
-    auto vertex = preprocessor.process(vertexFile, vertexSource);
-    auto fragment = preprocessor.process(fragmentFile, fragmentSource);
-    return std::make_pair(vertex, fragment);
-}
-
 static auto read_program(const ResPaths& paths, const std::string& filename) {
     io::path vertexFile = paths.find(filename + ".glslv");
     io::path fragmentFile = paths.find(filename + ".glslf");
@@ -119,28 +122,34 @@ assetload::postfunc assetload::posteffect(
     io::path effectFile = paths.find(file + ".glsl");
     std::string effectSource = io::read_string(effectFile);
 
-    auto& preprocessor = *Shader::preprocessor;
-    preprocessor.addHeader(
-        "__effect__", preprocessor.process(effectFile, effectSource, true)
-    );
-
-    auto [vertex, fragment] = process_program(paths, SHADERS_FOLDER + "/effect");
-    auto params = std::move(fragment.params);
-
-    std::string vertexSource = std::move(vertex.code);
-    std::string fragmentSource = std::move(fragment.code);
+    std::string programFile = SHADERS_FOLDER + "/effect";
+    io::path vertexFile = paths.find(programFile + ".glslv");
+    io::path fragmentFile = paths.find(programFile + ".glslf");
+    auto program = read_program(paths, programFile);
 
+    // preprocessor is shared by all effects, so the effect header is
+    // set and used in the main thread only
     return [=](auto assets) {
-        auto program = Shader::create(
-            {effectFile.string(), vertexSource},
-            {effectFile.string(), fragmentSource}
+        auto& preprocessor = *Shader::preprocessor;
+        preprocessor.addHeader(
+            "__effect__", preprocessor.process(effectFile, effectSource, true)
+        );
+        auto vertex = preprocessor.process(vertexFile, program.first);
+        auto fragment = preprocessor.process(fragmentFile, program.second);
+        auto params = std::move(fragment.params);
+
+        auto shader = Shader::create(
+            {effectFile.string(), std::move(vertex.code)},
+            {effectFile.string(), std::move(fragment.code)}
         );
         bool advanced = false;
         if (settings) {
             advanced = dynamic_cast<const PostEffectCfg*>(settings.get())->advanced;
         }
         assets->store(
-            std::make_shared<PostEffect>(advanced, std::move(program), params),
+            std::make_shared<PostEffect>(
+                advanced, std::move(shader), std::move(params)
+            ),
             name
         );
     };
@@ -158,6 +167,27 @@ static bool append_atlas(AtlasBuilder& atlas, const io::path& file) {
     return true;
 }
 
+/// @brief Map atlas name to a cache file name. Any character other than
+/// [A-Za-z0-9.-] (including '_' itself) is written as '_' followed by two
+/// hex digits, so distinct names never share a cache file.
+static io::path get_atlas_cache_file(const std::string& name) {
+    static const char* hex = "0123456789abcdef";
+    std::string filename;
+    filename.reserve(name.length());
+    for (char c : name) {
+        if (std::isalnum(static_cast<unsigned char>(c)) || c == '.' ||
+            c == '-') {
+            filename += c;
+        } else {
+            auto byte = static_cast<unsigned char>(c);
+            filename += '_';
+            filename += hex[byte >> 4];
+            filename += hex[byte & 0xF];
+        }
+    }
+    return EnginePaths::ATLASES_CACHE_FOLDER / (filename + ".atlas");
+}
+
 assetload::postfunc assetload::atlas(
     AssetsLoader* loader,
     const ResPaths& paths,
@@ -178,18 +208,47 @@ assetload::postfunc assetload::atlas(
         }
         return [](auto){};
     }
-    AtlasBuilder builder;
+    std::vector<io::path> files;
+    std::set<std::string> names;
     for (const auto& file : paths.listdir(directory)) {
         if (!imageio::is_read_supported(file.extension())) continue;
-        if (!append_atlas(builder, file)) continue;
+        // skip duplicates
+        if (!names.insert(file.stem()).second) continue;
+        files.push_back(file);
     }
-    std::set<std::string> names = builder.getNames();
-    Atlas* atlas = builder.build(2, false).release();
+    auto cacheFile = get_atlas_cache_file(name);
+    uint64_t cacheKey = atlas_cache::hash_sources(files, ATLAS_EXTRUSION);
+    std::unique_ptr<Atlas> cached;
+    try {
+        cached = atlas_cache::read(cacheFile, cacheKey);
+    } catch (const std::runtime_error& err) {
+        logger.warning() << "invalid atlas cache " << cacheFile.string()
+                         << ": " << err.what();
+    }
+    if (cached == nullptr) {
+        AtlasBuilder builder;
+        auto images = imageio::read_all(files);
+        for (size_t i = 0; i < files.size(); i++) {
+            images[i]->fixAlphaColor();
+            builder.add(files[i].stem(), std::move(images[i]));
+        }
+        cached = builder.build(ATLAS_EXTRUSION, false);
+        try {
+            atlas_cache::write(cacheFile, *cached, cacheKey);
+        } catch (const std::runtime_error& err) {
+            logger.warning() << "could not write atlas cache "
+                             << cacheFile.string() << ": " << err.what();
+        }
+    }
+    auto animations = std::make_shared<std::vector<AnimationSource>>(
+        read_animations(paths, directory, names)
+    );
+    Atlas* atlas = cached.release();
     return [=](auto assets) {
         atlas->prepare();
         assets->store(std::unique_ptr<Atlas>(atlas), name);
-        for (const auto& file : names) {
-            load_animation(assets, paths, name, directory, file, atlas);
+        for (auto& animation : *animations) {
+            store_animation(assets, name, animation, atlas);
         }
     };
 }
@@ -202,16 +261,22 @@ assetload::postfunc assetload::font(
     const std::shared_ptr<AssetCfg>&
 ) {
     auto pages = std::make_shared<std::vector<std::unique_ptr<ImageData>>>();
+    std::vector<io::path> files;
+    std::vector<size_t> indices;
     for (size_t i = 0; i <= 1024; i++) {
         std::string pagefile = filename + "_" + std::to_string(i) + ".png";
         auto file = paths.find(pagefile);
         if (io::exists(file)) {
-            pages->push_back(imageio::read(file));
+            files.push_back(file);
+            indices.push_back(i);
         } else if (i == 0) {
             throw std::runtime_error("font must have page 0");
-        } else {
-            pages->push_back(nullptr);
         }
+        pages->push_back(nullptr);
+    }
+    auto images = imageio::read_all(files);
+    for (size_t i = 0; i < images.size(); i++) {
+        pages->at(indices[i]) = std::move(images[i]);
     }
     return [=](auto assets) {
         int res = pages->at(0)->getHeight() / 16;
@@ -270,7 +335,10 @@ assetload::postfunc assetload::sound(
     auto cfg = std::dynamic_pointer_cast<SoundCfg>(config);
     bool keepPCM = cfg ? cfg->keepPCM : false;
 
-    std::unique_ptr<audio::Sound> baseSound = nullptr;
+    bool headerOnly = !keepPCM && audio::is_dummy();
+
+    // base sound and variants PCM, sounds are created in the main thread
+    std::vector<std::shared_ptr<audio::PCM>> pcms;
     static std::vector<std::string> extensions {".ogg", ".wav"};
     std::string extension;
     for (size_t i = 0; i < extensions.size(); i++) {
@@ -278,17 +346,17 @@ assetload::postfunc assetload::sound(
         // looking for 'sound_name' as base sound
         auto soundFile = paths.find(file + extension);
         if (io::exists(soundFile)) {
-            baseSound = audio::load_sound(soundFile, keepPCM);
+            pcms.emplace_back(audio::load_PCM(soundFile, headerOnly));
             break;
         }
         // looking for 'sound_name_0' as base sound
         auto variantFile = paths.find(file + "_0" + extension);
         if (io::exists(variantFile)) {
-            baseSound = audio::load_sound(variantFile, keepPCM);
+            pcms.emplace_back(audio::load_PCM(variantFile, headerOnly));
             break;
         }
     }
-    if (baseSound == nullptr) {
+    if (pcms.empty()) {
         throw std::runtime_error("could not to find sound: " + file);
     }
 
@@ -299,12 +367,15 @@ assetload::postfunc assetload::sound(
         if (!io::exists(variantFile)) {
             break;
         }
-        baseSound->variants.emplace_back(audio::load_sound(variantFile, keepPCM));
+        pcms.emplace_back(audio::load_PCM(variantFile, headerOnly));
     }
 
-    auto sound = baseSound.release();
     return [=](auto assets) {
-        assets->store(std::unique_ptr<audio::Sound>(sound), name);
+        auto sound = audio::create_sound(pcms[0], keepPCM);
+        for (size_t i = 1; i < pcms.size(); i++) {
+            sound->variants.emplace_back(audio::create_sound(pcms[i], keepPCM));
+        }
+        assets->store(std::move(sound), name);
     };
 }
 
@@ -418,7 +489,6 @@ static TextureAnimation create_animation(
     Atlas* srcAtlas,
     Atlas* dstAtlas,
     const std::string& name,
-    const std::set<std::string>& frameNames,
     const std::vector<std::pair<std::string, int>>& frameList
 ) {
     Texture* srcTex = srcAtlas->getTexture();
@@ -470,19 +540,23 @@ inline bool contains(
     return false;
 }
 
-static bool load_animation(
-    Assets* assets,
+/// @brief Read and pack frames of animated atlas textures.
+/// Does not create GPU objects
+static std::vector<AnimationSource> read_animations(
     const ResPaths& paths,
-    const std::string& atlasName,
     const std::string& directory,
-    const std::string& name,
-    Atlas* dstAtlas
+    const std::set<std::string>& names
 ) {
     std::string animsDir = directory + "/animation";
 
+    std::vector<AnimationSource> animations;
+    std::set<std::string> loaded;
     for (const auto& folder : paths.listdir(animsDir)) {
         if (!io::is_directory(folder)) continue;
-        if (folder.name() != name) continue;
+        std::string name = folder.name();
+        if (names.find(name) == names.end() || !loaded.insert(name).second) {
+            continue;
+        }
         //FIXME: if (EngineFilesystem::is_empty(folder)) continue;
 
         AtlasBuilder builder;
@@ -500,20 +574,31 @@ static bool load_animation(
             }
             if (!append_atlas(builder, file)) continue;
         }
-        auto srcAtlas = builder.build(2, true);
+        auto srcAtlas = builder.build(2, false);
         if (frameList.empty()) {
             for (const auto& frameName : builder.getNames()) {
                 frameList.emplace_back(frameName, 0);
             }
         }
-        auto animation = create_animation(
-            srcAtlas.get(), dstAtlas, name, builder.getNames(), frameList
+        animations.push_back(
+            AnimationSource {name, std::move(srcAtlas), std::move(frameList)}
         );
-        assets->store(
-            std::move(srcAtlas), atlasName + "/" + name + "_animation"
-        );
-        assets->store(animation);
-        return true;
     }
-    return true;
+    return animations;
+}
+
+static void store_animation(
+    Assets* assets,
+    const std::string& atlasName,
+    AnimationSource& source,
+    Atlas* dstAtlas
+) {
+    source.atlas->prepare();
+    auto animation = create_animation(
+        source.atlas.get(), dstAtlas, source.name, source.frames
+    );
+    assets->store(
+        std::move(source.atlas), atlasName + "/" + source.name + "_animation"
+    );
+    assets->store(animation);
 }
@@ -0,0 +1,123 @@
+#include "atlas_cache.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "coders/byte_utils.hpp"
+#include "coders/gzip.hpp"
+#include "constants.hpp"
+#include "graphics/core/Atlas.hpp"
+#include "graphics/core/ImageData.hpp"
+#include "graphics/core/Texture.hpp"
+#include "io/io.hpp"
+
+#define ATLAS_FORMAT_MAGIC ".VOXATL"
+
+/// @brief FNV-1a 64
+static void update_hash(uint64_t& hash, const void* data, size_t size) {
+    auto bytes = static_cast<const ubyte*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    }
+}
+
+uint64_t atlas_cache::hash_sources(
+    const std::vector<io::path>& files, uint extrusion
+) {
+    uint64_t hash = 14695981039346656037ULL;
+    int32_t params[] {
+        FORMAT_VERSION,
+        ENGINE_VERSION_MAJOR,
+        ENGINE_VERSION_MINOR,
+        static_cast<int32_t>(extrusion),
+        static_cast<int32_t>(Texture::MAX_RESOLUTION)};
+    update_hash(hash, params, sizeof(params));
+    for (const auto& file : files) {
+        auto name = file.name();
+        auto bytes = io::read_bytes(file);
+        uint64_t size = bytes.size();
+        update_hash(hash, name.data(), name.length() + 1);
+        update_hash(hash, &size, sizeof(size));
+        update_hash(hash, bytes.data(), bytes.size());
+    }
+    return hash;
+}
+
+std::vector<ubyte> atlas_cache::encode(const Atlas& atlas, uint64_t key) {
+    const auto& image = *atlas.getImage();
+    const auto& regions = atlas.getRegions();
+
+    ByteBuilder builder;
+    builder.put(reinterpret_cast<const ubyte*>(ATLAS_FORMAT_MAGIC), 8);
+    builder.putInt32(FORMAT_VERSION);
+    builder.putInt64(key);
+    builder.put(static_cast<ubyte>(image.getFormat()));
+    builder.putInt32(image.getWidth());
+    builder.putInt32(image.getHeight());
+    builder.putInt32(regions.size());
+    for (const auto& [name, region] : regions) {
+        builder.putCStr(name.c_str());
+        builder.putFloat32(region.u1);
+        builder.putFloat32(region.v1);
+        builder.putFloat32(region.u2);
+        builder.putFloat32(region.v2);
+    }
+    auto raster = gzip::compress(image.getData(), image.getDataSize());
+    builder.put(raster.data(), raster.size());
+    return builder.release();
+}
+
+std::unique_ptr<Atlas> atlas_cache::decode(
+    const ubyte* src, size_t size, uint64_t key
+) {
+    ByteReader reader(src, size);
+    reader.checkMagic(ATLAS_FORMAT_MAGIC, 8);
+    if (reader.getInt32() != FORMAT_VERSION ||
+        static_cast<uint64_t>(reader.getInt64()) != key) {
+        return nullptr;
+    }
+    auto format = static_cast<ImageFormat>(reader.get());
+    if (format != ImageFormat::rgb888 && format != ImageFormat::rgba8888) {
+        throw std::runtime_error("invalid atlas image format");
+    }
+    uint width = reader.getInt32();
+    uint height = reader.getInt32();
+    if (width == 0 || height == 0 || width > Texture::MAX_RESOLUTION ||
+        height > Texture::MAX_RESOLUTION) {
+        throw std::runtime_error("invalid atlas image size");
+    }
+    int count = reader.getInt32();
+
+    std::unordered_map<std::string, UVRegion> regions;
+    for (int i = 0; i < count; i++) {
+        std::string name = reader.getCString();
+        float u1 = reader.getFloat32();
+        float v1 = reader.getFloat32();
+        float u2 = reader.getFloat32();
+        float v2 = reader.getFloat32();
+        regions.try_emplace(std::move(name), u1, v1, u2, v2);
+    }
+    auto image = std::make_unique<ImageData>(format, width, height);
+    auto raster = gzip::decompress(
+        reader.pointer(), reader.remaining(), image->getDataSize()
+    );
+    if (raster.size() != image->getDataSize()) {
+        throw std::runtime_error("atlas image size mismatch");
+    }
+    std::memcpy(image->getData(), raster.data(), raster.size());
+    return std::make_unique<Atlas>(std::move(image), std::move(regions), false);
+}
+
+std::unique_ptr<Atlas> atlas_cache::read(const io::path& file, uint64_t key) {
+    if (!io::is_regular_file(file)) {
+        return nullptr;
+    }
+    auto bytes = io::read_bytes(file);
+    return decode(bytes.data(), bytes.size(), key);
+}
+
+void atlas_cache::write(const io::path& file, const Atlas& atlas, uint64_t key) {
+    auto bytes = encode(atlas, key);
+    io::create_directories(file.parent());
+    io::write_bytes(file, bytes.data(), bytes.size());
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "typedefs.hpp"
+#include "io/fwd.hpp"
+
+class Atlas;
+
+/// @brief Prebuilt atlases cache. Cached atlas contains packed raster
+/// and regions map. Cache entry is valid while the key (hash of source
+/// images names and content) matches
+namespace atlas_cache {
+    inline constexpr int FORMAT_VERSION = 1;
+
+    /// @brief Calculate atlas cache key
+    /// @param files source images in the order they are added to the atlas
+    /// @param extrusion atlas textures extrusion
+    /// @throws std::runtime_error if a file could not be read
+    uint64_t hash_sources(const std::vector<io::path>& files, uint extrusion);
+
+    /// @brief Encode atlas (raster is compressed with gzip)
+    std::vector<ubyte> encode(const Atlas& atlas, uint64_t key);
+
+    /// @brief Decode atlas. Texture is not generated
+    /// @return nullptr if the key or format version does not match
+    /// @throws std::runtime_error if data is malformed
+    std::unique_ptr<Atlas> decode(const ubyte* src, size_t size, uint64_t key);
+
+    /// @brief Read cached atlas if file exists and key matches
+    /// @throws std::runtime_error if cache file is malformed
+    std::unique_ptr<Atlas> read(const io::path& file, uint64_t key);
+
+    void write(const io::path& file, const Atlas& atlas, uint64_t key);
+}
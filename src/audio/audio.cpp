@@ -195,6 +195,10 @@ std::unique_ptr<PCM> audio::load_PCM(const io::path& file, bool headerOnly) {
     throw std::runtime_error("unsupported audio format");
 }
 
+bool audio::is_dummy() {
+    return backend->isDummy();
+}
+
 std::unique_ptr<Sound> audio::load_sound(const io::path& file, bool keepPCM) {
     std::shared_ptr<PCM> pcm(
         load_PCM(file, !keepPCM && backend->isDummy()).release()
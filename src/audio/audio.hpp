@@ -358,6 +358,9 @@ namespace audio {
     /// @param enabled try to initialize actual audio
     void initialize(bool enabled, AudioSettings& settings);
 
+    /// @brief Check if audio backend is dummy (see Backend::isDummy)
+    bool is_dummy();
+
     /// @brief Load audio file info and PCM data
     /// @param file audio file
     /// @param headerOnly read header only
@@ -9,19 +9,17 @@
 
 using namespace json;
 
-static void to_binary(ByteBuilder& builder, const dv::value& value) {
+static void value_to_binary(ByteBuilder& builder, const dv::value& value) {
     switch (value.getType()) {
         case dv::value_type::none:
             throw std::runtime_error("none value is not implemented");
-        case dv::value_type::object: {
-            const auto bytes = json::to_binary(value);
-            builder.put(bytes.data(), bytes.size());
+        case dv::value_type::object:
+            json::to_binary(builder, value);
             break;
-        }
         case dv::value_type::list:
             builder.put(BJSON_TYPE_LIST);
             for (const auto& element : value) {
-                to_binary(builder, element);
+                value_to_binary(builder, element);
             }
             builder.put(BJSON_END);
             break;
@@ -63,12 +61,8 @@ static void to_binary(ByteBuilder& builder, const dv::value& value) {
     }
 }
 
-std::vector<ubyte> json::to_binary(const dv::value& object, bool compress) {
-    if (compress) {
-        auto bytes = to_binary(object, false);
-        return gzip::compress(bytes.data(), bytes.size());
-    }
-    ByteBuilder builder;
+void json::to_binary(ByteBuilder& builder, const dv::value& object) {
+    size_t start = builder.size();
     // type byte
     builder.put(BJSON_TYPE_DOCUMENT);
     // document size
@@ -77,14 +71,22 @@ std::vector<ubyte> json::to_binary(const dv::value& object, bool compress) {
     // writing entries
     for (const auto& [key, value] : object.asObject()) {
         builder.putCStr(key.c_str());
-        to_binary(builder, value);
+        value_to_binary(builder, value);
     }
     // terminating byte
     builder.put(BJSON_END);
 
     // updating document size
-    builder.setInt32(1, builder.size());
-    return builder.build();
+    builder.setInt32(start + 1, builder.size() - start);
+}
+
+std::vector<ubyte> json::to_binary(const dv::value& object, bool compress) {
+    ByteBuilder builder;
+    to_binary(builder, object);
+    if (compress) {
+        return gzip::compress(builder.data(), builder.size());
+    }
+    return builder.release();
 }
 
 static dv::value list_from_binary(ByteReader& reader);
@@ -154,6 +156,85 @@ static dv::value object_from_binary(ByteReader& reader) {
     return obj;
 }
 
+dv::value json::from_binary(ByteReader& reader) {
+    dv::ArenaScope arena;
+    return value_from_binary(reader);
+}
+
+static void skip_bytes(ByteReader& reader, size_t size) {
+    if (size > reader.remaining()) {
+        throw std::runtime_error("buffer underflow");
+    }
+    reader.skip(size);
+}
+
+void json::skip_binary(ByteReader& reader) {
+    ubyte typecode = reader.get();
+    switch (typecode) {
+        case BJSON_TYPE_DOCUMENT: {
+            // size includes type byte and the size itself
+            int32_t size = reader.getInt32();
+            if (size < 6) {
+                throw std::runtime_error(
+                    "invalid document size " + std::to_string(size)
+                );
+            }
+            skip_bytes(reader, size - 5);
+            break;
+        }
+        case BJSON_TYPE_LIST:
+            while (reader.peek() != BJSON_END) {
+                skip_binary(reader);
+            }
+            reader.get();
+            break;
+        case BJSON_TYPE_BYTE:
+            skip_bytes(reader, 1);
+            break;
+        case BJSON_TYPE_INT16:
+            skip_bytes(reader, 2);
+            break;
+        case BJSON_TYPE_INT32:
+            skip_bytes(reader, 4);
+            break;
+        case BJSON_TYPE_INT64:
+        case BJSON_TYPE_NUMBER:
+            skip_bytes(reader, 8);
+            break;
+        case BJSON_TYPE_FALSE:
+        case BJSON_TYPE_TRUE:
+        case BJSON_TYPE_NULL:
+            break;
+        case BJSON_TYPE_STRING:
+        case BJSON_TYPE_BYTES:
+            skip_bytes(reader, static_cast<uint32_t>(reader.getInt32()));
+            break;
+        default:
+            throw std::runtime_error(
+                "type support not implemented for <" +
+                std::to_string(typecode) + ">"
+            );
+    }
+}
+
+void json::read_binary_object(
+    ByteReader& reader, const BinaryEntryHandler& handler
+) {
+    if (reader.get() != BJSON_TYPE_DOCUMENT) {
+        throw std::runtime_error("document expected");
+    }
+    reader.getInt32();
+    while (reader.peek() != BJSON_END) {
+        std::string_view key = reader.getCString();
+        const ubyte* value = reader.pointer();
+        handler(key, reader);
+        if (reader.pointer() == value) {
+            skip_binary(reader);
+        }
+    }
+    reader.get();
+}
+
 dv::value json::from_binary(const ubyte* src, size_t size) {
     if (size < 2) {
         throw std::runtime_error("bytes length is less than 2");
@@ -164,6 +245,6 @@ dv::value json::from_binary(const ubyte* src, size_t size) {
         return from_binary(data.data(), data.size());
     } else {
         ByteReader reader(src, size);
-        return value_from_binary(reader);
+        return from_binary(reader);
     }
 }
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <string_view>
 #include <vector>
 
 #include "data/dv.hpp"
 
 #include "typedefs.hpp"
 
+class ByteBuilder;
+class ByteReader;
+
 namespace json {
     inline constexpr int BJSON_END = 0x0;
     inline constexpr int BJSON_TYPE_DOCUMENT = 0x1;
@@ -23,7 +28,28 @@ namespace json {
     inline constexpr int BJSON_TYPE_NULL = 0xC;
     inline constexpr int BJSON_TYPE_CDOCUMENT = 0x1F;
 
+    using BinaryEntryHandler =
+        std::function<void(std::string_view key, ByteReader& reader)>;
+
     std::vector<ubyte> to_binary(const dv::value& obj, bool compress = false);
+
+    /// @brief Append uncompressed document to the builder. Nested documents
+    /// are written in place, their sizes are patched after
+    void to_binary(ByteBuilder& builder, const dv::value& obj);
     
     dv::value from_binary(const ubyte* src, size_t size);
+
+    /// @brief Read value at the reader position (uncompressed only)
+    dv::value from_binary(ByteReader& reader);
+
+    /// @brief Skip value at the reader position without decoding it.
+    /// Documents are skipped by their size
+    void skip_binary(ByteReader& reader);
+
+    /// @brief Iterate entries of the document at the reader position
+    /// without building dv::value for the entire document.
+    /// @param handler called for each entry with the reader at the entry
+    /// value. The handler reads the whole value (from_binary, skip_binary,
+    /// read_binary_object) or leaves it untouched to be skipped
+    void read_binary_object(ByteReader& reader, const BinaryEntryHandler& handler);
 }
@@ -16,10 +16,7 @@ void ByteBuilder::put(ubyte b) {
 
 void ByteBuilder::putCStr(const char* str) {
     size_t size = std::strlen(str) + 1;
-    buffer.reserve(buffer.size() + size);
-    for (size_t i = 0; i < size; i++) {
-        buffer.push_back(str[i]);
-    }
+    put(reinterpret_cast<const ubyte*>(str), size);
 }
 
 void ByteBuilder::put(const std::string& s) {
@@ -29,10 +26,9 @@ void ByteBuilder::put(const std::string& s) {
 }
 
 void ByteBuilder::put(const ubyte* arr, size_t size) {
-    buffer.reserve(buffer.size() + size);
-    for (size_t i = 0; i < size; i++) {
-        buffer.push_back(arr[i]);
-    }
+    // insert keeps geometric growth, while reserving the exact size
+    // reallocates the buffer on every call
+    buffer.insert(buffer.end(), arr, arr + size);
 }
 
 void ByteBuilder::putInt16(int16_t val, bool bigEndian) {
@@ -91,6 +87,10 @@ std::vector<ubyte> ByteBuilder::build() {
     return buffer;
 }
 
+std::vector<ubyte> ByteBuilder::release() {
+    return std::move(buffer);
+}
+
 ByteReader::ByteReader(const ubyte* data, size_t size)
     : data(data), size(size), pos(0) {
 }
@@ -39,11 +39,17 @@ public:
     inline size_t size() const {
         return buffer.size();
     }
+    /// @brief Remove written bytes keeping allocated memory
+    inline void clear() {
+        buffer.clear();
+    }
     inline const ubyte* data() const {
         return buffer.data();
     }
 
     std::vector<ubyte> build();
+    /// @brief Move written bytes out of the builder without copying
+    std::vector<ubyte> release();
 };
 
 class ByteReader {
@@ -7,6 +7,8 @@
 #include <zlib.h>
 
 #include <memory>
+#include <stdexcept>
+#include <string>
 
 std::vector<ubyte> gzip::compress(const ubyte* src, size_t size) {
     size_t buffer_size = 23 + size * 1.01;
@@ -63,3 +65,45 @@ std::vector<ubyte> gzip::decompress(const ubyte* src, size_t size) {
 
     return buffer;
 }
+
+std::vector<ubyte> gzip::decompress(
+    const ubyte* src, size_t size, size_t maxSize
+) {
+    // 10 bytes header + 8 bytes footer
+    if (size < 18 || src[0] != MAGIC[0] || src[1] != MAGIC[1]) {
+        throw std::runtime_error("invalid gzip data");
+    }
+    // getting uncompressed data length from gzip footer (little-endian)
+    const ubyte* footer = src + size - 4;
+    size_t decompressed_size = footer[0] | (footer[1] << 8) |
+                               (footer[2] << 16) |
+                               (static_cast<uint32_t>(footer[3]) << 24);
+    if (decompressed_size > maxSize) {
+        throw std::runtime_error(
+            "gzip data is too big (" + std::to_string(decompressed_size) +
+            " bytes)"
+        );
+    }
+    std::vector<ubyte> buffer(decompressed_size);
+
+    z_stream infstream {};
+    infstream.zalloc = Z_NULL;
+    infstream.zfree = Z_NULL;
+    infstream.opaque = Z_NULL;
+    infstream.avail_in = size;
+    infstream.next_in = src;
+    infstream.avail_out = decompressed_size;
+    infstream.next_out = buffer.data();
+
+    if (inflateInit2(&infstream, 16 + MAX_WBITS) != Z_OK) {
+        throw std::runtime_error("inflateInit2 failed");
+    }
+    int result = inflate(&infstream, Z_FINISH);
+    size_t total = infstream.total_out;
+    inflateEnd(&infstream);
+
+    if (result != Z_STREAM_END || total != decompressed_size) {
+        throw std::runtime_error("invalid gzip data");
+    }
+    return buffer;
+}
@@ -16,4 +16,14 @@ namespace gzip {
     /// @param src GZIP data
     /// @param size length of GZIP data
     std::vector<ubyte> decompress(const ubyte* src, size_t size);
+
+    /// Decompress untrusted bytes array from GZIP
+    /// @param src GZIP data
+    /// @param size length of GZIP data
+    /// @param maxSize max allowed length of decompressed data
+    /// @throws std::runtime_error if data is not a complete GZIP stream or
+    /// its decompressed length is greater than maxSize
+    std::vector<ubyte> decompress(
+        const ubyte* src, size_t size, size_t maxSize
+    );
 }
@@ -1,10 +1,12 @@
 #include "imageio.hpp"
 
 #include <functional>
+#include <thread>
 #include <unordered_map>
 
 #include "graphics/core/ImageData.hpp"
 #include "io/io.hpp"
+#include "util/ThreadPool.hpp"
 #include "png.hpp"
 
 using image_reader =
@@ -44,6 +46,78 @@ std::unique_ptr<ImageData> imageio::read(const io::path& file) {
     }
 }
 
+namespace {
+    struct DecodeJob {
+        size_t index;
+        io::path file;
+    };
+
+    struct DecodeResult {
+        size_t index;
+        std::unique_ptr<ImageData> image;
+        std::exception_ptr error;
+    };
+
+    class ImageDecodeWorker : public util::Worker<
+                                  std::shared_ptr<DecodeJob>,
+                                  std::shared_ptr<DecodeResult>> {
+    public:
+        std::shared_ptr<DecodeResult> operator()(
+            const std::shared_ptr<DecodeJob>& job
+        ) override {
+            auto result = std::make_shared<DecodeResult>();
+            result->index = job->index;
+            try {
+                result->image = imageio::read(job->file);
+            } catch (const std::exception&) {
+                result->error = std::current_exception();
+            }
+            return result;
+        }
+    };
+}
+
+std::vector<std::unique_ptr<ImageData>> imageio::read_all(
+    const std::vector<io::path>& files, int maxWorkers
+) {
+    std::vector<std::unique_ptr<ImageData>> images(files.size());
+    if (files.size() <= 1) {
+        for (size_t i = 0; i < files.size(); i++) {
+            images[i] = imageio::read(files[i]);
+        }
+        return images;
+    }
+    size_t remaining = files.size();
+    std::exception_ptr error;
+    util::ThreadPool<std::shared_ptr<DecodeJob>, std::shared_ptr<DecodeResult>>
+        threadPool(
+            "image-decoder",
+            []() { return std::make_shared<ImageDecodeWorker>(); },
+            [&](std::shared_ptr<DecodeResult>& result) {
+                if (result->error && error == nullptr) {
+                    error = result->error;
+                }
+                images[result->index] = std::move(result->image);
+                remaining--;
+            },
+            maxWorkers
+        );
+    threadPool.setStopOnFail(false);
+    for (size_t i = 0; i < files.size(); i++) {
+        threadPool.enqueueJob(
+            std::make_shared<DecodeJob>(DecodeJob {i, files[i]})
+        );
+    }
+    while (remaining) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        threadPool.update();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return images;
+}
+
 void imageio::write(const io::path& file, const ImageData* image) {
     auto found = writers.find(file.extension());
     if (found == writers.end()) {
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "io/fwd.hpp"
 
@@ -14,5 +15,14 @@ namespace imageio {
     bool is_write_supported(const std::string& extension);
 
     std::unique_ptr<ImageData> read(const io::path& file);
+
+    /// @brief Read and decode images in worker threads
+    /// @param files image files
+    /// @param maxWorkers max number of worker threads (see util::ThreadPool)
+    /// @return images in the same order as files
+    /// @throws std::runtime_error if any of images could not be read
+    std::vector<std::unique_ptr<ImageData>> read_all(
+        const std::vector<io::path>& files, int maxWorkers = 0
+    );
     void write(const io::path& file, const ImageData* image);
 }
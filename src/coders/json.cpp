@@ -21,6 +21,8 @@ namespace {
         dv::value parseList();
         dv::value parseObject();
         dv::value parseValue();
+        std::string parseQuotedString(char quote);
+        bool parseDecimal(dv::value& dst);
     };
 }
 
@@ -190,7 +192,7 @@ dv::value Parser::parseObject() {
             continue;
         }
         expect('"');
-        std::string key = parseString('"');
+        std::string key = parseQuotedString('"');
         char next = peek();
         if (next != ':') {
             throw error("':' expected");
@@ -233,10 +235,115 @@ dv::value Parser::parseList() {
     return list;
 }
 
+/// @brief Fast path for strings without escapes: the string end is found
+/// with util::find_any_of and the value is copied from the source at once
+std::string Parser::parseQuotedString(char quote) {
+    auto rest = source.substr(pos);
+    size_t length = util::find_any_of(rest, quote, '\\', '\n');
+    if (length < rest.length() && rest[length] == quote) {
+        pos += length + 1;
+        return std::string(rest.substr(0, length));
+    }
+    return parseString(quote);
+}
+
+static constexpr double POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/// @brief Locale-independent decimal numbers parsing. Numbers with
+/// mantissa up to 2^53 and decimal exponent up to 22 are converted exactly
+/// with a single multiplication or division. Digits exceeding 19 are
+/// accounted in the exponent only.
+/// @return false if the number must be parsed with BasicParser::parseNumber
+bool Parser::parseDecimal(dv::value& dst) {
+    constexpr int MAX_DIGITS = 19;
+
+    const char* chars = source.data();
+    size_t length = source.length();
+    size_t i = pos;
+    bool negative = false;
+    if (i < length && (chars[i] == '-' || chars[i] == '+')) {
+        negative = chars[i] == '-';
+        i++;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool integer = true;
+    size_t start = i;
+    for (; i < length && is_digit(chars[i]); i++) {
+        if (digits < MAX_DIGITS) {
+            mantissa = mantissa * 10 + (chars[i] - '0');
+            digits += mantissa != 0;
+        } else {
+            exponent++;
+            integer = false;
+        }
+    }
+    if (i == start) {
+        return false;
+    }
+    if (i < length && chars[i] == '.') {
+        integer = false;
+        for (i++; i < length && is_digit(chars[i]); i++) {
+            if (digits < MAX_DIGITS) {
+                mantissa = mantissa * 10 + (chars[i] - '0');
+                digits += mantissa != 0;
+                exponent--;
+            }
+        }
+    }
+    if (i < length && (chars[i] == 'e' || chars[i] == 'E')) {
+        integer = false;
+        i++;
+        bool negativeExponent = false;
+        if (i < length && (chars[i] == '-' || chars[i] == '+')) {
+            negativeExponent = chars[i] == '-';
+            i++;
+        }
+        int value = 0;
+        int exponentDigits = 0;
+        for (; i < length && is_digit(chars[i]); i++, exponentDigits++) {
+            value = value * 10 + (chars[i] - '0');
+        }
+        if (exponentDigits == 0 || exponentDigits > 4) {
+            return false;
+        }
+        exponent += negativeExponent ? -value : value;
+    }
+    // hexadecimal, binary, octal literals and '_' separators
+    if (i < length && is_identifier_part(chars[i])) {
+        return false;
+    }
+    if (integer && mantissa <= static_cast<uint64_t>(INT64_MAX)) {
+        auto value = static_cast<dv::integer_t>(mantissa);
+        dst = negative ? -value : value;
+    } else {
+        double value = static_cast<double>(mantissa);
+        if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+            if (exponent < 0) {
+                value /= POWERS_OF_TEN[-exponent];
+            } else {
+                value *= POWERS_OF_TEN[exponent];
+            }
+        } else {
+            value *= pow(10.0, exponent);
+        }
+        dst = negative ? -value : value;
+    }
+    pos = i;
+    return true;
+}
+
 dv::value Parser::parseValue() {
     char next = peek();
     if (next == '-' || next == '+' || is_digit(next)) {
-        auto numeric = parseNumber();
+        dv::value numeric;
+        if (parseDecimal(numeric)) {
+            return numeric;
+        }
+        numeric = parseNumber();
         if (numeric.isInteger()) {
             return numeric.asInteger();
         }
@@ -265,7 +372,7 @@ dv::value Parser::parseValue() {
     }
     if (next == '"' || next == '\'') {
         pos++;
-        return parseString(next);
+        return parseQuotedString(next);
     }
     throw error("unexpected character '" + std::string({next}) + "'");
 }
@@ -273,6 +380,7 @@ dv::value Parser::parseValue() {
 dv::value json::parse(
     std::string_view filename, std::string_view source
 ) {
+    dv::ArenaScope arena;
     Parser parser(filename, source);
     return parser.parse();
 }
@@ -1,5 +1,7 @@
 #include "rle.hpp"
 
+#include <stdexcept>
+
 #include "util/data_io.hpp"
 
 size_t rle::decode(const ubyte* src, size_t srclen, ubyte* dst) {
@@ -148,6 +150,39 @@ size_t extrle::decode16(const ubyte* src, size_t srclen, ubyte* dst8) {
     return offset * 2;
 }
 
+size_t extrle::decode16(
+    const ubyte* src, size_t srclen, ubyte* dst8, size_t dstlen
+) {
+    auto dst = reinterpret_cast<uint16_t*>(dst8);
+    size_t capacity = dstlen / 2;
+    size_t offset = 0;
+    for (size_t i = 0; i < srclen;) {
+        uint len = src[i++];
+        bool widechar = len & 0x40;
+        size_t required = 1 + ((len & 0x80) != 0) + widechar;
+        if (i + required > srclen) {
+            throw std::runtime_error("unexpected end of RLE data");
+        }
+        if (len & 0x80) {
+            len &= 0x3F;
+            len |= (static_cast<uint>(src[i++])) << 6;
+        } else {
+            len &= 0x3F;
+        }
+        uint16_t c = src[i++];
+        if (widechar) {
+            c |= ((static_cast<uint>(src[i++])) << 8);
+        }
+        if (offset + len + 1 > capacity) {
+            throw std::runtime_error("RLE data does not fit the buffer");
+        }
+        for (size_t j = 0; j <= len; j++) {
+            dst[offset++] = c;
+        }
+    }
+    return offset * 2;
+}
+
 size_t extrle::encode16(const ubyte* src8, size_t srclen, ubyte* dst) {
     if (srclen == 0) {
         return 0;
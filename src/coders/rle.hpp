@@ -18,4 +18,11 @@ namespace extrle {
     constexpr uint max_sequence16 = 0x3FFF;
     size_t encode16(const ubyte* src, size_t length, ubyte* dst);
     size_t decode16(const ubyte* src, size_t length, ubyte* dst);
+
+    /// @brief Decode with bounds checking (use for untrusted data)
+    /// @param dstlen destination buffer size in bytes
+    /// @throws std::runtime_error if data is malformed or does not fit
+    size_t decode16(
+        const ubyte* src, size_t length, ubyte* dst, size_t dstlen
+    );
 }
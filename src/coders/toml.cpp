@@ -236,6 +236,7 @@ void toml::parse(
 }
 
 dv::value toml::parse(std::string_view file, std::string_view source) {
+    dv::ArenaScope arena;
     return TomlReader(file, source).read();
 }
 
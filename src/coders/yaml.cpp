@@ -312,6 +312,7 @@ dv::value Parser::parseObject(dv::value&& object, int indent) {
 }
 
 dv::value yaml::parse(std::string_view filename, std::string_view source) {
+    dv::ArenaScope arena;
     return Parser(filename, source).parseObject(dv::object());
 }
 
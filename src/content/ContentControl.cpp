@@ -6,6 +6,7 @@
 #include "ContentPack.hpp"
 #include "ContentBuilder.hpp"
 #include "ContentLoader.hpp"
+#include "loading/PreloadedDefs.hpp"
 #include "PacksManager.hpp"
 #include "objects/rigging.hpp"
 #include "devtools/Project.hpp"
@@ -106,9 +107,14 @@ void ContentControl::loadContent() {
         resRoots.push_back({pack.id, pack.folder});
     }
     paths.resPaths = ResPaths(resRoots);
+    // Definition files are parsed in parallel (or restored from the cache),
+    // then merged sequentially
+    PreloadedDefs defs(EnginePaths::CONTENT_CACHE_FILE);
+    defs.preload(allPacks);
+
     // Load content
     for (auto& pack : allPacks) {
-        ContentLoader(&pack, contentBuilder, paths.resPaths).load();
+        ContentLoader(&pack, contentBuilder, paths.resPaths, defs).load();
         load_configs(input, pack.folder);
     }
     content = contentBuilder.build();
@@ -18,6 +18,7 @@ class ResPaths;
 class Content;
 class ContentBuilder;
 class ContentPackRuntime;
+class PreloadedDefs;
 struct ContentPackStats;
 
 class ContentLoader {
@@ -27,11 +28,12 @@ class ContentLoader {
     ContentBuilder& builder;
     ContentPackStats* stats;
     const ResPaths& paths;
+    const PreloadedDefs& defs;
 
     void loadGenerator(
         GeneratorDef& def, const std::string& full, const std::string& name
     );
-    static void loadBlockMaterial(BlockMaterial& def, const io::path& file);
+    static void loadBlockMaterial(BlockMaterial& def, const dv::value& root);
     void loadResources(ResourceType type, const dv::value& list);
     void loadResourceAliases(ResourceType type, const dv::value& aliases);
 
@@ -40,14 +42,16 @@ public:
     ContentLoader(
         ContentPack* pack,
         ContentBuilder& builder,
-        const ResPaths& paths
+        const ResPaths& paths,
+        const PreloadedDefs& defs
     );
 
     // Refresh pack content.json
     static bool fixPackIndices(
         const io::path& folder,
         dv::value& indicesRoot,
-        const std::string& contentSection
+        const std::string& contentSection,
+        const PreloadedDefs* defs = nullptr
     );
 
     static std::vector<std::tuple<std::string, std::string>> scanContent(
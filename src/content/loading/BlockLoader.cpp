@@ -1,5 +1,6 @@
 #define VC_ENABLE_REFLECTION
 #include "ContentUnitLoader.hpp"
+#include "PreloadedDefs.hpp"
 
 #include "../ContentBuilder.hpp"
 #include "coders/json.hpp"
@@ -86,7 +87,7 @@ static void load_variant(
 template<> void ContentUnitLoader<Block>::loadUnit(
     Block& def, const std::string& name, const io::path& file
 ) {
-    auto root = io::read_json(file);
+    auto root = defs.read(file);
     if (def.properties == nullptr) {
         def.properties = dv::object();
         def.properties["name"] = name;
@@ -7,6 +7,7 @@
 #include "data/dv_fwd.hpp"
 
 struct ContentPack;
+class PreloadedDefs;
 
 template<typename T> class ContentUnitBuilder;
 
@@ -15,11 +16,13 @@ class ContentUnitLoader {
 public:
     ContentUnitLoader(
         const ContentPack& pack,
+        const PreloadedDefs& defs,
         ContentUnitBuilder<DefT>& builder,
         const std::string& defsDir,
         std::function<void(DefT&)> postFunc = nullptr
     )
         : pack(pack),
+          defs(defs),
           builder(builder),
           defsDir(defsDir),
           postFunc(std::move(postFunc)) {
@@ -29,6 +32,7 @@ public:
     void loadDefs(const dv::value& root);
 private:
     const ContentPack& pack;
+    const PreloadedDefs& defs;
     ContentUnitBuilder<DefT>& builder;
     std::string defsDir;
     std::function<void(DefT&)> postFunc;
@@ -2,9 +2,11 @@
 #include "../ContentLoader.hpp"
 
 #include <algorithm>
+#include <zlib.h>
 
 #include "../ContentPack.hpp"
 
+#include "constants.hpp"
 #include "io/io.hpp"
 #include "io/engine_paths.hpp"
 #include "logic/scripting/scripting.hpp"
@@ -195,6 +197,34 @@ static void load_biomes(GeneratorDef& def, const dv::value& root) {
     }
 }
 
+static void load_density(DensityCarving& density, const dv::value& map) {
+    density.enabled = true;
+    map.at("block").get(density.block);
+    map.at("bpd").get(density.bpd);
+    map.at("vertical-bpd").get(density.verticalBpd);
+    map.at("frequency").get(density.frequency);
+    map.at("octaves").get(density.octaves);
+    map.at("threshold").get(density.threshold);
+    map.at("min-height").get(density.minHeight);
+    map.at("max-height").get(density.maxHeight);
+    map.at("surface-depth").get(density.surfaceDepth);
+    if (density.bpd == 0 || CHUNK_W % density.bpd || CHUNK_D % density.bpd) {
+        throw std::runtime_error(
+            "density bpd must be a divisor of chunk width and depth"
+        );
+    }
+    if (density.verticalBpd == 0) {
+        throw std::runtime_error("density vertical-bpd must be positive");
+    }
+    if (density.octaves == 0 ||
+        density.octaves > DensityCarving::MAX_OCTAVES) {
+        throw std::runtime_error(
+            "density octaves must be in range 1.." +
+            std::to_string(DensityCarving::MAX_OCTAVES)
+        );
+    }
+}
+
 void ContentLoader::loadGenerator(
     GeneratorDef& def, const std::string& full, const std::string& name
 ) {
@@ -217,6 +247,10 @@ void ContentLoader::loadGenerator(
 
     map.at("sea-level").get(def.seaLevel);
     map.at("wide-structs-chunks-radius").get(def.wideStructsChunksRadius);
+    map.at("batch-chunks").get(def.batchChunks);
+    if (def.batchChunks == 0) {
+        throw std::runtime_error("batch-chunks must be positive");
+    }
     if (map.has("heightmap-inputs")) {
         for (const auto& element : map["heightmap-inputs"]) {
             int index = element.asInteger();
@@ -227,6 +261,9 @@ void ContentLoader::loadGenerator(
             def.heightmapInputs.push_back(index - 1);
         }
     }
+    if (map.has("density")) {
+        load_density(def.density, map["density"]);
+    }
     if (!def.heightmapInputs.empty() && def.biomesBPD != def.heightsBPD) {
         logger.warning() << "generator has heightmap-inputs but biomes-bpd "
             "is not equal to heights-bpd, generator will work slower!";
@@ -247,6 +284,12 @@ void ContentLoader::loadGenerator(
         );
     }
     load_biomes(def, biomesMap);
+    if (io::is_regular_file(scriptFile)) {
+        auto source = io::read_string(scriptFile);
+        def.scriptHash = crc32(
+            0, reinterpret_cast<const ubyte*>(source.data()), source.length()
+        );
+    }
     def.script = scripting::load_generator(
         def, scriptFile, pack->id+":generators/"+name+".files");
 }
@@ -1,5 +1,6 @@
 #define VC_ENABLE_REFLECTION
 #include "ContentUnitLoader.hpp"
+#include "PreloadedDefs.hpp"
 
 #include "../ContentBuilder.hpp"
 #include "coders/json.hpp"
@@ -15,7 +16,7 @@ static debug::Logger logger("item-content-loader");
 template<> void ContentUnitLoader<ItemDef>::loadUnit(
     ItemDef& def, const std::string& name, const io::path& file
 ) {
-    auto root = io::read_json(file);
+    auto root = defs.read(file);
     def.properties = root;
 
     if (root.has("parent")) {
@@ -0,0 +1,203 @@
+#include "PreloadedDefs.hpp"
+
+#include <chrono>
+#include <memory>
+
+#include "../ContentPack.hpp"
+#include "constants.hpp"
+#include "debug/Logger.hpp"
+#include "util/ThreadPool.hpp"
+
+static debug::Logger logger("preloaded-defs");
+
+namespace {
+    struct ParsedFile {
+        io::path file;
+        dv::value root;
+        std::exception_ptr error;
+    };
+}
+
+static dv::value read_def(const io::path& file) {
+    if (file.extension() == ".json") {
+        return io::read_json(file);
+    }
+    return io::read_object(file);
+}
+
+class DefParseWorker
+    : public util::Worker<io::path, std::shared_ptr<ParsedFile>> {
+public:
+    std::shared_ptr<ParsedFile> operator()(const io::path& file) override {
+        auto result = std::make_shared<ParsedFile>();
+        result->file = file;
+        try {
+            result->root = read_def(file);
+        } catch (...) {
+            result->error = std::current_exception();
+        }
+        return result;
+    }
+};
+
+static void collect_files(const io::path& folder, std::vector<io::path>& dst) {
+    if (!io::is_directory(folder)) {
+        return;
+    }
+    for (const auto& file : io::directory_iterator(folder)) {
+        if (io::is_regular_file(file) && io::is_data_file(file)) {
+            dst.push_back(file);
+        } else if (io::is_directory(file) && file.extension() != ".files") {
+            collect_files(file, dst);
+        }
+    }
+}
+
+/// @brief FNV-1a hash of files paths, sizes and modification times
+static uint64_t hash_files(const std::vector<io::path>& files) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto update = [&hash](const void* data, size_t size) {
+        auto bytes = static_cast<const ubyte*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    update(ENGINE_VERSION_STRING.data(), ENGINE_VERSION_STRING.length());
+    for (const auto& file : files) {
+        auto name = file.string();
+        uint64_t size = io::file_size(file);
+        int64_t time = io::last_write_time(file).time_since_epoch().count();
+        update(name.data(), name.length() + 1);
+        update(&size, sizeof(size));
+        update(&time, sizeof(time));
+    }
+    return hash;
+}
+
+PreloadedDefs::PreloadedDefs(io::path cacheFile)
+    : cacheFile(std::move(cacheFile)) {
+}
+
+bool PreloadedDefs::loadCache(uint64_t hash) {
+    if (!io::is_regular_file(cacheFile)) {
+        return false;
+    }
+    auto root = io::read_binary_json(cacheFile);
+    if (root["format"].asInteger() != CACHE_FORMAT_VERSION ||
+        root["engine"].asString() != ENGINE_VERSION_STRING ||
+        static_cast<uint64_t>(root["hash"].asInteger()) != hash) {
+        return false;
+    }
+    for (const auto& [file, def] : root["files"].asObject()) {
+        files[file] = Entry {def, nullptr};
+    }
+    return true;
+}
+
+void PreloadedDefs::saveCache(uint64_t hash) const {
+    auto filesMap = dv::object();
+    for (const auto& [file, entry] : files) {
+        if (entry.error) {
+            // errors are reported on each load
+            return;
+        }
+        filesMap[file] = entry.root;
+    }
+    io::create_directories(cacheFile.parent());
+    io::write_binary_json(
+        cacheFile,
+        dv::object({
+            {"format", CACHE_FORMAT_VERSION},
+            {"engine", ENGINE_VERSION_STRING},
+            {"hash", static_cast<dv::integer_t>(hash)},
+            {"files", std::move(filesMap)},
+        })
+    );
+}
+
+void PreloadedDefs::preload(
+    const std::vector<ContentPack>& packs, int maxWorkers
+) {
+    std::vector<io::path> found;
+    for (const auto& pack : packs) {
+        collect_files(pack.folder / ContentPack::BLOCKS_FOLDER, found);
+        collect_files(pack.folder / ContentPack::ITEMS_FOLDER, found);
+        collect_files(pack.folder / ContentPack::ENTITIES_FOLDER, found);
+        collect_files(pack.folder / "block_materials", found);
+    }
+    if (found.empty()) {
+        return;
+    }
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    uint64_t hash = 0;
+    bool useCache = !cacheFile.empty();
+    if (useCache) {
+        try {
+            hash = hash_files(found);
+            if (loadCache(hash)) {
+                logger.info() << "restored " << files.size()
+                              << " definitions from cache";
+                return;
+            }
+        } catch (const std::exception& err) {
+            logger.warning() << "content cache is not available: "
+                             << err.what();
+            useCache = false;
+            files.clear();
+        }
+    }
+
+    size_t remaining = found.size();
+    util::ThreadPool<io::path, std::shared_ptr<ParsedFile>> threadPool(
+        "defs-parser",
+        []() { return std::make_shared<DefParseWorker>(); },
+        [this, &remaining](std::shared_ptr<ParsedFile>& result) {
+            files[result->file.string()] = Entry {
+                std::move(result->root), std::move(result->error)};
+            remaining--;
+        },
+        maxWorkers
+    );
+    threadPool.setStopOnFail(false);
+    for (auto& file : found) {
+        threadPool.enqueueJob(std::move(file));
+    }
+    while (remaining) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        threadPool.update();
+    }
+
+    auto endTime = std::chrono::high_resolution_clock::now();
+    logger.info() << "parsed " << files.size() << " definition files in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(
+                         endTime - startTime
+                     ).count()
+                  << " ms using " << threadPool.getWorkersCount()
+                  << " thread(s)";
+
+    if (useCache) {
+        try {
+            saveCache(hash);
+        } catch (const std::exception& err) {
+            logger.warning() << "could not write content cache: "
+                             << err.what();
+        }
+    }
+}
+
+dv::value PreloadedDefs::read(const io::path& file) const {
+    const auto& found = files.find(file.string());
+    if (found == files.end()) {
+        return read_def(file);
+    }
+    const auto& entry = found->second;
+    if (entry.error) {
+        std::rethrow_exception(entry.error);
+    }
+    return entry.root;
+}
+
+size_t PreloadedDefs::size() const {
+    return files.size();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <exception>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "io/io.hpp"
+#include "data/dv.hpp"
+
+struct ContentPack;
+
+/// @brief Content definition files read and parsed in worker threads.
+/// Definitions are merged into ContentBuilder sequentially by ContentLoader
+/// using the same order as before, so the result does not depend on
+/// threads scheduling.
+///
+/// Parsed definitions may be stored in a binary cache file keyed by
+/// engine version and a hash of definition files paths, sizes and
+/// modification times. If nothing has changed, files are not parsed at all.
+class PreloadedDefs {
+    struct Entry {
+        dv::value root;
+        std::exception_ptr error;
+    };
+    std::unordered_map<std::string, Entry> files;
+    io::path cacheFile;
+
+    bool loadCache(uint64_t hash);
+    void saveCache(uint64_t hash) const;
+public:
+    /// @brief Cache format version. Increment when definitions parsing
+    /// changes in a way the cached trees become different
+    static constexpr int CACHE_FORMAT_VERSION = 1;
+
+    PreloadedDefs() = default;
+
+    /// @param cacheFile parsed definitions cache file
+    explicit PreloadedDefs(io::path cacheFile);
+
+    /// @brief Read and parse blocks, items, entities and block materials
+    /// definition files of the packs (or restore them from the cache).
+    /// Blocks until all files are parsed
+    /// @param maxWorkers max number of worker threads (see util::ThreadPool)
+    void preload(const std::vector<ContentPack>& packs, int maxWorkers = 0);
+
+    /// @brief Get parsed file, reading it in the current thread
+    /// if it was not preloaded
+    /// @throws the same exceptions as io::read_object
+    dv::value read(const io::path& file) const;
+
+    size_t size() const;
+};
@@ -1,10 +1,308 @@
 #include "dv.hpp"
 
+#include <algorithm>
 #include <iostream>
 
+#include "util/Arena.hpp"
 #include "util/Buffer.hpp"
 
+namespace dv::objects {
+    static thread_local std::shared_ptr<util::Arena> current_arena;
+
+    Object::Object(std::shared_ptr<util::Arena> arena)
+        : arena(std::move(arena)) {
+    }
+
+    Object::Object(std::initializer_list<pair> pairs) {
+        for (const auto& [key, value] : pairs) {
+            (*this)[key] = value;
+        }
+    }
+
+    Object::Object(const Object& other) {
+        for (const auto& [key, value] : other) {
+            emplace(key).second = value;
+        }
+    }
+
+    Object::Object(Object&& other) noexcept
+        : arena(std::move(other.arena)),
+          blocks(other.blocks),
+          blocksCount(other.blocksCount),
+          arenaBlocks(other.arenaBlocks),
+          arenaBlocksArray(other.arenaBlocksArray),
+          count(other.count),
+          erasedCount(other.erasedCount),
+          erased(std::move(other.erased)),
+          freeIndices(std::move(other.freeIndices)),
+          table(std::move(other.table)),
+          tableErased(other.tableErased) {
+        other.blocks = nullptr;
+        other.blocksCount = 0;
+        other.arenaBlocks = 0;
+        other.arenaBlocksArray = false;
+        other.count = 0;
+        other.erasedCount = 0;
+        other.tableErased = 0;
+    }
+
+    Object::~Object() {
+        clear();
+    }
+
+    void Object::clear() noexcept {
+        uint32_t left = count;
+        for (uint32_t i = 0; i < blocksCount; i++) {
+            uint32_t size = std::min<uint32_t>(left, FIRST_BLOCK_SIZE << i);
+            for (uint32_t j = 0; j < size; j++) {
+                blocks[i][j].~pair();
+            }
+            left -= size;
+            deallocate(blocks[i], arenaBlocks & (1U << i));
+        }
+        deallocate(blocks, arenaBlocksArray);
+        blocks = nullptr;
+        blocksCount = 0;
+        arenaBlocks = 0;
+        arenaBlocksArray = false;
+        count = 0;
+        erasedCount = 0;
+        erased.clear();
+        freeIndices.clear();
+        table.clear();
+        tableErased = 0;
+    }
+
+    Object& Object::operator=(Object other) noexcept {
+        std::swap(arena, other.arena);
+        std::swap(blocks, other.blocks);
+        std::swap(blocksCount, other.blocksCount);
+        std::swap(arenaBlocks, other.arenaBlocks);
+        std::swap(arenaBlocksArray, other.arenaBlocksArray);
+        std::swap(count, other.count);
+        std::swap(erasedCount, other.erasedCount);
+        std::swap(erased, other.erased);
+        std::swap(freeIndices, other.freeIndices);
+        std::swap(table, other.table);
+        std::swap(tableErased, other.tableErased);
+        return *this;
+    }
+
+    void* Object::allocate(size_t size, bool& inArena) {
+        // the arena is not thread-safe, so it's used only in its scope
+        inArena = arena != nullptr && arena == current_arena;
+        if (inArena) {
+            return arena->allocate(size, alignof(pair));
+        }
+        return ::operator new(size);
+    }
+
+    void Object::deallocate(void* ptr, bool inArena) {
+        if (!inArena) {
+            ::operator delete(ptr);
+        }
+    }
+
+    void Object::addBlock() {
+        bool inArena;
+        auto newBlocks = static_cast<pair**>(
+            allocate(sizeof(pair*) * (blocksCount + 1), inArena)
+        );
+        std::copy(blocks, blocks + blocksCount, newBlocks);
+        deallocate(blocks, arenaBlocksArray);
+        blocks = newBlocks;
+        arenaBlocksArray = inArena;
+
+        blocks[blocksCount] = static_cast<pair*>(
+            allocate(sizeof(pair) * (FIRST_BLOCK_SIZE << blocksCount), inArena)
+        );
+        if (inArena) {
+            arenaBlocks |= 1U << blocksCount;
+        }
+        blocksCount++;
+    }
+
+    pair& Object::entry(uint32_t index) const {
+        uint32_t block = 0;
+        uint32_t blockSize = FIRST_BLOCK_SIZE;
+        while (index >= blockSize) {
+            index -= blockSize;
+            blockSize *= 2;
+            block++;
+        }
+        return blocks[block][index];
+    }
+
+    uint32_t Object::findIndex(const key_t& key) const {
+        if (table.empty()) {
+            for (uint32_t i = 0; i < count; i++) {
+                if (entry(i).first == key && !isErased(i)) {
+                    return i;
+                }
+            }
+            return EMPTY;
+        }
+        size_t mask = table.size() - 1;
+        for (size_t i = std::hash<key_t>()(key) & mask;; i = (i + 1) & mask) {
+            uint32_t index = table[i];
+            if (index == EMPTY) {
+                return EMPTY;
+            }
+            if (index != ERASED && entry(index).first == key) {
+                return index;
+            }
+        }
+    }
+
+    void Object::rebuildTable(size_t capacity) {
+        table.assign(capacity, EMPTY);
+        tableErased = 0;
+        size_t mask = capacity - 1;
+        for (uint32_t index = 0; index < count; index++) {
+            if (isErased(index)) {
+                continue;
+            }
+            size_t i = std::hash<key_t>()(entry(index).first) & mask;
+            while (table[i] != EMPTY) {
+                i = (i + 1) & mask;
+            }
+            table[i] = index;
+        }
+    }
+
+    void Object::insertToTable(uint32_t index) {
+        // keeping load factor below 0.5, erased marks included
+        if ((size() + tableErased) * 2 > table.size()) {
+            // sized by live entries, so erased marks are dropped
+            size_t capacity = 16;
+            while (capacity < size() * 4) {
+                capacity *= 2;
+            }
+            rebuildTable(capacity);
+            return;
+        }
+        size_t mask = table.size() - 1;
+        size_t i = std::hash<key_t>()(entry(index).first) & mask;
+        while (table[i] != EMPTY && table[i] != ERASED) {
+            i = (i + 1) & mask;
+        }
+        if (table[i] == ERASED) {
+            tableErased--;
+        }
+        table[i] = index;
+    }
+
+    pair& Object::emplace(key_t key) {
+        uint32_t index;
+        if (!freeIndices.empty()) {
+            index = freeIndices.back();
+            freeIndices.pop_back();
+            erased[index] = false;
+            erasedCount--;
+            this->entry(index).~pair();
+        } else {
+            if (count + FIRST_BLOCK_SIZE == FIRST_BLOCK_SIZE << blocksCount) {
+                // all blocks are full
+                addBlock();
+            }
+            index = count++;
+            if (!erased.empty()) {
+                erased.push_back(false);
+            }
+        }
+        auto& entry = *new (&this->entry(index)) pair(std::move(key), value());
+        if (!table.empty() || size() > LINEAR_SEARCH_MAX) {
+            insertToTable(index);
+        }
+        return entry;
+    }
+
+    value& Object::operator[](const key_t& key) {
+        uint32_t index = findIndex(key);
+        if (index != EMPTY) {
+            return entry(index).second;
+        }
+        return emplace(key).second;
+    }
+
+    size_t Object::erase(const key_t& key) {
+        uint32_t index = findIndex(key);
+        if (index == EMPTY) {
+            return 0;
+        }
+        if (!table.empty()) {
+            size_t mask = table.size() - 1;
+            size_t i = std::hash<key_t>()(key) & mask;
+            while (table[i] != index) {
+                i = (i + 1) & mask;
+            }
+            table[i] = ERASED;
+            tableErased++;
+        }
+        if (erased.empty()) {
+            erased.resize(count, false);
+        }
+        erased[index] = true;
+        erasedCount++;
+        freeIndices.push_back(index);
+        entry(index).second = nullptr;
+        return 1;
+    }
+
+    std::shared_ptr<Object> create_object() {
+        if (current_arena) {
+            return std::allocate_shared<Object>(
+                util::ArenaAllocator<Object>(current_arena), current_arena
+            );
+        }
+        return std::make_shared<Object>();
+    }
+
+    std::shared_ptr<Object> create_object(std::initializer_list<pair> pairs) {
+        if (current_arena) {
+            auto object = std::allocate_shared<Object>(
+                util::ArenaAllocator<Object>(current_arena), current_arena
+            );
+            for (const auto& [key, value] : pairs) {
+                (*object)[key] = value;
+            }
+            return object;
+        }
+        return std::make_shared<Object>(std::move(pairs));
+    }
+
+    std::shared_ptr<List> create_list() {
+        if (current_arena) {
+            return std::allocate_shared<List>(
+                util::ArenaAllocator<List>(current_arena)
+            );
+        }
+        return std::make_shared<List>();
+    }
+
+    std::shared_ptr<List> create_list(List&& values) {
+        if (current_arena) {
+            return std::allocate_shared<List>(
+                util::ArenaAllocator<List>(current_arena), std::move(values)
+            );
+        }
+        return std::make_shared<List>(std::move(values));
+    }
+}
+
 namespace dv {
+    ArenaScope::ArenaScope() : owner(objects::current_arena == nullptr) {
+        if (owner) {
+            objects::current_arena = std::make_shared<util::Arena>();
+        }
+    }
+
+    ArenaScope::~ArenaScope() {
+        if (owner) {
+            objects::current_arena = nullptr;
+        }
+    }
+
     value& value::operator[](const key_t& key) {
         check_type(type, value_type::object);
         return (*val.object)[key];
@@ -92,13 +390,13 @@ namespace dv {
 
     value& value::object() {
         check_type(type, value_type::list);
-        val.list->push_back(std::make_shared<objects::Object>());
+        val.list->push_back(objects::create_object());
         return val.list->operator[](val.list->size()-1);
     }
 
     value& value::list() {
         check_type(type, value_type::list);
-        val.list->push_back(std::make_shared<objects::List>());
+        val.list->push_back(objects::create_list());
         return val.list->operator[](val.list->size()-1);
     }
 
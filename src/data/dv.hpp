@@ -7,10 +7,12 @@
 #include <vector>
 #include <cstring>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 
 namespace util {
     template<class T> class Buffer;
+    class Arena;
 }
 
 namespace dv {
@@ -47,19 +49,179 @@ namespace dv {
 
     class value;
 
-    using list_t = std::vector<value>;
-    using map_t = std::unordered_map<key_t, value>;
     using pair = std::pair<const key_t, value>;
 
-    using reference = value&;
-    using const_reference = const value&;
-
     namespace objects {
-        using Object = std::unordered_map<key_t, value>;
+        /// @brief Hash map with open addressing, iterated in insertion
+        /// order. Entries are stored in blocks, each next twice bigger, so
+        /// references to entries stay valid until the entry is erased.
+        /// New entries take places of erased ones (and their position in
+        /// iteration order). Small objects are searched linearly without
+        /// hashing
+        class Object {
+            static constexpr size_t FIRST_BLOCK_SIZE = 4;
+            static constexpr size_t LINEAR_SEARCH_MAX = 8;
+            static constexpr uint32_t EMPTY = UINT32_MAX;
+            static constexpr uint32_t ERASED = UINT32_MAX - 1;
+
+            /// @brief Arena used for entries allocated while the ArenaScope
+            /// the object is created in is alive
+            std::shared_ptr<util::Arena> arena;
+            /// @brief Entries blocks, each next twice bigger than previous
+            pair** blocks = nullptr;
+            uint32_t blocksCount = 0;
+            /// @brief Bit mask of blocks allocated in the arena
+            uint32_t arenaBlocks = 0;
+            /// @brief Is blocks array allocated in the arena
+            bool arenaBlocksArray = false;
+            /// @brief Number of constructed entries including erased ones
+            uint32_t count = 0;
+            uint32_t erasedCount = 0;
+            /// @brief Empty until the first erase
+            std::vector<bool> erased;
+            /// @brief Indices of erased entries to be reused
+            std::vector<uint32_t> freeIndices;
+            /// @brief Open addressing table of entry indices.
+            /// Empty while all entries are searched linearly
+            std::vector<uint32_t> table;
+            /// @brief Number of ERASED marks in the table
+            uint32_t tableErased = 0;
+
+            pair& entry(uint32_t index) const;
+            bool isErased(uint32_t index) const {
+                return !erased.empty() && erased[index];
+            }
+            uint32_t findIndex(const key_t& key) const;
+            pair& emplace(key_t key);
+            void insertToTable(uint32_t index);
+            void rebuildTable(size_t capacity);
+            void addBlock();
+            void* allocate(size_t size, bool& inArena);
+            void deallocate(void* ptr, bool inArena);
+            void clear() noexcept;
+        public:
+            template <bool Const>
+            class basic_iterator {
+                friend class Object;
+
+                using object_ptr =
+                    std::conditional_t<Const, const Object*, Object*>;
+                object_ptr object;
+                uint32_t index;
+
+                basic_iterator(object_ptr object, uint32_t index)
+                    : object(object), index(index) {
+                    skipErased();
+                }
+
+                void skipErased() {
+                    while (index < object->count && object->isErased(index)) {
+                        index++;
+                    }
+                }
+            public:
+                using reference = std::conditional_t<Const, const pair&, pair&>;
+                using pointer = std::conditional_t<Const, const pair*, pair*>;
+
+                reference operator*() const {
+                    return object->entry(index);
+                }
+                pointer operator->() const {
+                    return &object->entry(index);
+                }
+                basic_iterator& operator++() {
+                    index++;
+                    skipErased();
+                    return *this;
+                }
+                bool operator==(const basic_iterator& o) const {
+                    return index == o.index;
+                }
+                bool operator!=(const basic_iterator& o) const {
+                    return index != o.index;
+                }
+            };
+            using iterator = basic_iterator<false>;
+            using const_iterator = basic_iterator<true>;
+
+            Object() = default;
+            explicit Object(std::shared_ptr<util::Arena> arena);
+            Object(std::initializer_list<pair> pairs);
+            Object(const Object& other);
+            Object(Object&& other) noexcept;
+            ~Object();
+
+            Object& operator=(Object other) noexcept;
+
+            value& operator[](const key_t& key);
+
+            iterator find(const key_t& key) {
+                uint32_t index = findIndex(key);
+                return iterator(this, index == EMPTY ? count : index);
+            }
+            const_iterator find(const key_t& key) const {
+                uint32_t index = findIndex(key);
+                return const_iterator(this, index == EMPTY ? count : index);
+            }
+
+            /// @brief Erase entry. References to other entries stay valid
+            /// @return number of erased entries
+            size_t erase(const key_t& key);
+
+            iterator begin() {
+                return iterator(this, 0);
+            }
+            iterator end() {
+                return iterator(this, count);
+            }
+            const_iterator begin() const {
+                return const_iterator(this, 0);
+            }
+            const_iterator end() const {
+                return const_iterator(this, count);
+            }
+            size_t size() const noexcept {
+                return count - erasedCount;
+            }
+            bool empty() const noexcept {
+                return size() == 0;
+            }
+        };
         using List = std::vector<value>;
         using Bytes = util::Buffer<byte_t>;
+
+        /// @brief Create object, allocated in the current ArenaScope arena
+        /// if there is one
+        std::shared_ptr<Object> create_object();
+        std::shared_ptr<Object> create_object(std::initializer_list<pair> pairs);
+        /// @brief Create list, allocated in the current ArenaScope arena
+        /// if there is one
+        std::shared_ptr<List> create_list();
+        std::shared_ptr<List> create_list(List&& values);
     }
 
+    using list_t = objects::List;
+    using map_t = objects::Object;
+
+    using reference = value&;
+    using const_reference = const value&;
+
+    /// @brief While alive, objects and lists created in the current thread
+    /// are allocated in one arena. Arena memory is released all at once
+    /// when the last value allocated there is destroyed, so any sub-value
+    /// kept after the root is destroyed keeps memory of the whole tree.
+    /// Nested scopes use the outer scope arena.
+    /// util::Arena is not thread-safe, so the arena is used by the scope
+    /// thread only while the scope is alive: objects growing later
+    /// allocate entries on the heap
+    class ArenaScope {
+        bool owner;
+    public:
+        ArenaScope();
+        ArenaScope(const ArenaScope&) = delete;
+        ~ArenaScope();
+    };
+
     /// @brief nullable value reference returned by value.at(...)
     struct optionalvalue {
         value* ptr;
@@ -197,7 +359,7 @@ namespace dv {
             this->operator=(std::move(v));
         }
         value(list_t values) {
-            this->operator=(std::make_shared<list_t>(std::move(values)));
+            this->operator=(objects::create_list(std::move(values)));
         }
 
         value(const value& v) noexcept : type(value_type::none) {
@@ -523,19 +685,19 @@ namespace dv {
     }
 
     inline value object() {
-        return std::make_shared<objects::Object>();
+        return objects::create_object();
     }
 
     inline value object(std::initializer_list<pair> pairs) {
-        return std::make_shared<objects::Object>(std::move(pairs));
+        return objects::create_object(std::move(pairs));
     }
 
     inline value list() {
-        return std::make_shared<objects::List>();
+        return objects::create_list();
     }
 
     inline value list(std::initializer_list<value> values) {
-        return std::make_shared<objects::List>(std::move(values));
+        return objects::create_list(objects::List(values));
     }
 
     template<typename T> inline bool get_to_int(value* ptr, T& dst) {
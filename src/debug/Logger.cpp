@@ -1,41 +1,64 @@
 #include "Logger.hpp"
 
 #include <chrono>
+#include <condition_variable>
 #include <ctime>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
 #include <utility>
 
+#include "binary_log.hpp"
+#include "util/MPSCRing.hpp"
+
 using namespace debug;
 
 static std::ofstream file;
+static LogFormat fileFormat = LogFormat::text;
+static binary_log::Encoder encoder;
+/// @brief Guards the file and console output
 static std::mutex mutex;
-static std::string utcOffset = "";
 constexpr unsigned int moduleLen = 20;
+/// @brief Max number of messages waiting for the writer thread
+constexpr size_t QUEUE_CAPACITY = 8192;
 
-LogMessage::~LogMessage() {
-    logger->log(level, ss.str());
-}
+#ifdef NDEBUG
+static std::atomic<LogLevel> defaultLevel {LogLevel::info};
+#else
+static std::atomic<LogLevel> defaultLevel {LogLevel::debug};
+#endif
 
-static void write(
-    LogLevel level, const std::string& name, const std::string& message
-) {
-    if (level == LogLevel::print) {
-        std::cout << "[" << name << "]    " << message << std::endl;
-        return;
-    }
+static std::tm local_time(std::time_t time) {
+    std::tm tm {};
+#ifdef _WIN32
+    localtime_s(&tm, &time);
+#else
+    localtime_r(&time, &tm);
+#endif
+    return tm;
+}
 
-    using namespace std::chrono;
+static const std::string& get_utc_offset() {
+    static const std::string utcOffset = []() {
+        std::stringstream ss;
+        auto tm = local_time(std::time(nullptr));
+        ss << std::put_time(&tm, "%z");
+        return ss.str();
+    }();
+    return utcOffset;
+}
 
+std::string debug::format_log_record(const LogRecord& record) {
+    if (record.level == LogLevel::print) {
+        return "[" + record.name + "]    " + record.message;
+    }
     std::stringstream ss;
-    switch (level) {
+    switch (record.level) {
         case LogLevel::print:
         case LogLevel::debug:
-#ifdef NDEBUG
-            return;
-#endif
             ss << "[D]";
             break;
         case LogLevel::info:
@@ -48,40 +71,234 @@ static void write(
             ss << "[E]";
             break;
     }
-    time_t tm = std::time(nullptr);
-    auto ms =
-        duration_cast<milliseconds>(system_clock::now().time_since_epoch()) %
-        1000;
-    ss << " " << std::put_time(std::localtime(&tm), "%Y/%m/%d %T");
-    ss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    ss << utcOffset << " [" << std::setfill(' ') << std::setw(moduleLen) << name
-       << "] ";
-    ss << message;
-    {
-        std::lock_guard<std::mutex> lock(mutex);
-        auto string = ss.str();
-        if (file.good()) {
+    auto tm = local_time(static_cast<std::time_t>(record.timestamp / 1000000));
+    auto ms = (record.timestamp / 1000) % 1000;
+    ss << " " << std::put_time(&tm, "%Y/%m/%d %T");
+    ss << '.' << std::setfill('0') << std::setw(3) << ms;
+    ss << get_utc_offset() << " [" << std::setfill(' ') << std::setw(moduleLen)
+       << record.name << "] ";
+    ss << record.message;
+    return ss.str();
+}
+
+/// @brief Must be called with the mutex locked
+static void write(const LogRecord& record) {
+    auto string = format_log_record(record);
+    if (record.level != LogLevel::print && file.good()) {
+        if (fileFormat == LogFormat::binary) {
+            encoder.write(file, record);
+        } else {
             file << string << '\n';
-            file.flush();
         }
-        std::cout << string << std::endl;
     }
+    std::cout << string << '\n';
 }
 
-void Logger::init(const std::string& filename) {
-    file.open(filename);
+namespace {
+    /// @brief Writes messages pushed by any thread in a dedicated thread
+    class AsyncWriter {
+        util::MPSCRing<LogRecord> queue {QUEUE_CAPACITY};
+        std::thread thread;
+        std::atomic<bool> running = false;
+        /// @brief Shared by pushing threads, exclusive when stopping, so a
+        /// record is never pushed after the final drain
+        std::shared_mutex stateMutex;
+        std::atomic<uint64_t> pushed = 0;
+        std::atomic<uint64_t> written = 0;
+        std::mutex wakeMutex;
+        /// @brief Wakes the writer thread
+        std::condition_variable wakeCondition;
+        /// @brief Notified by the writer thread after records are written
+        std::condition_variable drainCondition;
 
-    time_t tm = std::time(nullptr);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&tm), "%z");
-    utcOffset = ss.str();
+        void drain() {
+            LogRecord record {};
+            bool any = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                while (queue.tryPop(record)) {
+                    write(record);
+                    written++;
+                    any = true;
+                }
+                if (any) {
+                    file.flush();
+                    std::cout.flush();
+                }
+            }
+            if (any) {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+                drainCondition.notify_all();
+            }
+        }
+
+        /// @brief Wake the writer and wait until it writes records
+        /// @param target number of written records to wait for
+        void waitWritten(uint64_t target) {
+            wakeCondition.notify_one();
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            drainCondition.wait(lock, [this, target]() {
+                return written >= target;
+            });
+        }
+
+        void loop() {
+            while (running) {
+                drain();
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeCondition.wait_for(
+                    lock,
+                    std::chrono::milliseconds(10),
+                    [this]() { return !running || written != pushed; }
+                );
+            }
+            drain();
+        }
+    public:
+        void start() {
+            std::unique_lock<std::shared_mutex> lock(stateMutex);
+            if (running) {
+                return;
+            }
+            running = true;
+            thread = std::thread([this]() { loop(); });
+        }
+
+        void stop() {
+            {
+                std::unique_lock<std::shared_mutex> lock(stateMutex);
+                if (!running) {
+                    return;
+                }
+                running = false;
+            }
+            wakeCondition.notify_one();
+            thread.join();
+        }
+
+        /// @brief Queue the record for the writer thread
+        /// @return false if the writer is not running (record is untouched)
+        bool push(LogRecord& record) {
+            std::shared_lock<std::shared_mutex> lock(stateMutex);
+            if (!running) {
+                return false;
+            }
+            pushed++;
+            while (true) {
+                uint64_t seen = written;
+                if (queue.tryPush(std::move(record))) {
+                    break;
+                }
+                // queue is full, waiting for the writer to pop anything
+                waitWritten(seen + 1);
+            }
+            wakeCondition.notify_one();
+            return true;
+        }
+
+        void flush() {
+            uint64_t target = pushed;
+            // every pushed record is written by the final drain on stop
+            if (written < target) {
+                waitWritten(target);
+            }
+        }
+    };
+}
+
+/// @brief Never destroyed, so loggers may be used by static destructors
+static AsyncWriter& get_writer() {
+    static auto writer = new AsyncWriter();
+    return *writer;
+}
+
+LogMessage::LogMessage(Logger* logger, LogLevel level)
+    : logger(logger), level(level) {
+    if (logger->isEnabled(level)) {
+        ss.emplace();
+    }
+}
+
+LogMessage::~LogMessage() {
+    if (ss) {
+        logger->log(level, ss->str());
+    }
+}
+
+void Logger::init(const std::string& filename, LogFormat format, bool async) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fileFormat = format;
+        if (format == LogFormat::binary) {
+            file.open(filename, std::ios::binary);
+            encoder.writeHeader(file);
+        } else {
+            file.open(filename);
+        }
+    }
+    if (async) {
+        get_writer().start();
+        std::atexit(Logger::shutdown);
+    }
 }
 
 void Logger::flush() {
+    get_writer().flush();
     std::lock_guard<std::mutex> lock(mutex);
     file.flush();
+    std::cout.flush();
+}
+
+void Logger::shutdown() {
+    get_writer().stop();
+    std::lock_guard<std::mutex> lock(mutex);
+    file.flush();
+}
+
+void Logger::setDefaultLevel(LogLevel level) {
+    defaultLevel = level;
+}
+
+LogLevel Logger::getDefaultLevel() {
+    return defaultLevel;
+}
+
+void Logger::setLevel(LogLevel level) {
+    this->level = static_cast<int>(level);
+}
+
+bool Logger::isEnabled(LogLevel level) const {
+    if (level == LogLevel::print) {
+        return true;
+    }
+    int minLevel = this->level;
+    if (minLevel < 0) {
+        minLevel = static_cast<int>(defaultLevel.load());
+    }
+    return static_cast<int>(level) >= minLevel;
 }
 
 void Logger::log(LogLevel level, std::string message) {
-    write(level, name, std::move(message));
+    if (!isEnabled(level)) {
+        return;
+    }
+    using namespace std::chrono;
+    LogRecord record {
+        level,
+        duration_cast<microseconds>(system_clock::now().time_since_epoch())
+            .count(),
+        name,
+        std::move(message)};
+    auto& writer = get_writer();
+    if (writer.push(record)) {
+        // errors often precede a crash, so they must reach the file first
+        if (level == LogLevel::error) {
+            writer.flush();
+        }
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    write(record);
+    file.flush();
+    std::cout.flush();
 }
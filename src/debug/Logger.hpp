@@ -1,40 +1,87 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <optional>
 #include <sstream>
 
 namespace debug {
     enum class LogLevel { print, debug, info, warning, error };
 
+    /// @brief Log file format
+    enum class LogFormat {
+        text,
+        /// @brief Compact binary records (see debug/binary_log.hpp)
+        binary
+    };
+
+    struct LogRecord {
+        LogLevel level;
+        /// @brief Microseconds since epoch
+        int64_t timestamp;
+        std::string name;
+        std::string message;
+    };
+
     class Logger;
 
     class LogMessage {
         Logger* logger;
         LogLevel level;
-        std::stringstream ss;
+        /// @brief Empty if the level is disabled for the logger
+        std::optional<std::stringstream> ss;
     public:
-        LogMessage(Logger* logger, LogLevel level)
-            : logger(logger), level(level) {
-        }
+        LogMessage(Logger* logger, LogLevel level);
         ~LogMessage();
 
         template <class T>
         LogMessage& operator<<(const T& x) {
-            ss << x;
+            if (ss) {
+                *ss << x;
+            }
             return *this;
         }
     };
 
     class Logger {
         std::string name;
+        /// @brief Logger level or -1 to use the default one
+        std::atomic<int> level = -1;
     public:
-        static void init(const std::string& filename);
+        /// @param filename log file
+        /// @param format log file format
+        /// @param async write messages in a separate thread. Error messages
+        /// are still written before Logger::log returns
+        static void init(
+            const std::string& filename,
+            LogFormat format = LogFormat::text,
+            bool async = true
+        );
+
+        /// @brief Wait until all pushed messages are written
         static void flush();
 
+        /// @brief Stop the writer thread, writing remaining messages.
+        /// Next messages are written synchronously
+        static void shutdown();
+
+        /// @brief Set min level of messages for loggers having no level set
+        static void setDefaultLevel(LogLevel level);
+
+        static LogLevel getDefaultLevel();
+
         Logger(const std::string& name) : name(name) {
         }
 
+        /// @brief Set min level of messages written by the logger
+        void setLevel(LogLevel level);
+
+        /// @brief Check if messages of the level are written. Messages of
+        /// disabled levels are not formatted
+        bool isEnabled(LogLevel level) const;
+
         void log(LogLevel level, std::string message);
-        
+
         LogMessage debug() {
             return LogMessage(this, LogLevel::debug);
         }
@@ -50,10 +97,13 @@ namespace debug {
         LogMessage warning() {
             return LogMessage(this, LogLevel::warning);
         }
-        
+
         /// @brief Print-debugging tool (printed without header)
         LogMessage print() {
             return LogMessage(this, LogLevel::print);
         }
     };
+
+    /// @brief Format record as a text log line (without line break)
+    std::string format_log_record(const LogRecord& record);
 }
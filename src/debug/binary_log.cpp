@@ -0,0 +1,122 @@
+#include "binary_log.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "util/data_io.hpp"
+
+using namespace debug;
+
+template <typename T>
+static void write_int(std::ostream& dst, T value) {
+    value = dataio::h2le(value);
+    dst.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T read_int(std::istream& src) {
+    T value {};
+    if (!src.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("unexpected end of log");
+    }
+    return dataio::le2h(value);
+}
+
+/// @brief Read string of the declared length. Read by chunks, so a corrupted
+/// length does not allocate more than the stream actually contains
+static std::string read_string(std::istream& src, size_t length) {
+    constexpr size_t CHUNK_SIZE = 16 * 1024;
+    std::string string;
+    string.reserve(std::min(length, CHUNK_SIZE));
+    char buffer[CHUNK_SIZE];
+    while (string.length() < length) {
+        size_t size = std::min(length - string.length(), CHUNK_SIZE);
+        if (!src.read(buffer, size)) {
+            throw std::runtime_error(
+                "unexpected end of log: string of " + std::to_string(length) +
+                " bytes is truncated at " +
+                std::to_string(string.length() + src.gcount())
+            );
+        }
+        string.append(buffer, size);
+    }
+    return string;
+}
+
+void binary_log::Encoder::writeHeader(std::ostream& dst) {
+    dst.write(MAGIC, sizeof(MAGIC));
+    write_int<int32_t>(dst, VERSION);
+}
+
+void binary_log::Encoder::write(std::ostream& dst, const LogRecord& record) {
+    auto found = names.find(record.name);
+    uint16_t id;
+    if (found == names.end()) {
+        id = static_cast<uint16_t>(names.size());
+        names[record.name] = id;
+        auto length = static_cast<uint8_t>(std::min<size_t>(
+            record.name.length(), 0xFF
+        ));
+        write_int<uint8_t>(dst, RECORD_NAME);
+        write_int<uint16_t>(dst, id);
+        write_int<uint8_t>(dst, length);
+        dst.write(record.name.data(), length);
+    } else {
+        id = found->second;
+    }
+    write_int<uint8_t>(dst, RECORD_MESSAGE);
+    write_int<uint8_t>(dst, static_cast<uint8_t>(record.level));
+    write_int<int64_t>(dst, record.timestamp);
+    write_int<uint16_t>(dst, id);
+    write_int<uint32_t>(dst, record.message.length());
+    dst.write(record.message.data(), record.message.length());
+}
+
+size_t binary_log::decode(std::istream& src, std::ostream& dst) {
+    char magic[sizeof(MAGIC)];
+    if (!src.read(magic, sizeof(magic)) ||
+        std::string(magic, sizeof(magic)) != std::string(MAGIC, sizeof(MAGIC))) {
+        throw std::runtime_error("invalid binary log magic");
+    }
+    int version = read_int<int32_t>(src);
+    if (version != VERSION) {
+        throw std::runtime_error(
+            "unsupported binary log version " + std::to_string(version)
+        );
+    }
+    std::vector<std::string> names;
+    size_t count = 0;
+    LogRecord record {};
+    while (src.peek() != std::char_traits<char>::eof()) {
+        uint8_t type = read_int<uint8_t>(src);
+        if (type == RECORD_NAME) {
+            uint16_t id = read_int<uint16_t>(src);
+            uint8_t length = read_int<uint8_t>(src);
+            if (id >= names.size()) {
+                names.resize(id + 1);
+            }
+            names[id] = read_string(src, length);
+        } else if (type == RECORD_MESSAGE) {
+            uint8_t level = read_int<uint8_t>(src);
+            if (level > static_cast<uint8_t>(LogLevel::error)) {
+                throw std::runtime_error("invalid log level");
+            }
+            record.level = static_cast<LogLevel>(level);
+            record.timestamp = read_int<int64_t>(src);
+            uint16_t id = read_int<uint16_t>(src);
+            if (id >= names.size()) {
+                throw std::runtime_error("undefined logger name");
+            }
+            record.name = names[id];
+            record.message = read_string(src, read_int<uint32_t>(src));
+            dst << format_log_record(record) << '\n';
+            count++;
+        } else {
+            throw std::runtime_error(
+                "invalid record type " + std::to_string(type)
+            );
+        }
+    }
+    return count;
+}
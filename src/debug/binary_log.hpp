@@ -0,0 +1,33 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+#include "Logger.hpp"
+
+/// @brief Compact binary log format. File starts with the 8 bytes magic
+/// and int32 format version, followed by records (little-endian):
+/// - NAME: uint8 type, uint16 name id, uint8 length, name bytes.
+///   Written before the first message of a logger
+/// - MESSAGE: uint8 type, uint8 level, int64 timestamp (microseconds
+///   since epoch), uint16 name id, uint32 length, message bytes
+namespace debug::binary_log {
+    inline constexpr char MAGIC[] = ".VOXLOG";
+    inline constexpr int VERSION = 1;
+
+    inline constexpr uint8_t RECORD_NAME = 1;
+    inline constexpr uint8_t RECORD_MESSAGE = 2;
+
+    class Encoder {
+        std::unordered_map<std::string, uint16_t> names;
+    public:
+        void writeHeader(std::ostream& dst);
+        void write(std::ostream& dst, const LogRecord& record);
+    };
+
+    /// @brief Decode binary log to text log lines
+    /// @return number of decoded messages
+    /// @throws std::runtime_error if the log is malformed
+    size_t decode(std::istream& src, std::ostream& dst);
+}
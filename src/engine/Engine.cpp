@@ -317,18 +317,7 @@ void Engine::loadAssets() {
     auto new_assets = std::make_unique<Assets>();
     AssetsLoader loader(*this, *new_assets, paths.resPaths);
     AssetsLoader::addDefaults(loader, content);
-
-    // no need
-    // correct log messages order is more useful
-    bool threading = false; // look at two upper lines
-    if (threading) {
-        auto task = loader.startTask([=](){});
-        task->waitForEnd();
-    } else {
-        while (loader.hasNext()) {
-            loader.loadNext();
-        }
-    }
+    loader.loadAll();
     assets = std::move(new_assets);
     if (content) {
         ModelsGenerator::prepare(*content, *assets);
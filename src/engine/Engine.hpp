@@ -10,6 +10,7 @@
 #include "PostRunnables.hpp"
 #include "Time.hpp"
 
+#include <array>
 #include <memory>
 #include <string>
 
@@ -50,6 +51,12 @@ struct CoreParameters {
     std::filesystem::path userFolder = ".";
     std::filesystem::path scriptFile;
     std::filesystem::path projectFolder;
+    /// @brief Write log file in compact binary format
+    bool binaryLog = false;
+    /// @brief World to pre-generate in headless mode (see --pregen)
+    std::string pregenWorld;
+    /// @brief Pre-generated area: first chunk x, z, width and depth
+    std::array<int, 4> pregenArea {};
 };
 
 using OnWorldOpen = std::function<void(std::unique_ptr<Level>, int64_t)>;
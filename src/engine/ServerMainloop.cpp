@@ -2,6 +2,7 @@
 
 #include "Engine.hpp"
 #include "logic/scripting/scripting.hpp"
+#include "logic/EngineController.hpp"
 #include "logic/LevelController.hpp"
 #include "interfaces/Process.hpp"
 #include "debug/Logger.hpp"
@@ -26,6 +27,10 @@ void ServerMainloop::run() {
     const auto& coreParams = engine.getCoreParameters();
     auto& time = engine.getTime();
 
+    if (!coreParams.pregenWorld.empty()) {
+        runPregeneration();
+        return;
+    }
     if (coreParams.scriptFile.empty()) {
         logger.info() << "nothing to do";
         return;
@@ -78,6 +83,31 @@ void ServerMainloop::run() {
     logger.info() << "script finished";
 }
 
+void ServerMainloop::runPregeneration() {
+    const auto& coreParams = engine.getCoreParameters();
+    const auto& area = coreParams.pregenArea;
+
+    engine.setLevelConsumer([this](auto level, auto) {
+        setLevel(std::move(level));
+    });
+    engine.getController()->openWorld(coreParams.pregenWorld, true);
+    if (controller == nullptr) {
+        logger.error() << "could not open world " << coreParams.pregenWorld;
+        return;
+    }
+    // nothing else to do in the main thread, so whole tiles are processed
+    controller->pregenerate({area[0], area[1]}, {area[2], area[3]}, 0);
+    while (controller->updatePregeneration()) {
+        if (engine.isQuitSignal()) {
+            logger.info() << "pre-generation has been interrupted";
+            break;
+        }
+        engine.postUpdate();
+    }
+    controller->saveWorld();
+    engine.onWorldClosed();
+}
+
 void ServerMainloop::setLevel(std::unique_ptr<Level> level) {
     if (level == nullptr) {
         controller->onWorldQuit();
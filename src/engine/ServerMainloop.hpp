@@ -9,6 +9,8 @@ class Engine;
 class ServerMainloop {
     Engine& engine;
     std::unique_ptr<LevelController> controller;
+
+    void runPregeneration();
 public:
     ServerMainloop(Engine& engine);
     ~ServerMainloop();
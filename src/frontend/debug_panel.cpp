@@ -26,6 +26,7 @@
 #include "voxels/GlobalChunks.hpp"
 #include "world/Level.hpp"
 #include "world/World.hpp"
+#include "world/generator/WorldGenerator.hpp"
 
 #include <string>
 #include <memory>
@@ -41,6 +42,22 @@ static std::shared_ptr<Label> create_label(GUI& gui, wstringsupplier supplier) {
     return label;
 }
 
+/// @brief Format generator stages time in milliseconds per second
+static std::wstring format_generator_stages(const WorldGenerator* generator) {
+    if (generator == nullptr || generator->getProfile().interval == 0) {
+        return L"-";
+    }
+    const auto& profile = generator->getProfile();
+    std::wstring text;
+    for (size_t i = 0; i < static_cast<size_t>(GeneratorStage::COUNT); i++) {
+        auto stage = static_cast<GeneratorStage>(i);
+        double time = profile.stages[i].time * 1000.0 / profile.interval;
+        text += util::str2wstr_utf8(GeneratorProfiler::getStageName(stage)) +
+                L": " + util::to_wstring(time, 1) + L" ";
+    }
+    return text;
+}
+
 // TODO: move to xml
 // TODO: move to xml finally
 // TODO: move to xml finally
@@ -48,6 +65,7 @@ std::shared_ptr<UINode> create_debug_panel(
     Engine& engine, 
     Level& level, 
     Player& player,
+    const WorldGenerator* generator,
     bool allowDebugCheats
 ) {
     auto& gui = engine.getGUI();
@@ -176,6 +194,23 @@ std::shared_ptr<UINode> create_debug_panel(
     panel->add(create_label(gui, [&](){
         return L"seed: "+std::to_wstring(level.getWorld()->getSeed());
     }));
+    panel->add(create_label(gui, [generator]() {
+        if (generator == nullptr || generator->getProfile().interval == 0) {
+            return std::wstring {L"generator: -"};
+        }
+        const auto& profile = generator->getProfile();
+        auto total = profile.total();
+        return L"generator: " +
+               util::to_wstring(total.time * 1000.0 / profile.interval, 1) +
+               L" ms/s script: " +
+               util::to_wstring(
+                   total.scriptTime * 1000.0 / profile.interval, 1
+               ) +
+               L" ms/s";
+    }));
+    panel->add(create_label(gui, [generator]() {
+        return L"gen-stages: " + format_generator_stages(generator);
+    }));
 
     for (int ax = 0; ax < 3; ax++) {
         auto sub = std::make_shared<Container>(gui, glm::vec2(250, 27));
@@ -63,6 +63,7 @@ std::shared_ptr<UINode> create_debug_panel(
     Engine& engine,
     Level& level,
     Player& player,
+    const WorldGenerator* generator,
     bool allowDebugCheats
 );
 
@@ -182,7 +183,11 @@ Hud::Hud(Engine& engine, LevelFrontend& frontend, Player& player)
     uicamera->far = 1.0f;
 
     debugPanel = create_debug_panel(
-        engine, frontend.getLevel(), player, allowDebugCheats
+        engine,
+        frontend.getLevel(),
+        player,
+        frontend.getController()->getChunksController()->getGenerator(),
+        allowDebugCheats
     );
     debugPanel->setZIndex(2);
 
@@ -736,7 +741,11 @@ void Hud::setDebugCheats(bool flag) {
     
     gui.remove(debugPanel);
     debugPanel = create_debug_panel(
-        engine, frontend.getLevel(), player, allowDebugCheats
+        engine,
+        frontend.getLevel(),
+        player,
+        frontend.getController()->getChunksController()->getGenerator(),
+        allowDebugCheats
     );
     debugPanel->setZIndex(2);
     gui.add(debugPanel);
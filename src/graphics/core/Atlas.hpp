@@ -36,6 +36,8 @@ public:
 
     Texture* getTexture() const;
     ImageData* getImage() const;
+
+    const std::unordered_map<std::string, UVRegion>& getRegions() const;
 };
 
 struct atlasentry {
@@ -6,6 +6,15 @@
 #include <cmath>
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define IMAGEDATA_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define IMAGEDATA_NEON
+#endif
+
 ImageData::ImageData(ImageFormat format, uint width, uint height) 
     : format(format), width(width), height(height) {
     size_t pixsize;
@@ -37,23 +46,68 @@ ImageData::ImageData(ImageFormat format, uint width, uint height, const ubyte* d
 
 ImageData::~ImageData() = default;
 
+/// @brief Reverse order of RGBA pixels in the row
+static void reverse_rgba_row(ubyte* row, uint width) {
+    ubyte* left = row;
+    ubyte* right = row + width * 4;
+#if defined(IMAGEDATA_SSE2)
+    while (right - left >= 32) {
+        right -= 16;
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(left));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(right));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(left), _mm_shuffle_epi32(b, 0x1B)
+        );
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(right), _mm_shuffle_epi32(a, 0x1B)
+        );
+        left += 16;
+    }
+#elif defined(IMAGEDATA_NEON)
+    while (right - left >= 32) {
+        right -= 16;
+        uint32x4_t a = vrev64q_u32(vld1q_u32(reinterpret_cast<uint32_t*>(left)));
+        uint32x4_t b = vrev64q_u32(vld1q_u32(reinterpret_cast<uint32_t*>(right)));
+        vst1q_u32(
+            reinterpret_cast<uint32_t*>(left),
+            vcombine_u32(vget_high_u32(b), vget_low_u32(b))
+        );
+        vst1q_u32(
+            reinterpret_cast<uint32_t*>(right),
+            vcombine_u32(vget_high_u32(a), vget_low_u32(a))
+        );
+        left += 16;
+    }
+#endif
+    while (right - left >= 8) {
+        right -= 4;
+        std::swap_ranges(left, left + 4, right);
+        left += 4;
+    }
+}
+
+static void reverse_rgb_row(ubyte* row, uint width) {
+    ubyte* left = row;
+    ubyte* right = row + width * 3;
+    while (right - left >= 6) {
+        right -= 3;
+        std::swap_ranges(left, left + 3, right);
+        left += 3;
+    }
+}
+
 void ImageData::flipX() {
     switch (format) {
         case ImageFormat::rgb888:
-        case ImageFormat::rgba8888: {
-            uint size = (format == ImageFormat::rgba8888) ? 4 : 3;
             for (uint y = 0; y < height; y++) {
-                for (uint x = 0; x < width / 2; x++) {
-                    for (uint c = 0; c < size; c++) {
-                        ubyte temp = data[(y * width + x) * size + c];
-                        data[(y * width + x) * size + c] =
-                            data[(y * width + (width - x - 1)) * size + c];
-                        data[(y * width + (width - x - 1)) * size + c] = temp;
-                    }
-                }
+                reverse_rgb_row(data.get() + y * width * 3, width);
+            }
+            break;
+        case ImageFormat::rgba8888:
+            for (uint y = 0; y < height; y++) {
+                reverse_rgba_row(data.get() + y * width * 4, width);
             }
             break;
-        }
         default:
             throw std::runtime_error("format is not supported");
     }
@@ -64,15 +118,14 @@ void ImageData::flipY() {
         case ImageFormat::rgb888:
         case ImageFormat::rgba8888: {
             uint size = (format == ImageFormat::rgba8888) ? 4 : 3;
+            size_t stride = static_cast<size_t>(width) * size;
+            auto row = std::make_unique<ubyte[]>(stride);
             for (uint y = 0; y < height/2; y++) {
-                for (uint x = 0; x < width; x++) {
-                    for (uint c = 0; c < size; c++) {
-                        ubyte temp = data[(y * width + x) * size + c];
-                        data[(y * width + x) * size + c] = 
-                               data[((height-y-1) * width + x) * size + c];
-                        data[((height-y-1) * width + x) * size + c] = temp;
-                    }
-                }
+                ubyte* top = data.get() + y * stride;
+                ubyte* bottom = data.get() + (height - y - 1) * stride;
+                std::memcpy(row.get(), top, stride);
+                std::memcpy(top, bottom, stride);
+                std::memcpy(bottom, row.get(), stride);
             }
             break;
         }
@@ -188,24 +241,26 @@ void ImageData::drawLine(int x1, int y1, int x2, int y2, const glm::ivec4& color
 }
 
 void ImageData::blitRGB_on_RGBA(const ImageData& image, int x, int y) {
-    ubyte* source = image.getData();
-    uint srcwidth = image.getWidth();
-    uint srcheight = image.getHeight();
-
-    for (uint srcy = std::max(0, -y);
-         srcy < std::min(srcheight, height - y);
-         srcy++) {
-        for (uint srcx = std::max(0, -x);
-             srcx < std::min(srcwidth, width - x);
-             srcx++) {
-            uint dstx = srcx + x;
-            uint dsty = srcy + y;
-            uint dstidx = (dsty * width + dstx) * 4;
-            uint srcidx = (srcy * srcwidth + srcx) * 3;
-            for (uint c = 0; c < 3; c++) {
-                data[dstidx + c] = source[srcidx + c];
-            }
-            data[dstidx + 3] = 255;
+    const ubyte* source = image.getData();
+    int srcwidth = image.getWidth();
+    int srcheight = image.getHeight();
+
+    int srcx = std::max(0, -x);
+    int srcxEnd = std::min(srcwidth, static_cast<int>(width) - x);
+    int srcyEnd = std::min(srcheight, static_cast<int>(height) - y);
+    if (srcx >= srcxEnd) {
+        return;
+    }
+    for (int srcy = std::max(0, -y); srcy < srcyEnd; srcy++) {
+        const ubyte* src = source + (srcy * srcwidth + srcx) * 3;
+        ubyte* dst = data.get() + ((srcy + y) * width + srcx + x) * 4;
+        for (int i = srcx; i < srcxEnd; i++) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+            src += 3;
+            dst += 4;
         }
     }
 }
@@ -218,28 +273,23 @@ void ImageData::blitMatchingFormat(const ImageData& image, int x, int y) {
         default:
             throw std::runtime_error("only unsigned byte formats supported");    
     }
-    ubyte* source = image.getData();
-
-    const uint width = this->width;
-    const uint height = this->height;
-    const uint src_width = image.getWidth();
-    const uint src_height = image.getHeight();
-    ubyte* data = this->data.get();
-
-    for (uint srcy = std::max(0, -y);
-         srcy < std::min(src_height, height - y);
-         srcy++) {
-        for (uint srcx = std::max(0, -x);
-             srcx < std::min(src_width, width - x);
-             srcx++) {
-            uint dstx = srcx + x;
-            uint dsty = srcy + y;
-            uint dstidx = (dsty * width + dstx) * comps;
-            uint srcidx = (srcy * src_width + srcx) * comps;
-            for (uint c = 0; c < comps; c++) {
-                data[dstidx + c] = source[srcidx + c];
-            }
-        }
+    const ubyte* source = image.getData();
+    int srcwidth = image.getWidth();
+    int srcheight = image.getHeight();
+
+    int srcx = std::max(0, -x);
+    int srcxEnd = std::min(srcwidth, static_cast<int>(width) - x);
+    int srcyEnd = std::min(srcheight, static_cast<int>(height) - y);
+    if (srcx >= srcxEnd) {
+        return;
+    }
+    size_t rowSize = (srcxEnd - srcx) * comps;
+    for (int srcy = std::max(0, -y); srcy < srcyEnd; srcy++) {
+        std::memcpy(
+            data.get() + ((srcy + y) * width + srcx + x) * comps,
+            source + (srcy * srcwidth + srcx) * comps,
+            rowSize
+        );
     }
 }
 
@@ -253,122 +303,138 @@ void ImageData::extrude(int x, int y, int w, int h) {
         default:
             throw std::runtime_error("only unsigned byte formats supported");    
     }
+    const int width = this->width;
+    const int height = this->height;
+    ubyte* data = this->data.get();
+    auto copy_pixel = [=](int srcx, int srcy, int dstx, int dsty) {
+        std::memcpy(
+            data + (dsty * width + dstx) * comps,
+            data + (srcy * width + srcx) * comps,
+            comps
+        );
+    };
     int rx = x + w - 1;
     int ry = y + h - 1;
-    // top-left pixel
-    if (x > 0 && static_cast<uint>(x) < width && 
-        y > 0 && static_cast<uint>(y) < height) {
-        uint srcidx = (y * width + x) * comps;
-        uint dstidx = ((y - 1) * width + x - 1) * comps;
-        for (uint c = 0; c < comps; c++) {
-            data[dstidx + c] = data[srcidx + c];
-        }
-    }
-    
-    // top-right pixel
-    if (rx >= 0 && static_cast<uint>(rx) < width-1 && 
-          y > 0 && static_cast<uint>(y) < height) {
-        uint srcidx = (y * width + rx) * comps;
-        uint dstidx = ((y - 1) * width + rx + 1) * comps;
-        for (uint c = 0; c < comps; c++) {
-            data[dstidx + c] = data[srcidx + c];
-        }
+    bool left = x > 0 && x < width;
+    bool top = y > 0 && y < height;
+    bool right = rx >= 0 && rx < width - 1;
+    bool bottom = ry >= 0 && ry < height - 1;
+
+    // corner pixels
+    if (left && top) copy_pixel(x, y, x - 1, y - 1);
+    if (right && top) copy_pixel(rx, y, rx + 1, y - 1);
+    if (left && bottom) copy_pixel(x, ry, x - 1, ry + 1);
+    if (right && bottom) copy_pixel(rx, ry, rx + 1, ry + 1);
+
+    // left and right borders
+    int ystart = std::max(y, 0);
+    int yend = std::min(y + h, height);
+    for (int ey = ystart; ey < yend; ey++) {
+        if (left) copy_pixel(x, ey, x - 1, ey);
+        if (right) copy_pixel(rx, ey, rx + 1, ey);
     }
 
-    // bottom-left pixel
-    if (x > 0 && static_cast<uint>(x) < width && 
-        ry >= 0 && static_cast<uint>(ry) < height-1) {
-        uint srcidx = (ry * width + x) * comps;
-        uint dstidx = ((ry + 1) * width + x - 1) * comps;
-        for (uint c = 0; c < comps; c++) {
-            data[dstidx + c] = data[srcidx + c];
-        }
-    }
-    
-    // bottom-right pixel
-    if (rx >= 0 && static_cast<uint>(rx) < width-1 && 
-        ry >= 0 && static_cast<uint>(ry) < height-1) {
-        uint srcidx = (ry * width + rx) * comps;
-        uint dstidx = ((ry + 1) * width + rx + 1) * comps;
-        for (uint c = 0; c < comps; c++) {
-            data[dstidx + c] = data[srcidx + c];
-        }
-    }
-
-    // left border
-    if (x > 0 && static_cast<uint>(x) < width) {
-        for (uint ey = std::max(y, 0); static_cast<int>(ey) < y + h; ey++) {
-            uint srcidx = (ey * width + x) * comps;
-            uint dstidx = (ey * width + x - 1) * comps;
-            for (uint c = 0; c < comps; c++) {
-                data[dstidx + c] = data[srcidx + c];
-            }
-        }
+    // top and bottom borders are contiguous rows
+    int xstart = std::max(x, 0);
+    int xend = std::min(x + w, width);
+    if (xstart >= xend) {
+        return;
     }
-
-    // top border
-    if (y > 0 && static_cast<uint>(y) < height) {
-        for (uint ex = std::max(x, 0); static_cast<int>(ex) < x + w; ex++) {
-            uint srcidx = (y * width + ex) * comps;
-            uint dstidx = ((y-1) * width + ex) * comps;
-            for (uint c = 0; c < comps; c++) {
-                data[dstidx + c] = data[srcidx + c];
-            }
-        }
+    size_t rowSize = (xend - xstart) * comps;
+    if (top) {
+        std::memcpy(
+            data + ((y - 1) * width + xstart) * comps,
+            data + (y * width + xstart) * comps,
+            rowSize
+        );
     }
-    
-    // right border
-    if (rx >= 0 && static_cast<uint>(rx) < width-1) {
-        for (uint ey = std::max(y, 0); static_cast<int>(ey) < y + h; ey++) {
-            uint srcidx = (ey * width + rx) * comps;
-            uint dstidx = (ey * width + rx + 1) * comps;
-            for (uint c = 0; c < comps; c++) {
-                data[dstidx + c] = data[srcidx + c];
-            }
-        }
-    }
-
-    // bottom border
-    if (ry >= 0 && static_cast<uint>(ry) < height-1) {
-        for (uint ex = std::max(x, 0); static_cast<int>(ex) < x + w; ex++) {
-            uint srcidx = (ry * width + ex) * comps;
-            uint dstidx = ((ry+1) * width + ex) * comps;
-            for (uint c = 0; c < comps; c++) {
-                data[dstidx + c] = data[srcidx + c];
-            }
-        }
+    if (bottom) {
+        std::memcpy(
+            data + ((ry + 1) * width + xstart) * comps,
+            data + (ry * width + xstart) * comps,
+            rowSize
+        );
     }
 }
 
 // Fixing black transparent pixels for Mip-Mapping
 void ImageData::fixAlphaColor() {
+    if (format != ImageFormat::rgba8888) {
+        return;
+    }
+    ubyte* data = this->data.get();
+    size_t pixels = static_cast<size_t>(width) * height;
+    size_t i = 0;
     int samples = 0;
-    int sums[3] {};
-    for (uint ly = 0; ly < height; ly++) {
-        for (uint lx = 0; lx < width; lx++) {
-            if (data[(ly * width + lx) * 4 + 3] == 0) {
-                continue;
-            }
-            samples++;
-            for (int c = 0; c < 3; c++) {
-                sums[c] += data[(ly * width + lx) * 4 + c];
-            }
+    uint sums[3] {};
+#if defined(IMAGEDATA_SSE2)
+    const __m128i alphaMask = _mm_set1_epi32(0xFF000000);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i v =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 4));
+        __m128i transparent =
+            _mm_cmpeq_epi32(_mm_and_si128(v, alphaMask), zero);
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(transparent));
+        samples += 4 - ((mask & 1) + (mask >> 1 & 1) + (mask >> 2 & 1) +
+                        (mask >> 3 & 1));
+        v = _mm_andnot_si128(transparent, v);
+        // widening RGBA bytes to 32 bit lanes
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i pairs = _mm_add_epi16(lo, hi);
+        acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(pairs, zero));
+        acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(pairs, zero));
+    }
+    alignas(16) uint lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    for (int c = 0; c < 3; c++) {
+        sums[c] = lanes[c];
+    }
+#endif
+    for (; i < pixels; i++) {
+        const ubyte* pixel = data + i * 4;
+        if (pixel[3] == 0) {
+            continue;
+        }
+        samples++;
+        for (int c = 0; c < 3; c++) {
+            sums[c] += pixel[c];
         }
     }
     if (samples == 0) {
         return;
     }
-    for (int i = 0; i < 3; i++) {
-        sums[i] /= samples;
+    ubyte color[3];
+    for (int c = 0; c < 3; c++) {
+        color[c] = sums[c] / samples;
     }
-    for (uint ly = 0; ly < height; ly++) {
-        for (uint lx = 0; lx < width; lx++) {
-            if (data[(ly * width + lx) * 4 + 3] != 0) {
-                continue;
-            }
-            for (int i = 0; i < 3; i++) {
-                data[(ly * width + lx) * 4 + i] = sums[i];
-            }
+    i = 0;
+#if defined(IMAGEDATA_SSE2)
+    const __m128i fill =
+        _mm_set1_epi32(color[0] | color[1] << 8 | color[2] << 16);
+    for (; i + 4 <= pixels; i += 4) {
+        auto ptr = reinterpret_cast<__m128i*>(data + i * 4);
+        __m128i v = _mm_loadu_si128(ptr);
+        __m128i transparent =
+            _mm_cmpeq_epi32(_mm_and_si128(v, alphaMask), zero);
+        _mm_storeu_si128(
+            ptr,
+            _mm_or_si128(
+                _mm_andnot_si128(transparent, v),
+                _mm_and_si128(transparent, fill)
+            )
+        );
+    }
+#endif
+    for (; i < pixels; i++) {
+        ubyte* pixel = data + i * 4;
+        if (pixel[3] != 0) {
+            continue;
+        }
+        for (int c = 0; c < 3; c++) {
+            pixel[c] = color[c];
         }
     }
 }
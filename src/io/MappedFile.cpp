@@ -0,0 +1,99 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+
+using namespace io;
+
+#ifdef _WIN32
+#include <Windows.h>
+
+MappedFile::~MappedFile() {
+    if (bytes) {
+        UnmapViewOfFile(bytes);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+}
+
+std::unique_ptr<MappedFile> MappedFile::open(
+    const std::filesystem::path& file
+) {
+    HANDLE handle = CreateFileW(
+        file.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL,
+        nullptr
+    );
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("could not open file " + file.u8string());
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size)) {
+        CloseHandle(handle);
+        throw std::runtime_error("could not get size of " + file.u8string());
+    }
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+    mapped->length = static_cast<size_t>(size.QuadPart);
+    if (mapped->length == 0) {
+        CloseHandle(handle);
+        return mapped;
+    }
+    mapped->mapping =
+        CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(handle);
+    if (mapped->mapping == nullptr) {
+        throw std::runtime_error("could not map file " + file.u8string());
+    }
+    mapped->bytes = static_cast<const ubyte*>(
+        MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0)
+    );
+    if (mapped->bytes == nullptr) {
+        throw std::runtime_error("could not map file " + file.u8string());
+    }
+    return mapped;
+}
+
+#else // _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::~MappedFile() {
+    if (bytes) {
+        munmap(const_cast<ubyte*>(bytes), length);
+    }
+}
+
+std::unique_ptr<MappedFile> MappedFile::open(
+    const std::filesystem::path& file
+) {
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw std::runtime_error("could not open file " + file.u8string());
+    }
+    struct stat st {};
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        throw std::runtime_error("could not get size of " + file.u8string());
+    }
+    std::unique_ptr<MappedFile> mapped(new MappedFile());
+    mapped->length = static_cast<size_t>(st.st_size);
+    if (mapped->length == 0) {
+        close(fd);
+        return mapped;
+    }
+    void* ptr = mmap(nullptr, mapped->length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (ptr == MAP_FAILED) {
+        throw std::runtime_error("could not map file " + file.u8string());
+    }
+    mapped->bytes = static_cast<const ubyte*>(ptr);
+    return mapped;
+}
+
+#endif // _WIN32
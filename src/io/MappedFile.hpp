@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+
+#include "typedefs.hpp"
+
+namespace io {
+    /// @brief Read-only memory-mapped file
+    class MappedFile {
+        const ubyte* bytes = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        void* mapping = nullptr;
+#endif
+        MappedFile() = default;
+    public:
+        MappedFile(const MappedFile&) = delete;
+        ~MappedFile();
+
+        const ubyte* data() const {
+            return bytes;
+        }
+
+        size_t size() const {
+            return length;
+        }
+
+        /// @brief Map whole file to memory
+        /// @throws std::runtime_error if the file could not be mapped
+        static std::unique_ptr<MappedFile> open(
+            const std::filesystem::path& file
+        );
+    };
+}
@@ -1,8 +1,11 @@
 #include "ZipFileDevice.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "debug/Logger.hpp"
+#include "io/MappedFile.hpp"
 #include "io/memory_istream.hpp"
 #include "io/memory_ostream.hpp"
 #include "io/deflate_istream.hpp"
@@ -20,6 +23,8 @@ static constexpr uint32_t CENTRAL_DIR_SIGNATURE = 0x02014b50;
 static constexpr uint32_t LOCAL_FILE_SIGNATURE = 0x04034b50;
 static constexpr uint32_t COMPRESSION_NONE = 0;
 static constexpr uint32_t COMPRESSION_DEFLATE = 8;
+static constexpr size_t EOCD_SIZE = 22;
+static constexpr size_t MAX_COMMENT_LENGTH = 0xFFFF;
 
 namespace {
     template<typename T>
@@ -67,6 +72,25 @@ namespace {
         uint16_t time = (tm.tm_hour << 11) | (tm.tm_min << 5) | (tm.tm_sec / 2);
         return (date << 16) | time;
     }
+
+    void inflate_entry(
+        const ubyte* src, size_t srcSize, char* dst, size_t dstSize
+    ) {
+        z_stream zstream {};
+        if (inflateInit2(&zstream, -MAX_WBITS) != Z_OK) {
+            throw std::runtime_error("zlib init failed");
+        }
+        zstream.next_in = src;
+        zstream.avail_in = static_cast<uInt>(srcSize);
+        zstream.next_out = reinterpret_cast<Bytef*>(dst);
+        zstream.avail_out = static_cast<uInt>(dstSize);
+        int ret = inflate(&zstream, Z_FINISH);
+        size_t inflated = zstream.total_out;
+        inflateEnd(&zstream);
+        if (ret != Z_STREAM_END || inflated != dstSize) {
+            throw std::runtime_error("corrupted zip entry");
+        }
+    }
 }
 
 ZipFileDevice::Entry ZipFileDevice::readEntry() {
@@ -132,27 +156,103 @@ void ZipFileDevice::findBlob(Entry& entry) {
     entry.blobOffset = file->tellg();
 }
 
+util::Buffer<char> ZipFileDevice::readCompressed(const Entry& entry) {
+    util::Buffer<char> buffer(entry.compressedSize);
+    std::lock_guard lock(fileMutex);
+    file->seekg(entry.blobOffset);
+    file->read(buffer.data(), buffer.size());
+    if (static_cast<size_t>(file->gcount()) != buffer.size()) {
+        file->clear();
+        throw std::runtime_error("unexpected end of zip file");
+    }
+    return buffer;
+}
+
+ZipFileDevice::InflatedData ZipFileDevice::inflateCached(const Entry& entry) {
+    {
+        std::lock_guard lock(cacheMutex);
+        const auto& found = cache.find(entry.fileName);
+        if (found != cache.end()) {
+            lru.splice(lru.begin(), lru, found->second.lruPosition);
+            cacheHits++;
+            return found->second.data;
+        }
+    }
+    // inflating without lock, so other entries may be read meanwhile
+    util::Buffer<char> compressed =
+        mapped ? util::Buffer<char>() : readCompressed(entry);
+    const ubyte* src = mapped
+        ? mapped->data() + entry.blobOffset
+        : reinterpret_cast<const ubyte*>(compressed.data());
+    auto data = std::make_shared<util::Buffer<char>>(entry.uncompressedSize);
+    inflate_entry(src, entry.compressedSize, data->data(), data->size());
+
+    std::lock_guard lock(cacheMutex);
+    if (cache.find(entry.fileName) != cache.end()) {
+        // inflated by another thread
+        return data;
+    }
+    lru.push_front(entry.fileName);
+    cache[entry.fileName] = CacheEntry {data, lru.begin()};
+    cacheSize += data->size();
+    while (cacheSize > CACHE_CAPACITY) {
+        const auto& found = cache.find(lru.back());
+        cacheSize -= found->second.data->size();
+        cache.erase(found);
+        lru.pop_back();
+    }
+    return data;
+}
+
+size_t ZipFileDevice::getCacheHits() const {
+    std::lock_guard lock(cacheMutex);
+    return cacheHits;
+}
+
 ZipFileDevice::ZipFileDevice(
     std::unique_ptr<std::istream> filePtr, FileSeparateFunc separateFunc
 )
     : file(std::move(filePtr)), separateFunc(std::move(separateFunc)) {
-    // Searching for EOCD
-    file->seekg(0, std::ios::end);
-    std::streampos file_size = file->tellg();
+    readCentralDirectory();
+}
 
-    bool foundEOCD = false;
-    for (int pos = static_cast<int>(file_size)-4; pos >= 0; --pos) {
-        file->seekg(pos);
-        if (read_int<uint32_t>(file) == EOCD_SIGNATURE) {
-            foundEOCD = true;
+ZipFileDevice::ZipFileDevice(std::shared_ptr<const MappedFile> mappedPtr)
+    : mapped(std::move(mappedPtr)) {
+    // used for the central directory reading only
+    file = std::make_unique<memory_view_istream>(
+        reinterpret_cast<const char*>(mapped->data()), mapped->size(), nullptr
+    );
+    readCentralDirectory();
+}
+
+ZipFileDevice::~ZipFileDevice() = default;
+
+void ZipFileDevice::readCentralDirectory() {
+    // Searching for EOCD in the file tail (EOCD + max comment length)
+    file->seekg(0, std::ios::end);
+    size_t file_size = static_cast<size_t>(file->tellg());
+    size_t tail_size = std::min(file_size, EOCD_SIZE + MAX_COMMENT_LENGTH);
+    util::Buffer<char> tail(tail_size);
+    file->seekg(file_size - tail_size);
+    file->read(tail.data(), tail_size);
+
+    long long eocd_pos = -1;
+    for (long long pos = static_cast<long long>(tail_size) - EOCD_SIZE;
+         pos >= 0;
+         --pos) {
+        uint32_t signature;
+        std::memcpy(&signature, tail.data() + pos, sizeof(signature));
+        if (dataio::le2h(signature) == EOCD_SIGNATURE) {
+            eocd_pos = file_size - tail_size + pos;
             break;
         }
     }
-    if (!foundEOCD) {
+    if (eocd_pos < 0) {
         throw std::runtime_error("EOCD not found, ZIP file is invalid");
     }
 
     // Reading EOCD
+    file->seekg(eocd_pos + sizeof(uint32_t));
     read_int<uint16_t>(file); // diskNumber
     read_int<uint16_t>(file); // centralDirDisk
     read_int<uint16_t>(file); // numEntriesThisDisk
@@ -173,22 +273,44 @@ ZipFileDevice::ZipFileDevice(
         entries[entry.fileName] = std::move(entry);
     }
 
-    for (auto& [name, _] : entries) {
-        io::path path = name;
+    for (auto& [_, entry] : entries) {
+        if (!entry.isDirectory) {
+            findBlob(entry);
+        }
+    }
 
+    // Adding parent directories missing in the archive
+    std::vector<std::string> names;
+    names.reserve(entries.size());
+    for (const auto& [name, _] : entries) {
+        names.push_back(name);
+    }
+    for (const auto& name : names) {
+        io::path path = name;
         while (!(path = path.parent()).pathPart().empty()) {
             if (entries.find(path.pathPart()) != entries.end()) {
                 continue;
             }
             Entry entry {};
+            entry.fileName = path.pathPart();
             entry.isDirectory = true;
             entries[path.pathPart()] = entry;
         }
-        break;
     }
 
-    for (auto& [_, entry] : entries) {
-        findBlob(entry);
+    // Building directories index
+    for (const auto& [name, _] : entries) {
+        if (name.empty()) {
+            continue;
+        }
+        size_t separator = name.rfind('/');
+        if (separator == std::string::npos) {
+            directories[""].push_back(name);
+        } else {
+            directories[name.substr(0, separator)].push_back(
+                name.substr(separator + 1)
+            );
+        }
     }
 }
 
@@ -205,35 +327,47 @@ std::unique_ptr<std::istream> ZipFileDevice::read(std::string_view path) {
     if (found == entries.end()) {
         throw std::runtime_error("could not to open file zip://" + std::string(path));
     }
-    auto& entry = found->second;
+    const auto& entry = found->second;
     if (entry.isDirectory) {
         throw std::runtime_error("zip://" + std::string(path) + " is directory");
     }
-    if (entry.blobOffset == 0) {
-        findBlob(entry);
+    if (entry.compressionMethod != COMPRESSION_NONE &&
+        entry.compressionMethod != COMPRESSION_DEFLATE) {
+        throw std::runtime_error(
+            "unsupported compression method [" +
+            std::to_string(entry.compressionMethod) + "]"
+        );
+    }
+    if (mapped && entry.blobOffset + entry.compressedSize > mapped->size()) {
+        throw std::runtime_error("zip://" + std::string(path) + " is corrupted");
+    }
+    if (entry.compressionMethod == COMPRESSION_DEFLATE &&
+        entry.uncompressedSize <= CACHED_ENTRY_MAX_SIZE) {
+        // small entries are inflated at once and cached
+        auto data = inflateCached(entry);
+        return std::make_unique<memory_view_istream>(
+            data->data(), data->size(), data
+        );
     }
     std::unique_ptr<std::istream> src_stream;
-    if (separateFunc) {
+    if (mapped) {
+        src_stream = std::make_unique<memory_view_istream>(
+            reinterpret_cast<const char*>(mapped->data() + entry.blobOffset),
+            entry.compressedSize,
+            mapped
+        );
+    } else if (separateFunc) {
         // Create new istream for concurrent data reading
         src_stream = separateFunc();
         src_stream->seekg(entry.blobOffset);
     } else {
         // Read compressed data to memory if istream cannot be separated
-        file->seekg(entry.blobOffset);
-        util::Buffer<char> buffer(entry.compressedSize);
-        file->read(buffer.data(), buffer.size());
-        src_stream = std::make_unique<memory_istream>(std::move(buffer));
+        src_stream = std::make_unique<memory_istream>(readCompressed(entry));
     }
     if (entry.compressionMethod == COMPRESSION_NONE) {
         return src_stream;
-    } else if (entry.compressionMethod == COMPRESSION_DEFLATE) {
-        return std::make_unique<deflate_istream>(std::move(src_stream));
-    } else {
-        throw std::runtime_error(
-            "unsupported compression method [" +
-            std::to_string(entry.compressionMethod) + "]"
-        );
     }
+    return std::make_unique<deflate_istream>(std::move(src_stream));
 }
 
 size_t ZipFileDevice::size(std::string_view path) {
@@ -309,30 +443,11 @@ private:
 };
 
 std::unique_ptr<PathsGenerator> ZipFileDevice::list(std::string_view path) {
-    std::vector<std::string> names;
-    if (path.empty()) {
-        for (const auto& [name, entry] : entries) {
-            if (name.find('/') == std::string::npos) {
-                names.push_back(name);
-            }
-        }
-    } else {
-        auto folder = std::string(path) + "/";
-        size_t folder_len = folder.length();
-        for (const auto& [name, entry] : entries) {
-            if (name.find(folder) != 0) {
-                continue;
-            }
-            size_t pos = name.find('/', folder_len);
-            if (pos == std::string::npos) {
-                names.push_back(name.substr(folder_len, pos - folder_len));
-            }
-            if (pos == name.length() - 1) {
-                names.push_back(name.substr(folder_len, pos - folder_len));
-            }
-        }
+    const auto& found = directories.find(std::string(path));
+    if (found == directories.end()) {
+        return std::make_unique<ListPathsGenerator>(std::vector<std::string>());
     }
-    return std::make_unique<ListPathsGenerator>(std::move(names));
+    return std::make_unique<ListPathsGenerator>(found->second);
 }
 
 #include "io/io.hpp"
@@ -1,11 +1,19 @@
 #pragma once
 
 #include <functional>
+#include <list>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "Device.hpp"
+#include "util/Buffer.hpp"
 
 namespace io {
+    class MappedFile;
+
+    /// @brief Read-only device for ZIP archives. Entries index is built
+    /// once, so the device may be used by multiple threads at once
     class ZipFileDevice : public Device {
         struct Entry {
             uint16_t versionMadeBy;
@@ -28,6 +36,12 @@ namespace io {
     public:
         using FileSeparateFunc = std::function<std::unique_ptr<std::istream>()>;
 
+        /// @brief Max uncompressed size of an entry kept in the inflated
+        /// entries cache
+        static constexpr size_t CACHED_ENTRY_MAX_SIZE = 64 * 1024;
+        /// @brief Total size of the inflated entries cache
+        static constexpr size_t CACHE_CAPACITY = 4 * 1024 * 1024;
+
         /// @param file ZIP file seekable istream
         /// @param separateFunc Optional function that creates new seekable 
         /// istream for the ZIP file.
@@ -36,6 +50,11 @@ namespace io {
             FileSeparateFunc separateFunc = nullptr
         );
 
+        /// @param mapped memory-mapped ZIP file. Entries are read directly
+        /// from the mapping, streams returned by read() keep it alive
+        explicit ZipFileDevice(std::shared_ptr<const MappedFile> mapped);
+        ~ZipFileDevice();
+
         std::filesystem::path resolve(std::string_view path) override;
         std::unique_ptr<std::ostream> write(std::string_view path) override;
         std::unique_ptr<std::istream> read(std::string_view path) override;
@@ -49,13 +68,36 @@ namespace io {
         bool remove(std::string_view path) override;
         uint64_t removeAll(std::string_view path) override;
         std::unique_ptr<PathsGenerator> list(std::string_view path) override;
+
+        /// @return number of inflated entries cache hits
+        size_t getCacheHits() const;
     private:
+        using InflatedData = std::shared_ptr<const util::Buffer<char>>;
+        struct CacheEntry {
+            InflatedData data;
+            std::list<std::string>::iterator lruPosition;
+        };
+
+        std::shared_ptr<const MappedFile> mapped;
         std::unique_ptr<std::istream> file;
+        std::mutex fileMutex;
         FileSeparateFunc separateFunc;
         std::unordered_map<std::string, Entry> entries;
+        /// @brief Directory path -> names of direct children
+        std::unordered_map<std::string, std::vector<std::string>> directories;
+
+        mutable std::mutex cacheMutex;
+        /// @brief Least recently used entry names at the back
+        std::list<std::string> lru;
+        std::unordered_map<std::string, CacheEntry> cache;
+        size_t cacheSize = 0;
+        size_t cacheHits = 0;
 
+        void readCentralDirectory();
         Entry readEntry();
         void findBlob(Entry& entry);
+        util::Buffer<char> readCompressed(const Entry& entry);
+        InflatedData inflateCached(const Entry& entry);
     };
 
     void write_zip(const path& folder, const path& file);
@@ -10,6 +10,7 @@
 
 #include "io/devices/StdfsDevice.hpp"
 #include "io/devices/ZipFileDevice.hpp"
+#include "io/MappedFile.hpp"
 #include "world/files/WorldFiles.hpp"
 #include "debug/Logger.hpp"
 
@@ -159,10 +160,22 @@ void EnginePaths::setCurrentWorldFolder(io::path folder) {
 
 std::string EnginePaths::mount(const io::path& file) {
     if (file.extension() == ".zip") {
-        auto stream = io::read(file);
-        auto device = std::make_unique<io::ZipFileDevice>(
-            std::move(stream), [file]() { return io::read(file); }
-        );
+        std::unique_ptr<io::ZipFileDevice> device;
+        std::shared_ptr<io::MappedFile> mapped;
+        try {
+            mapped = io::MappedFile::open(io::resolve(file));
+        } catch (const std::runtime_error& err) {
+            // file is not on the native filesystem or could not be mapped
+            logger.debug() << "could not map " << file.string() << ": "
+                           << err.what();
+        }
+        if (mapped) {
+            device = std::make_unique<io::ZipFileDevice>(std::move(mapped));
+        } else {
+            device = std::make_unique<io::ZipFileDevice>(
+                io::read(file), [file]() { return io::read(file); }
+            );
+        }
         std::string name;
         do {
             name = std::string("M.") + generate_random_base64<6>();
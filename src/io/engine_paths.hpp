@@ -79,6 +79,8 @@ public:
     static inline io::path CONFIG_DEFAULTS = "config/defaults.toml";
     static inline io::path CONTROLS_FILE = "user:controls.toml";
     static inline io::path SETTINGS_FILE = "user:settings.toml";
+    static inline io::path CONTENT_CACHE_FILE = "user:cache/content-defs.bjson";
+    static inline io::path ATLASES_CACHE_FOLDER = "user:cache/atlases";
 private:
     std::filesystem::path userFilesFolder {"."};
     std::filesystem::path resourcesFolder {"res"};
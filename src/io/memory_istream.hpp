@@ -1,25 +1,61 @@
 #pragma once
 
 #include <istream>
+#include <memory>
 #include "util/Buffer.hpp"
 
-class memory_streambuf : public std::streambuf {
+/// @brief Seekable read-only streambuf over memory that is not owned
+class memory_view_streambuf : public std::streambuf {
 public:
-    explicit memory_streambuf(util::Buffer<char> buffer)
-        : buffer(std::move(buffer)) {
-        char* base = this->buffer.data();
-        char* end = base + this->buffer.size();
-        setg(base, base, end);
+    memory_view_streambuf(const char* data, size_t size) {
+        setview(data, size);
     }
-    
-    memory_streambuf(const memory_streambuf&) = delete;
-    memory_streambuf& operator=(const memory_streambuf&) = delete;
+
+    memory_view_streambuf(const memory_view_streambuf&) = delete;
+    memory_view_streambuf& operator=(const memory_view_streambuf&) = delete;
 
 protected:
+    void setview(const char* data, size_t size) {
+        char* base = const_cast<char*>(data);
+        setg(base, base, base + size);
+    }
+
     int_type underflow() override {
         return traits_type::eof();
     }
 
+    pos_type seekoff(
+        off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which
+    ) override {
+        if (!(which & std::ios_base::in)) {
+            return pos_type(off_type(-1));
+        }
+        off_type base = 0;
+        if (dir == std::ios_base::cur) {
+            base = gptr() - eback();
+        } else if (dir == std::ios_base::end) {
+            base = egptr() - eback();
+        }
+        off_type pos = base + off;
+        if (pos < 0 || pos > egptr() - eback()) {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + pos, egptr());
+        return pos_type(pos);
+    }
+
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
+class memory_streambuf : public memory_view_streambuf {
+public:
+    explicit memory_streambuf(util::Buffer<char> buffer)
+        : memory_view_streambuf(nullptr, 0), buffer(std::move(buffer)) {
+        setview(this->buffer.data(), this->buffer.size());
+    }
+
 private:
     util::Buffer<char> buffer;
 };
@@ -32,3 +68,17 @@ public:
 private:
     memory_streambuf buf;
 };
+
+/// @brief Read-only stream over memory owned by another object
+class memory_view_istream : public std::istream {
+public:
+    /// @param owner object keeping the memory alive while the stream exists
+    memory_view_istream(
+        const char* data, size_t size, std::shared_ptr<const void> owner
+    )
+        : std::istream(&buf), buf(data, size), owner(std::move(owner)) {}
+
+private:
+    memory_view_streambuf buf;
+    std::shared_ptr<const void> owner;
+};
@@ -27,7 +27,9 @@ ChunksController::ChunksController(Level& level)
           level.content.generators.require(level.getWorld()->getGenerator()),
           level.content,
           level.getWorld()->getSeed()
-      )) {}
+      )) {
+    generator->setPrototypesStorage(&level.getWorld()->wfile->getRegions());
+}
 
 ChunksController::~ChunksController() = default;
 
@@ -0,0 +1,134 @@
+#include "ChunksStreaming.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "content/Content.hpp"
+#include "debug/Logger.hpp"
+#include "lighting/Lighting.hpp"
+#include "network/ChunksStream.hpp"
+#include "network/Network.hpp"
+#include "util/data_io.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/GlobalChunks.hpp"
+#include "world/Level.hpp"
+
+static debug::Logger logger("chunks-streaming");
+
+ChunksStreaming::ChunksStreaming(
+    Level& level, network::Network& network, Lighting* lighting
+)
+    : level(level), network(network), lighting(lighting) {
+}
+
+ChunksStreaming::~ChunksStreaming() = default;
+
+bool ChunksStreaming::subscribe(u64id_t connection, int x, int z) {
+    auto chunk = level.chunks->fetch(x, z);
+    if (chunk == nullptr) {
+        return false;
+    }
+    if (server == nullptr) {
+        server = std::make_unique<network::ChunksStreamServer>(network);
+    }
+    server->subscribe(connection, chunk);
+    subscribers.insert(connection);
+    return true;
+}
+
+void ChunksStreaming::unsubscribe(u64id_t connection, int x, int z) {
+    if (server) {
+        server->unsubscribe(connection, x, z);
+    }
+}
+
+void ChunksStreaming::receive(u64id_t connection) {
+    if (clients.find(connection) != clients.end()) {
+        return;
+    }
+    clients[connection] = std::make_unique<network::ChunksStreamClient>(
+        network, connection, [this](network::StreamedChunk& streamed) {
+            apply(streamed);
+        }
+    );
+}
+
+void ChunksStreaming::apply(network::StreamedChunk& streamed) {
+    auto chunk = level.chunks->getChunk(streamed.x, streamed.z);
+    if (chunk == nullptr) {
+        return;
+    }
+    const auto& indices = *level.content.getIndices();
+    auto ids = reinterpret_cast<const uint16_t*>(streamed.voxelData);
+    for (size_t i = 0; i < CHUNK_VOL; i++) {
+        blockid_t id = dataio::le2h(ids[i]);
+        if (indices.blocks.get(id) == nullptr) {
+            logger.error() << "invalid block id " << id << " in chunk "
+                           << streamed.x << ", " << streamed.z;
+            return;
+        }
+    }
+    chunk->decode(streamed.voxelData);
+    chunk->updateHeights();
+    chunk->blocksMetadata = std::move(streamed.metadata);
+    // not a local edit: the revision is kept, so the chunk is not streamed
+    // back to the peer it came from
+    chunk->flags.modified = true;
+    chunk->flags.unsaved = true;
+
+    if (lighting == nullptr) {
+        return;
+    }
+    chunk->flags.loadedLights = false;
+    chunk->flags.lighted = false;
+    chunk->lightmap.clear();
+    Lighting::prebuildSkyLight(*chunk, indices);
+    for (int lz = -1; lz <= 1; lz++) {
+        for (int lx = -1; lx <= 1; lx++) {
+            if (std::abs(lx) + std::abs(lz) != 1) {
+                continue;
+            }
+            if (auto other = level.chunks->getChunk(
+                    streamed.x + lx, streamed.z + lz
+                )) {
+                other->flags.modified = true;
+            }
+        }
+    }
+}
+
+static bool is_closed(network::Network& network, u64id_t id) {
+    auto connection = network.getConnection(id);
+    return connection == nullptr ||
+           connection->getState() == network::ConnectionState::CLOSED;
+}
+
+void ChunksStreaming::update() {
+    if (server) {
+        for (auto it = subscribers.begin(); it != subscribers.end();) {
+            if (is_closed(network, *it)) {
+                server->unsubscribeAll(*it);
+                it = subscribers.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        server->update();
+    }
+    for (auto it = clients.begin(); it != clients.end();) {
+        if (is_closed(network, it->first)) {
+            it = clients.erase(it);
+            continue;
+        }
+        try {
+            it->second->update();
+            ++it;
+        } catch (const std::runtime_error& err) {
+            logger.error() << "chunks stream error: " << err.what();
+            if (auto connection = network.getConnection(it->first)) {
+                connection->close(true);
+            }
+            it = clients.erase(it);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "typedefs.hpp"
+
+class Level;
+class Lighting;
+
+namespace network {
+    class Network;
+    class ChunksStreamServer;
+    class ChunksStreamClient;
+    struct StreamedChunk;
+}
+
+/// @brief Streams level chunks over connections using
+/// network::ChunksStreamServer and applies chunks received with
+/// network::ChunksStreamClient to loaded level chunks
+class ChunksStreaming {
+    Level& level;
+    network::Network& network;
+    Lighting* lighting;
+    std::unique_ptr<network::ChunksStreamServer> server;
+    /// @brief Connections with subscribed chunks
+    std::unordered_set<u64id_t> subscribers;
+    /// @brief Connection id -> client receiving chunks from it
+    std::unordered_map<u64id_t, std::unique_ptr<network::ChunksStreamClient>>
+        clients;
+
+    void apply(network::StreamedChunk& streamed);
+public:
+    ChunksStreaming(Level& level, network::Network& network, Lighting* lighting);
+    ~ChunksStreaming();
+
+    /// @brief Start sending the loaded chunk to the connection.
+    /// Chunk is sent again on every modification until unsubscribed
+    /// or unloaded
+    /// @return false if chunk is not loaded
+    bool subscribe(u64id_t connection, int x, int z);
+
+    void unsubscribe(u64id_t connection, int x, int z);
+
+    /// @brief Apply chunks received from the connection to loaded chunks.
+    /// Chunks that are not loaded are ignored. The connection should not
+    /// be used for other messages
+    void receive(u64id_t connection);
+
+    /// @brief Should be called before Network::update.
+    /// Connections sending malformed messages are closed
+    void update();
+};
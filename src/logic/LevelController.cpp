@@ -43,6 +43,9 @@ LevelController::LevelController(
     blocks = std::make_unique<BlocksController>(
         *level, chunks ? chunks->lighting.get() : nullptr
     );
+    streaming = std::make_unique<ChunksStreaming>(
+        *level, engine->getNetwork(), chunks->lighting.get()
+    );
     scripting::on_world_load(this);
 
     // TODO: do something to players added later
@@ -69,6 +72,7 @@ LevelController::LevelController(
 }
 
 void LevelController::update(float delta, bool pause) {
+    updatePregeneration();
     for (const auto& [_, player] : *level->players) {
         if (player->isSuspended()) {
             continue;
@@ -116,6 +120,7 @@ void LevelController::update(float delta, bool pause) {
         }
     }
     level->entities->clean();
+    streaming->update();
 }
 
 void LevelController::saveWorld() {
@@ -131,6 +136,35 @@ void LevelController::saveWorld() {
     level->getWorld()->write(level.get());
 }
 
+void LevelController::pregenerate(
+    const glm::ivec2& start, const glm::ivec2& size, int64_t timeBudget
+) {
+    pregenerator = std::make_unique<WorldPregenerator>(
+        *level, start, size, timeBudget
+    );
+}
+
+bool LevelController::updatePregeneration() {
+    if (pregenerator == nullptr) {
+        return false;
+    }
+    try {
+        pregenerator->update();
+    } catch (const std::exception& err) {
+        logger.error() << "pre-generation failed: " << err.what();
+        pregenerator = nullptr;
+        return false;
+    }
+    if (!pregenerator->isActive()) {
+        pregenerator = nullptr;
+    }
+    return true;
+}
+
+WorldPregenerator* LevelController::getPregenerator() {
+    return pregenerator.get();
+}
+
 void LevelController::onWorldQuit() {
     scripting::on_world_quit();
 }
@@ -146,3 +180,7 @@ BlocksController* LevelController::getBlocksController() {
 ChunksController* LevelController::getChunksController() {
     return chunks.get();
 }
+
+ChunksStreaming* LevelController::getChunksStreaming() {
+    return streaming.get();
+}
@@ -4,6 +4,8 @@
 
 #include "BlocksController.hpp"
 #include "ChunksController.hpp"
+#include "ChunksStreaming.hpp"
+#include "WorldPregenerator.hpp"
 #include "util/Clock.hpp"
 
 class Engine;
@@ -18,6 +20,8 @@ class LevelController {
     // Sub-controllers
     std::unique_ptr<BlocksController> blocks;
     std::unique_ptr<ChunksController> chunks;
+    std::unique_ptr<WorldPregenerator> pregenerator;
+    std::unique_ptr<ChunksStreaming> streaming;
 
     util::Clock playerTickClock;
 public:
@@ -29,10 +33,30 @@ public:
 
     void saveWorld();
 
+    /// @brief Start (or resume) pre-generation of the area. Replaces
+    /// current pre-generation if active
+    /// @param start first chunk of the area
+    /// @param size area size in chunks
+    /// @param timeBudget time (microseconds) spent by updatePregeneration
+    /// call, 0 - process a whole tile per call
+    void pregenerate(
+        const glm::ivec2& start,
+        const glm::ivec2& size,
+        int64_t timeBudget = WorldPregenerator::FRAME_TIME_BUDGET
+    );
+
+    /// @brief Continue active pre-generation within its time budget
+    /// @return false if there is no active pre-generation
+    bool updatePregeneration();
+
+    /// @return active pre-generation or nullptr
+    WorldPregenerator* getPregenerator();
+
     void onWorldQuit();
 
     Level* getLevel();
 
     BlocksController* getBlocksController();
     ChunksController* getChunksController();
+    ChunksStreaming* getChunksStreaming();
 };
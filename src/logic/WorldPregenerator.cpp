@@ -0,0 +1,457 @@
+#include "WorldPregenerator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "content/Content.hpp"
+#include "debug/Logger.hpp"
+#include "io/io.hpp"
+#include "lighting/Lighting.hpp"
+#include "maths/voxmaths.hpp"
+#include "util/ThreadPool.hpp"
+#include "util/timeutil.hpp"
+#include "voxels/Chunk.hpp"
+#include "voxels/Chunks.hpp"
+#include "voxels/GlobalChunks.hpp"
+#include "world/files/WorldFiles.hpp"
+#include "world/generator/WorldGenerator.hpp"
+#include "world/Level.hpp"
+#include "world/World.hpp"
+
+static debug::Logger logger("pregenerator");
+
+inline const std::string CHECKPOINT_FILE = "pregen.json";
+
+struct PregenJob {
+    std::shared_ptr<Chunk> chunk;
+    /// @brief Chunk is not loaded from regions and must be generated
+    bool generate;
+};
+
+struct PregenResult {
+    std::shared_ptr<Chunk> chunk;
+    bool generated;
+    std::exception_ptr error;
+};
+
+class PregenWorker : public util::Worker<PregenJob, PregenResult> {
+    const WorldGenerator& generator;
+    const ContentIndices& indices;
+public:
+    PregenWorker(const WorldGenerator& generator, const ContentIndices& indices)
+        : generator(generator), indices(indices) {
+    }
+
+    PregenResult operator()(const PregenJob& job) override {
+        auto& chunk = *job.chunk;
+        try {
+            if (job.generate) {
+                generator.generateVoxels(chunk.voxels, chunk.x, chunk.z);
+            }
+            chunk.updateHeights();
+            if (!chunk.flags.loadedLights) {
+                Lighting::prebuildSkyLight(chunk, indices);
+            }
+        } catch (const std::exception&) {
+            return PregenResult {job.chunk, job.generate, std::current_exception()};
+        }
+        return PregenResult {job.chunk, job.generate, nullptr};
+    }
+};
+
+enum class TileStage {
+    /// @brief Prototypes generation by script workers, a batch row enqueued
+    /// per step, then waiting for the workers
+    AHEAD,
+    /// @brief Chunks loading and prototypes completion, a chunk per step
+    PREPARE,
+    /// @brief Waiting for voxels generation in the thread pool
+    GENERATE,
+    /// @brief Lighting, a chunk per step
+    LIGHT,
+    /// @brief Writing regions and the checkpoint
+    SAVE
+};
+
+struct WorldPregenerator::TileState {
+    /// @brief First chunk of the tile
+    glm::ivec2 pos;
+    /// @brief Tile size in chunks
+    glm::ivec2 size;
+    TileStage stage = TileStage::AHEAD;
+    /// @brief Detached storage of the tile chunks with 1 chunk padding
+    /// required for lighting
+    Chunks chunks;
+    /// @brief Next row of chunks generated ahead
+    int aheadZ;
+    /// @brief Index of the next chunk of the current stage
+    int index = 0;
+    std::vector<PregenJob> jobs;
+    size_t remaining = 0;
+    std::exception_ptr error;
+    std::unique_ptr<Lighting> lighting;
+    timeutil::Timer timer;
+    std::unique_ptr<util::ThreadPool<PregenJob, PregenResult>> threadPool;
+
+    TileState(
+        const glm::ivec2& pos,
+        const glm::ivec2& size,
+        const ContentIndices& indices
+    )
+        : pos(pos),
+          size(size),
+          chunks(size.x + 2, size.y + 2, 0, 0, nullptr, indices),
+          aheadZ(pos.y - 3) {
+        chunks.setCenter(
+            (pos.x - 1 + (size.x + 2) / 2) * CHUNK_W,
+            (pos.y - 1 + (size.y + 2) / 2) * CHUNK_D
+        );
+    }
+
+    /// @brief Padded area width in chunks
+    int areaWidth() const {
+        return size.x + 2;
+    }
+
+    /// @brief Padded area chunks count
+    int areaVolume() const {
+        return (size.x + 2) * (size.y + 2);
+    }
+};
+
+WorldPregenerator::WorldPregenerator(
+    Level& level,
+    const glm::ivec2& start,
+    const glm::ivec2& size,
+    int64_t timeBudget,
+    int maxWorkers
+)
+    : level(level),
+      start(start),
+      size(size),
+      tiles((size + TILE_SIZE - 1) / TILE_SIZE),
+      maxWorkers(maxWorkers),
+      timeBudget(timeBudget) {
+    if (size.x <= 0 || size.y <= 0) {
+        throw std::runtime_error("pre-generated area size must be positive");
+    }
+    auto world = level.getWorld();
+    if (world->isNameless()) {
+        throw std::runtime_error("nameless world can not be pre-generated");
+    }
+    generator = std::make_unique<WorldGenerator>(
+        level.content.generators.require(world->getGenerator()),
+        level.content,
+        world->getSeed()
+    );
+    generator->setPrototypesStorage(&world->wfile->getRegions());
+
+    uint scriptWorkers = std::max(1U, std::thread::hardware_concurrency());
+    if (maxWorkers > 0) {
+        scriptWorkers = std::min(scriptWorkers, static_cast<uint>(maxWorkers));
+    }
+    if (!generator->createWorkers(scriptWorkers)) {
+        logger.info() << "generator script does not support workers";
+    }
+    world->wfile->createDirectories();
+    readCheckpoint();
+
+    logger.info() << "pre-generating " << size.x << "x" << size.y
+                  << " chunks at " << start.x << " " << start.y << " ("
+                  << (tiles.x * tiles.y - tile) << " tile(s) left)";
+}
+
+WorldPregenerator::~WorldPregenerator() = default;
+
+void WorldPregenerator::readCheckpoint() {
+    auto file = level.getWorld()->wfile->getFolder() / CHECKPOINT_FILE;
+    if (!io::exists(file)) {
+        return;
+    }
+    try {
+        auto root = io::read_json(file);
+        if (root["x"].asInteger() != start.x ||
+            root["z"].asInteger() != start.y ||
+            root["width"].asInteger() != size.x ||
+            root["depth"].asInteger() != size.y) {
+            logger.info() << "checkpoint of another area is ignored";
+            return;
+        }
+        tile = std::min(
+            static_cast<uint>(root["tile"].asInteger()),
+            static_cast<uint>(tiles.x * tiles.y)
+        );
+        logger.info() << "resuming from tile " << tile;
+    } catch (const std::runtime_error& err) {
+        logger.warning() << "could not read checkpoint: " << err.what();
+    }
+}
+
+void WorldPregenerator::writeCheckpoint() const {
+    auto world = level.getWorld();
+    // regions must be written before the checkpoint
+    world->wfile->getRegions().writeAll();
+
+    auto root = dv::object();
+    root["x"] = start.x;
+    root["z"] = start.y;
+    root["width"] = size.x;
+    root["depth"] = size.y;
+    root["tile"] = tile;
+    io::write_json(world->wfile->getFolder() / CHECKPOINT_FILE, root);
+}
+
+std::shared_ptr<Chunk> WorldPregenerator::acquireChunk(int x, int z) {
+    if (auto live = level.chunks->fetch(x, z)) {
+        if (live->flags.ready) {
+            // the level owns the chunk, a copy is used for lighting only
+            std::shared_ptr<Chunk> chunk = live->clone();
+            chunk->flags = live->flags;
+            chunk->flags.unsaved = false;
+            chunk->updateHeights();
+            return chunk;
+        }
+    }
+    auto chunk = std::make_shared<Chunk>(x, z);
+    auto& regions = level.getWorld()->wfile->getRegions();
+    if (auto data = regions.getVoxels(x, z)) {
+        chunk->decode(data.get());
+        chunk->flags.loaded = true;
+        if (auto lights = regions.getLights(x, z)) {
+            chunk->lightmap.set(lights.get());
+            chunk->flags.loadedLights = true;
+        }
+    }
+    return chunk;
+}
+
+void WorldPregenerator::startTile() {
+    int tileX = tile % tiles.x * TILE_SIZE;
+    int tileZ = tile / tiles.x * TILE_SIZE;
+    glm::ivec2 tileSize(
+        std::min(TILE_SIZE, size.x - tileX), std::min(TILE_SIZE, size.y - tileZ)
+    );
+    glm::ivec2 pos = start + glm::ivec2(tileX, tileZ);
+    current = std::make_unique<TileState>(
+        pos, tileSize, *level.content.getIndices()
+    );
+    generator->update(
+        pos.x + tileSize.x / 2,
+        pos.y + tileSize.y / 2,
+        std::max(tileSize.x, tileSize.y) / 2 + 1
+    );
+}
+
+bool WorldPregenerator::step() {
+    auto& state = *current;
+    switch (state.stage) {
+        case TileStage::AHEAD: {
+            // prototypes of chunks within 2 chunks from the completed ones
+            // get heightmaps and placements, so are generated by script
+            // workers; a row of batches is enqueued at once
+            int lastZ = state.pos.y + state.size.y + 2;
+            if (state.aheadZ > lastZ) {
+                if (!generator->updateAhead()) {
+                    return false;
+                }
+                state.stage = TileStage::PREPARE;
+                return true;
+            }
+            int batchSize = generator->getBatchSize();
+            int endZ = std::min(
+                (floordiv(state.aheadZ, batchSize) + 1) * batchSize, lastZ + 1
+            );
+            std::vector<glm::ivec2> aheadChunks;
+            for (int z = state.aheadZ; z < endZ; z++) {
+                for (int x = state.pos.x - 3;
+                     x <= state.pos.x + state.size.x + 2;
+                     x++) {
+                    aheadChunks.emplace_back(x, z);
+                }
+            }
+            generator->startAhead(aheadChunks);
+            generator->updateAhead();
+            state.aheadZ = endZ;
+            return true;
+        }
+        case TileStage::PREPARE: {
+            int x = state.pos.x - 1 + state.index % state.areaWidth();
+            int z = state.pos.y - 1 + state.index / state.areaWidth();
+            auto chunk = acquireChunk(x, z);
+            state.chunks.putChunk(chunk);
+            if (!chunk->flags.ready) {
+                bool generate = !chunk->flags.loaded;
+                if (generate) {
+                    generator->prepare(x, z);
+                }
+                state.jobs.push_back(PregenJob {std::move(chunk), generate});
+            }
+            if (++state.index < state.areaVolume()) {
+                return true;
+            }
+            state.index = 0;
+            state.stage = TileStage::GENERATE;
+            state.remaining = state.jobs.size();
+            state.threadPool =
+                std::make_unique<util::ThreadPool<PregenJob, PregenResult>>(
+                    "pregen-worker",
+                    [this]() {
+                        return std::make_shared<PregenWorker>(
+                            *generator, *level.content.getIndices()
+                        );
+                    },
+                    [&state](PregenResult& result) {
+                        state.remaining--;
+                        if (result.error) {
+                            if (state.error == nullptr) {
+                                state.error = result.error;
+                            }
+                            return;
+                        }
+                        auto& flags = result.chunk->flags;
+                        if (result.generated) {
+                            flags.unsaved = true;
+                        }
+                        flags.loaded = true;
+                        flags.ready = true;
+                    },
+                    maxWorkers
+                );
+            state.threadPool->setStopOnFail(false);
+            for (auto& job : state.jobs) {
+                state.threadPool->enqueueJob(std::move(job));
+            }
+            state.jobs.clear();
+            return true;
+        }
+        case TileStage::GENERATE:
+            state.threadPool->update();
+            if (state.remaining) {
+                return false;
+            }
+            state.threadPool = nullptr;
+            if (state.error) {
+                auto error = state.error;
+                current = nullptr;
+                std::rethrow_exception(error);
+            }
+            state.lighting =
+                std::make_unique<Lighting>(level.content, state.chunks);
+            state.stage = TileStage::LIGHT;
+            return true;
+        case TileStage::LIGHT: {
+            int x = state.pos.x + state.index % state.size.x;
+            int z = state.pos.y + state.index / state.size.x;
+            auto chunk = state.chunks.getChunk(x, z);
+            if (!chunk->flags.lighted) {
+                bool lightsCache = chunk->flags.loadedLights;
+                if (!lightsCache) {
+                    state.lighting->buildSkyLight(x, z);
+                }
+                state.lighting->onChunkLoaded(x, z, !lightsCache);
+                chunk->flags.lighted = true;
+            }
+            if (++state.index == state.size.x * state.size.y) {
+                state.stage = TileStage::SAVE;
+            }
+            return true;
+        }
+        case TileStage::SAVE:
+            finishTile();
+            return true;
+    }
+    return true;
+}
+
+void WorldPregenerator::finishTile() {
+    auto& state = *current;
+    auto& regions = level.getWorld()->wfile->getRegions();
+    // padding chunks are not lighted so they are generated again as a part
+    // of the neighbour tile; chunks loaded by the level meanwhile are owned
+    // by the level, and chunks saved by the level meanwhile (possibly
+    // edited and unloaded) must not be overwritten
+    for (int z = state.pos.y; z < state.pos.y + state.size.y; z++) {
+        for (int x = state.pos.x; x < state.pos.x + state.size.x; x++) {
+            auto chunk = state.chunks.getChunk(x, z);
+            if (!chunk->flags.unsaved || level.chunks->fetch(x, z) ||
+                regions.getVoxels(x, z) != nullptr) {
+                continue;
+            }
+            regions.put(chunk, {});
+        }
+    }
+    int64_t time = state.timer.stop();
+    current = nullptr;
+    tile++;
+    writeCheckpoint();
+
+    uint tilesCount = tiles.x * tiles.y;
+    uint done = getWorkDone();
+    uint total = getWorkTotal();
+    logger.info() << "tile " << tile << "/" << tilesCount << " done in "
+                  << time / 1000 << " ms, " << done << "/" << total
+                  << " chunks (" << (done * 100ULL / total) << "%)";
+    if (tile == tilesCount) {
+        io::remove(level.getWorld()->wfile->getFolder() / CHECKPOINT_FILE);
+        logger.info() << "pre-generation finished";
+        active = false;
+    }
+}
+
+void WorldPregenerator::update() {
+    if (!active) {
+        return;
+    }
+    timeutil::Timer timer;
+    do {
+        if (current == nullptr) {
+            if (tile >= static_cast<uint>(tiles.x * tiles.y)) {
+                terminate();
+                return;
+            }
+            startTile();
+        }
+        if (!step()) {
+            if (timeBudget > 0) {
+                // continue next frame
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (current == nullptr && timeBudget == 0) {
+            return;
+        }
+    } while (active && (timeBudget == 0 || timer.stop() < timeBudget));
+}
+
+bool WorldPregenerator::isActive() const {
+    return active;
+}
+
+uint WorldPregenerator::getWorkTotal() const {
+    return size.x * size.y;
+}
+
+uint WorldPregenerator::getWorkDone() const {
+    int rows = tile / tiles.x;
+    int depth = std::min(rows * TILE_SIZE, size.y);
+    uint done = depth * size.x;
+    if (int columns = tile % tiles.x) {
+        done += std::min(columns * TILE_SIZE, size.x) *
+                std::min(TILE_SIZE, size.y - depth);
+    }
+    return done;
+}
+
+void WorldPregenerator::waitForEnd() {
+    while (active) {
+        update();
+    }
+}
+
+void WorldPregenerator::terminate() {
+    current = nullptr;
+    active = false;
+}
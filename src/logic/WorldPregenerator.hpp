@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <glm/glm.hpp>
+
+#include "interfaces/Task.hpp"
+#include "typedefs.hpp"
+
+class Chunk;
+class Level;
+class WorldGenerator;
+
+/// @brief Generates, lights and saves a rectangular area of chunks.
+/// Area is processed in tiles of TILE_SIZE x TILE_SIZE chunks.
+/// Prototypes are completed in the main thread, their heightmaps and
+/// placements are generated in advance by generator script workers.
+/// Voxels generation and sky light prebuild are performed by the thread pool.
+/// Chunks are kept in a detached storage: level chunks are never created,
+/// so no level events are triggered and no entities are loaded. Chunks
+/// loaded in the level are used as read-only copies and never saved.
+/// Main thread work is split into small steps, update() performs steps
+/// until the time budget is spent, so it may be called every frame.
+/// Progress is saved to the world folder after every tile, so
+/// pre-generation of the same area may be resumed after interruption
+class WorldPregenerator : public Task {
+    struct TileState;
+
+    Level& level;
+    /// @brief First chunk of the area
+    glm::ivec2 start;
+    /// @brief Area size in chunks
+    glm::ivec2 size;
+    /// @brief Number of tiles on X and Z axes
+    glm::ivec2 tiles;
+    /// @brief Max number of worker threads (see util::ThreadPool)
+    int maxWorkers;
+    /// @brief Main thread time (microseconds) spent by update() call,
+    /// 0 - process a whole tile
+    int64_t timeBudget;
+    /// @brief Index of the next tile
+    uint tile = 0;
+    bool active = true;
+    std::unique_ptr<WorldGenerator> generator;
+    /// @brief State of the tile in progress
+    std::unique_ptr<TileState> current;
+
+    void startTile();
+    /// @brief Perform next step of the current tile
+    /// @return false if waiting for worker threads
+    bool step();
+    void finishTile();
+    std::shared_ptr<Chunk> acquireChunk(int x, int z);
+    void readCheckpoint();
+    void writeCheckpoint() const;
+public:
+    /// @brief Width of the area (in chunks) processed at once
+    static inline constexpr int TILE_SIZE = 16;
+    /// @brief Default time budget of update() used in-game, microseconds
+    static inline constexpr int64_t FRAME_TIME_BUDGET = 4000;
+
+    /// @param level target level (world must be named)
+    /// @param start first chunk of the area
+    /// @param size area size in chunks
+    /// @param timeBudget main thread time (microseconds) spent by update()
+    /// call, 0 - process a whole tile per call
+    /// @param maxWorkers max number of worker threads (see util::ThreadPool)
+    WorldPregenerator(
+        Level& level,
+        const glm::ivec2& start,
+        const glm::ivec2& size,
+        int64_t timeBudget = FRAME_TIME_BUDGET,
+        int maxWorkers = 0
+    );
+    ~WorldPregenerator();
+
+    /// @brief Continue processing of the area within the time budget
+    void update() override;
+
+    bool isActive() const override;
+    uint getWorkTotal() const override;
+    uint getWorkDone() const override;
+    void waitForEnd() override;
+    void terminate() override;
+
+    const glm::ivec2& getStart() const {
+        return start;
+    }
+
+    const glm::ivec2& getSize() const {
+        return size;
+    }
+
+    const WorldGenerator& getGenerator() const {
+        return *generator;
+    }
+};
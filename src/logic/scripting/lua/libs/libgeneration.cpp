@@ -5,6 +5,9 @@
 #include "coders/binary_json.hpp"
 #include "world/Level.hpp"
 #include "world/generator/VoxelFragment.hpp"
+#include "world/generator/WorldGenerator.hpp"
+#include "logic/LevelController.hpp"
+#include "logic/ChunksController.hpp"
 #include "content/ContentLoader.hpp"
 #include "content/Content.hpp"
 #include "content/ContentControl.hpp"
@@ -75,11 +78,28 @@ static int l_get_default_generator(lua::State* L) {
     return lua::pushstring(L, combined["generator"].asString());
 }
 
+/// @brief Get world generator stages statistics of the last second.
+/// Pre-generator statistics are returned while pre-generation is active
+/// @return A table with the interval and per-stage times in microseconds
+static int l_get_profile(lua::State* L) {
+    if (controller == nullptr) {
+        return 0;
+    }
+    const WorldGenerator* generator;
+    if (auto pregenerator = controller->getPregenerator()) {
+        generator = &pregenerator->getGenerator();
+    } else {
+        generator = controller->getChunksController()->getGenerator();
+    }
+    return lua::pushvalue(L, generator->getProfile().serialize());
+}
+
 const luaL_Reg generationlib[] = {
     {"create_fragment", lua::wrap<l_create_fragment>},
     {"save_fragment", lua::wrap<l_save_fragment>},
     {"load_fragment", lua::wrap<l_load_fragment>},
     {"get_generators", lua::wrap<l_get_generators>},
     {"get_default_generator", lua::wrap<l_get_default_generator>},
+    {"get_profile", lua::wrap<l_get_profile>},
     {NULL, NULL}
 };
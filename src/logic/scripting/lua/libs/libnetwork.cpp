@@ -1,6 +1,7 @@
 #include "api_lua.hpp"
 
 #include "engine/Engine.hpp"
+#include "logic/LevelController.hpp"
 #include "network/Network.hpp"
 #include "coders/json.hpp"
 
@@ -79,9 +80,6 @@ static int l_post(lua::State* L, network::Network& network) {
     }
 
     engine->getNetwork().post(url, string, [onResponse](std::vector<char> bytes) {
-        auto buffer = std::make_shared<util::Buffer<ubyte>>(
-            reinterpret_cast<const ubyte*>(bytes.data()), bytes.size()
-        );
         engine->postRunnable([=]() {
             onResponse({std::string(bytes.data(), bytes.size())});
         });
@@ -105,6 +103,32 @@ static int l_closeserver(lua::State* L, network::Network& network) {
     return 0;
 }
 
+/// @brief Get bytes of table, string or Bytearray argument
+/// @param buffer storage for the table contents
+static std::string_view get_bytes(
+    lua::State* L, int idx, util::Buffer<char>& buffer
+) {
+    if (lua::istable(L, idx)) {
+        lua::pushvalue(L, idx);
+        size_t size = lua::objlen(L, idx);
+        buffer = util::Buffer<char>(size);
+        for (size_t i = 0; i < size; i++) {
+            lua::rawgeti(L, i + 1);
+            buffer[i] = lua::tointeger(L, -1);
+            lua::pop(L);
+        }
+        lua::pop(L);
+        return std::string_view(buffer.data(), size);
+    } else if (lua::isstring(L, idx)) {
+        return lua::tolstring(L, idx);
+    } else if (auto bytearray = lua::tobytearray(L, idx)) {
+        return std::string_view(
+            reinterpret_cast<const char*>(bytearray->bytes), bytearray->size
+        );
+    }
+    throw std::runtime_error("table, string or Bytearray expected");
+}
+
 static int l_send(lua::State* L, network::Network& network) {
     u64id_t id = lua::tointeger(L, 1);
     auto connection = network.getConnection(id);
@@ -112,28 +136,51 @@ static int l_send(lua::State* L, network::Network& network) {
         connection->getState() == network::ConnectionState::CLOSED) {
         return 0;
     }
-    if (lua::istable(L, 2)) {
-        lua::pushvalue(L, 2);
-        size_t size = lua::objlen(L, 2);
-        util::Buffer<char> buffer(size);
-        for (size_t i = 0; i < size; i++) {
-            lua::rawgeti(L, i + 1);
-            buffer[i] = lua::tointeger(L, -1);
-            lua::pop(L);
-        }
-        lua::pop(L);
-        connection->send(buffer.data(), size);
-    } else if (lua::isstring(L, 2)) {
-        auto string = lua::tolstring(L, 2);
-        connection->send(string.data(), string.length());
-    } else {
-        auto string = lua::bytearray_as_string(L, 2);
-        connection->send(string.data(), string.length());
-        lua::pop(L);
+    util::Buffer<char> buffer;
+    auto bytes = get_bytes(L, 2, buffer);
+    connection->send(bytes.data(), bytes.length());
+    return 0;
+}
+
+static int l_send_message(lua::State* L, network::Network& network) {
+    u64id_t id = lua::tointeger(L, 1);
+    auto connection = network.getConnection(id);
+    if (connection == nullptr ||
+        connection->getState() == network::ConnectionState::CLOSED) {
+        return 0;
     }
+    util::Buffer<char> buffer;
+    auto bytes = get_bytes(L, 2, buffer);
+    connection->sendMessage(
+        reinterpret_cast<const ubyte*>(bytes.data()),
+        bytes.length(),
+        lua::toboolean(L, 3) ? compression::Method::GZIP
+                             : compression::Method::NONE
+    );
     return 0;
 }
 
+static int l_recv_message(lua::State* L, network::Network& network) {
+    u64id_t id = lua::tointeger(L, 1);
+    auto connection = network.getConnection(id);
+    if (connection == nullptr) {
+        return 0;
+    }
+    std::vector<ubyte> message;
+    if (!connection->recvMessage(message)) {
+        return 0;
+    }
+    if (lua::toboolean(L, 2)) {
+        lua::createtable(L, message.size(), 0);
+        for (size_t i = 0; i < message.size(); i++) {
+            lua::pushinteger(L, message[i]);
+            lua::rawseti(L, i + 1);
+        }
+        return 1;
+    }
+    return lua::create_bytearray(L, message);
+}
+
 static int l_recv(lua::State* L, network::Network& network) {
     u64id_t id = lua::tointeger(L, 1);
     int length = lua::tointeger(L, 2);
@@ -142,22 +189,57 @@ static int l_recv(lua::State* L, network::Network& network) {
         return 0;
     }
     length = glm::min(length, connection->available());
-    util::Buffer<char> buffer(length);
-    
-    int size = connection->recv(buffer.data(), length);
-    if (size == -1) {
-        return 0;
-    }
     if (lua::toboolean(L, 3)) {
+        util::Buffer<char> buffer(length);
+
+        int size = connection->recv(buffer.data(), length);
+        if (size == -1) {
+            return 0;
+        }
         lua::createtable(L, size, 0);
         for (size_t i = 0; i < size; i++) {
             lua::pushinteger(L, buffer[i] & 0xFF);
             lua::rawseti(L, i+1);
         }
         return 1;
-    } else {
-        return lua::create_bytearray(L, buffer.data(), size);
     }
+    // receive directly into the Bytearray memory
+    auto bytearray = lua::create_bytearray(L, length);
+    int size = connection->recv(
+        reinterpret_cast<char*>(bytearray->bytes), length
+    );
+    if (size == -1) {
+        lua::pop(L);
+        return 0;
+    }
+    bytearray->size = size;
+    return 1;
+}
+
+static int l_recv_into(lua::State* L, network::Network& network) {
+    u64id_t id = lua::tointeger(L, 1);
+    auto connection = network.getConnection(id);
+    if (connection == nullptr) {
+        return 0;
+    }
+    int length = connection->available();
+    if (!lua::isnoneornil(L, 3)) {
+        length = glm::min(length, static_cast<int>(lua::tointeger(L, 3)));
+    }
+    // appending to the end of the Bytearray without intermediate buffers
+    auto bytearray = lua::tobytearray(L, 2);
+    if (bytearray == nullptr) {
+        throw std::runtime_error("Bytearray expected");
+    }
+    lua::reserve_bytearray(L, 2, bytearray->size + length);
+    int size = connection->recv(
+        reinterpret_cast<char*>(bytearray->bytes + bytearray->size), length
+    );
+    if (size == -1) {
+        return 0;
+    }
+    bytearray->size += size;
+    return lua::pushinteger(L, size);
 }
 
 static int l_available(lua::State* L, network::Network& network) {
@@ -274,6 +356,42 @@ static int l_pull_events(lua::State* L, network::Network& network) {
     return 1;
 }
 
+static ChunksStreaming& require_chunks_streaming() {
+    if (controller == nullptr) {
+        throw std::runtime_error("no world open");
+    }
+    return *controller->getChunksStreaming();
+}
+
+static int l_stream_chunk(lua::State* L, network::Network& network) {
+    u64id_t id = lua::tointeger(L, 1);
+    int x = lua::tointeger(L, 2);
+    int z = lua::tointeger(L, 3);
+    if (network.getConnection(id) == nullptr) {
+        return lua::pushboolean(L, false);
+    }
+    return lua::pushboolean(
+        L, require_chunks_streaming().subscribe(id, x, z)
+    );
+}
+
+static int l_unstream_chunk(lua::State* L, network::Network& network) {
+    u64id_t id = lua::tointeger(L, 1);
+    int x = lua::tointeger(L, 2);
+    int z = lua::tointeger(L, 3);
+    require_chunks_streaming().unsubscribe(id, x, z);
+    return 0;
+}
+
+static int l_receive_chunks(lua::State* L, network::Network& network) {
+    u64id_t id = lua::tointeger(L, 1);
+    if (network.getConnection(id) == nullptr) {
+        return 0;
+    }
+    require_chunks_streaming().receive(id);
+    return 0;
+}
+
 template <int(*func)(lua::State*, network::Network&)>
 int wrap(lua_State* L) {
     int result = 0;
@@ -304,11 +422,17 @@ const luaL_Reg networklib[] = {
     {"__close", wrap<l_close>},
     {"__send", wrap<l_send>},
     {"__recv", wrap<l_recv>},
+    {"__recv_into", wrap<l_recv_into>},
+    {"__send_message", wrap<l_send_message>},
+    {"__recv_message", wrap<l_recv_message>},
     {"__available", wrap<l_available>},
     {"__is_alive", wrap<l_is_alive>},
     {"__is_connected", wrap<l_is_connected>},
     {"__get_address", wrap<l_get_address>},
     {"__is_serveropen", wrap<l_is_serveropen>},
     {"__get_serverport", wrap<l_get_serverport>},
+    {"__stream_chunk", wrap<l_stream_chunk>},
+    {"__unstream_chunk", wrap<l_unstream_chunk>},
+    {"__receive_chunks", wrap<l_receive_chunks>},
     {NULL, NULL}
 };
@@ -222,6 +222,29 @@ static int l_count_chunks(lua::State* L) {
     return lua::pushinteger(L, level->chunks->size());
 }
 
+static int l_pregenerate(lua::State* L) {
+    if (controller == nullptr) {
+        throw std::runtime_error("no open world");
+    }
+    glm::ivec2 start(lua::tointeger(L, 1), lua::tointeger(L, 2));
+    glm::ivec2 size(lua::tointeger(L, 3), lua::tointeger(L, 4));
+    controller->pregenerate(start, size);
+    return 0;
+}
+
+static int l_get_pregen_progress(lua::State* L) {
+    if (controller == nullptr) {
+        return 0;
+    }
+    auto pregenerator = controller->getPregenerator();
+    if (pregenerator == nullptr) {
+        return 0;
+    }
+    lua::pushinteger(L, pregenerator->getWorkDone());
+    lua::pushinteger(L, pregenerator->getWorkTotal());
+    return 2;
+}
+
 static int l_reload_script(lua::State* L) {
     auto packid = lua::require_string(L, 1);
     if (content == nullptr) {
@@ -250,6 +273,8 @@ const luaL_Reg worldlib[] = {
     {"set_chunk_data", lua::wrap<l_set_chunk_data>},
     {"save_chunk_data", lua::wrap<l_save_chunk_data>},
     {"count_chunks", lua::wrap<l_count_chunks>},
+    {"pregenerate", lua::wrap<l_pregenerate>},
+    {"get_pregen_progress", lua::wrap<l_get_pregen_progress>},
     {"reload_script", lua::wrap<l_reload_script>},
     {NULL, NULL}
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstring>
 #include <stdexcept>
 #include <typeindex>
 #include <typeinfo>
@@ -746,12 +747,71 @@ namespace lua {
         }
     }
 
-    inline int create_bytearray(lua::State* L, const void* bytes, size_t size) {
-        lua::requireglobal(L, "Bytearray_construct");
-        lua::pushlstring(
-            L, std::string_view(reinterpret_cast<const char*>(bytes), size)
+    /// @brief FFI Bytearray memory layout (see core:internal/bytearray)
+    struct FFIBytearray {
+        ubyte* bytes;
+        int size;
+        int capacity;
+    };
+
+    /// @brief Get FFI Bytearray data at the given stack index
+    /// @return nullptr if value is not a Bytearray
+    inline FFIBytearray* tobytearray(lua::State* L, int idx) {
+        if (std::strcmp(luaL_typename(L, idx), "cdata")) {
+            return nullptr;
+        }
+        if (idx < 0) {
+            idx = lua::gettop(L) + idx + 1;
+        }
+        // any other cdata has unrelated memory layout
+        lua::requireglobal(L, "Bytearray_istype");
+        lua::pushvalue(L, idx);
+        lua::call(L, 1, 1);
+        bool isBytearray = lua::toboolean(L, -1);
+        lua::pop(L);
+        if (!isBytearray) {
+            return nullptr;
+        }
+        // LuaJIT 2.1 returns address of the cdata payload
+        return static_cast<FFIBytearray*>(
+            const_cast<void*>(lua_topointer(L, idx))
         );
-        return lua::call(L, 1, 1);
+    }
+
+    /// @brief Push new Bytearray of the given size to the stack
+    /// @return pointer to the Bytearray data to be filled by the caller
+    inline FFIBytearray* create_bytearray(lua::State* L, size_t size) {
+        lua::requireglobal(L, "Bytearray_construct");
+        lua::pushinteger(L, size);
+        lua::call(L, 1, 1);
+        return tobytearray(L, -1);
+    }
+
+    /// @brief Ensure Bytearray at the given stack index is able to store
+    /// the given number of bytes without reallocation
+    inline FFIBytearray* reserve_bytearray(
+        lua::State* L, int idx, size_t capacity
+    ) {
+        auto bytearray = tobytearray(L, idx);
+        if (bytearray == nullptr) {
+            throw std::runtime_error("Bytearray expected");
+        }
+        if (bytearray->capacity < capacity) {
+            if (idx < 0) {
+                idx = lua::gettop(L) + idx + 1;
+            }
+            lua::requirefield(L, "reserve", idx);
+            lua::pushvalue(L, idx);
+            lua::pushinteger(L, capacity);
+            lua::call(L, 2, 0);
+        }
+        return bytearray;
+    }
+
+    inline int create_bytearray(lua::State* L, const void* bytes, size_t size) {
+        auto bytearray = create_bytearray(L, size);
+        std::memcpy(bytearray->bytes, bytes, size);
+        return 1;
     }
 
     inline int create_bytearray(lua::State* L, const std::vector<ubyte>& bytes) {
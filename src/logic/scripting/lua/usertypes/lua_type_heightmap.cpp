@@ -6,8 +6,8 @@
 #include <filesystem>
 
 #include "util/functional_util.hpp"
-#define FNL_IMPL
 #include "maths/FastNoiseLite.h"
+#include "maths/noise_batch.hpp"
 #include "coders/imageio.hpp"
 #include "io/util.hpp"
 #include "graphics/core/ImageData.hpp"
@@ -109,24 +109,38 @@ static int l_noise(lua::State* L) {
             shiftMapY = touserdata<LuaHeightmap>(L, 7);
         }
         noise->noise_type = noise_type;
-        for (uint y = 0; y < h; y++) {
-            for (uint x = 0; x < w; x++) {
-                uint i = y * w + x;
-                for (uint c = 0; c < octaves; c++) {
-                    float m = s * (1 << c);
-                    float value = heights[i];
-                    float u = (x + offset.x) * m;
-                    float v = (y + offset.y) * m;
-                    if (shiftMapX) {
-                        u += shiftMapX->getValues()[i];
+        // rows are evaluated in batches; octaves are still accumulated
+        // in the same order for every cell
+        std::vector<float> us(w);
+        std::vector<float> vs(w);
+        std::vector<float> values(w);
+        for (uint c = 0; c < octaves; c++) {
+            float m = s * (1 << c);
+            for (uint y = 0; y < h; y++) {
+                uint row = y * w;
+                for (uint x = 0; x < w; x++) {
+                    us[x] = (x + offset.x) * m;
+                    vs[x] = (y + offset.y) * m;
+                }
+                if (shiftMapX) {
+                    const float* shifts = shiftMapX->getValues() + row;
+                    for (uint x = 0; x < w; x++) {
+                        us[x] += shifts[x];
                     }
-                    if (shiftMapY) {
-                        v += shiftMapY->getValues()[i];
+                }
+                if (shiftMapY) {
+                    const float* shifts = shiftMapY->getValues() + row;
+                    for (uint x = 0; x < w; x++) {
+                        vs[x] += shifts[x];
                     }
-
-                    value += fnlGetNoise2D(noise, u, v) /
-                            static_cast<float>(1 << c) * multiplier;
-                    heights[i] = value;
+                }
+                noise_batch::noise2d(
+                    *noise, us.data(), vs.data(), w, values.data()
+                );
+                for (uint x = 0; x < w; x++) {
+                    heights[row + x] += values[x] /
+                                        static_cast<float>(1 << c) *
+                                        multiplier;
                 }
             }
         }
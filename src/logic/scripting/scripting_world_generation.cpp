@@ -21,10 +21,24 @@ using namespace lua;
 
 static debug::Logger logger("generator-scripting");
 
+/// @brief Seed of the chunk random, depends on the world seed and the
+/// position only (fits in a double mantissa)
+static uint64_t chunk_seed(uint64_t seed, int x, int z) {
+    auto ux = static_cast<uint64_t>(static_cast<uint32_t>(x));
+    auto uz = static_cast<uint64_t>(static_cast<uint32_t>(z));
+    uint64_t h = seed ^ (ux * 0x9E3779B97F4A7C15ULL) ^
+                 (uz * 0xC2B2AE3D27D4EB4FULL);
+    h ^= h >> 31;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 29;
+    return h & ((1ULL << 53) - 1);
+}
+
 class LuaGeneratorScript : public GeneratorScript {
     State* L;
     const GeneratorDef& def;
     scriptenv env = nullptr;
+    uint64_t seed = 0;
 
     io::path file;
     std::string dirPath;
@@ -45,7 +59,29 @@ public:
         }
     }
 
+    std::unique_ptr<GeneratorScript> createWorker() const override {
+        auto L = create_state(
+            Engine::getInstance().getPaths(), StateType::GENERATOR
+        );
+        return std::make_unique<LuaGeneratorScript>(L, def, file, dirPath);
+    }
+
+    /// @brief Reseed math.random of the state, so placements of the chunk
+    /// do not depend on the order chunks are generated in and on the state
+    /// (main or worker) generating them
+    void reseed(const glm::ivec2& offset) {
+        stackguard _(L);
+        if (getglobal(L, "math") && getfield(L, "randomseed")) {
+            pushnumber(
+                L,
+                static_cast<Number>(chunk_seed(seed, offset.x, offset.y))
+            );
+            call_nothrow(L, 1, 0);
+        }
+    }
+
     void initialize(uint64_t seed) override {
+        this->seed = seed;
         env = create_environment(L);
         stackguard _(L);
 
@@ -200,6 +236,7 @@ public:
         std::vector<Placement> placements {};
         
         stackguard _(L);
+        reseed(offset);
         pushenv(L, *env);
         try {
             if (getfield(L, "place_structures_wide")) {
@@ -233,6 +270,7 @@ public:
         std::vector<Placement> placements {};
         
         stackguard _(L);
+        reseed(offset);
         pushenv(L, *env);
         if (getfield(L, "place_structures")) {
             pushivec_stack(L, offset);
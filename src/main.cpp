@@ -26,7 +26,14 @@ int main(int argc, char** argv) {
     }
     std::signal(SIGTERM, sigterm_handler);
     
-    debug::Logger::init(coreParameters.userFolder.string()+"/latest.log");
+    if (coreParameters.binaryLog) {
+        debug::Logger::init(
+            coreParameters.userFolder.string() + "/latest.vclog",
+            debug::LogFormat::binary
+        );
+    } else {
+        debug::Logger::init(coreParameters.userFolder.string()+"/latest.log");
+    }
     platform::configure_encoding();
 
     auto& engine = Engine::getInstance();
@@ -44,5 +51,6 @@ int main(int argc, char** argv) {
     }
 #endif
     Engine::terminate();
+    debug::Logger::shutdown();
     return EXIT_SUCCESS;
 }
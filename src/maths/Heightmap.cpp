@@ -7,18 +7,19 @@
 
 static inline float sample_at(
     const float* buffer,
-    uint width,
+    uint stride,
     uint x, uint y
 ) {
-    return buffer[y*width+x];
+    return buffer[y*stride+x];
 }
 
 static inline float sample_at(
     const float* buffer,
+    uint stride,
     uint width, uint height,
     uint x, uint y
 ) {
-    return buffer[(y >= height ? height-1 : y)*width+(x >= width ? width-1 : x)];
+    return buffer[(y >= height ? height-1 : y)*stride+(x >= width ? width-1 : x)];
 }
 
 static inline float interpolate_cubic(float p[4], float x) {
@@ -34,8 +35,10 @@ static inline float interpolate_bicubic(float p[4][4], float x, float y) {
     return interpolate_cubic(q, x);
 }
 
+/// @param stride number of values in the buffer row
 static inline float sample_at(
     const float* buffer,
+    uint stride,
     uint width, uint height,
     float x, float y,
     InterpolationType interp
@@ -43,7 +46,7 @@ static inline float sample_at(
     // std::floor is redundant here because x and y are positive values
     uint ix = static_cast<uint>(x);
     uint iy = static_cast<uint>(y);
-    float val = buffer[iy*width+ix];
+    float val = buffer[iy*stride+ix];
     if (interp == InterpolationType::NEAREST) {
         return val;
     }
@@ -53,11 +56,11 @@ static inline float sample_at(
     switch (interp) {
         case InterpolationType::LINEAR: {
             float s00 = val;
-            float s10 = sample_at(buffer, width, 
+            float s10 = sample_at(buffer, stride, 
                 ix + 1 < width ? ix + 1 : ix, iy);
-            float s01 = sample_at(buffer, width, ix, 
+            float s01 = sample_at(buffer, stride, ix, 
                 iy + 1 < height ? iy + 1 : iy);
-            float s11 = sample_at(buffer, width, 
+            float s11 = sample_at(buffer, stride, 
                 ix + 1 < width ? ix + 1 : ix, iy + 1 < height ? iy + 1 : iy);
 
             float a00 = s00;
@@ -72,7 +75,7 @@ static inline float sample_at(
             for (int i = 0; i < 4; i++) {
                 for (int j = 0; j < 4; j++) {
                     p[i][j] = sample_at(
-                        buffer, width, height, ix + j - 1, iy + i - 1
+                        buffer, stride, width, height, ix + j - 1, iy + i - 1
                     );
                 }
             }
@@ -98,7 +101,9 @@ void Heightmap::resize(
         for (uint x = 0; x < dstwidth; x++, index++) {
             float sx = static_cast<float>(x) / dstwidth * width;
             float sy = static_cast<float>(y) / dstheight * height;
-            dst[index] = sample_at(buffer.data(), width, height, sx, sy, interp);
+            dst[index] = sample_at(
+                buffer.data(), width, width, height, sx, sy, interp
+            );
         }
     }
 
@@ -107,6 +112,42 @@ void Heightmap::resize(
     buffer = std::move(dst);
 }
 
+void Heightmap::resampleTo(
+    Heightmap& dst,
+    uint srcx, uint srcy,
+    uint srcwidth, uint srcheight,
+    uint scaledwidth, uint scaledheight,
+    InterpolationType interp
+) const {
+    if (srcx + srcwidth > width || srcy + srcheight > height) {
+        throw std::runtime_error(
+            "resample zone is not fully inside of the source image");
+    }
+    if (dst.width > scaledwidth || dst.height > scaledheight) {
+        throw std::runtime_error(
+            "destination image is larger than the scaled zone");
+    }
+    const float* src = buffer.data() + srcy * width + srcx;
+    float* out = dst.buffer.data();
+    if (srcwidth == scaledwidth && srcheight == scaledheight) {
+        for (uint y = 0; y < dst.height; y++) {
+            std::memcpy(
+                out + y * dst.width, src + y * width, dst.width * sizeof(float)
+            );
+        }
+        return;
+    }
+    uint index = 0;
+    for (uint y = 0; y < dst.height; y++) {
+        for (uint x = 0; x < dst.width; x++, index++) {
+            float sx = static_cast<float>(x) / scaledwidth * srcwidth;
+            float sy = static_cast<float>(y) / scaledheight * srcheight;
+            out[index] =
+                sample_at(src, width, srcwidth, srcheight, sx, sy, interp);
+        }
+    }
+}
+
 void Heightmap::crop(
     uint srcx, uint srcy, uint dstwidth, uint dstheight
 ) {
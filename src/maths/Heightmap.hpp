@@ -36,6 +36,17 @@ public:
 
     void resize(uint width, uint height, InterpolationType interpolation);
 
+    /// @brief Write zone of the map resized to scaledWidth x scaledHeight
+    /// to the destination map. Result is the same as the zone copy resized
+    /// and cropped to the destination map size, but without allocations
+    void resampleTo(
+        Heightmap& dst,
+        uint srcX, uint srcY,
+        uint srcWidth, uint srcHeight,
+        uint scaledWidth, uint scaledHeight,
+        InterpolationType interpolation
+    ) const;
+
     void crop(uint srcX, uint srcY, uint dstWidth, uint dstHeight);
 
     void clamp();
@@ -0,0 +1,531 @@
+#include "noise_batch.hpp"
+
+#include <cfloat>
+
+#define FNL_IMPL
+#include "FastNoiseLite.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define NOISE_BATCH_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define NOISE_BATCH_NEON
+#endif
+
+#if defined(NOISE_BATCH_SSE2) || defined(NOISE_BATCH_NEON)
+    #define NOISE_BATCH_SIMD
+#endif
+
+#ifdef NOISE_BATCH_SIMD
+// Lane operations used by the kernels below. Kernels repeat operations
+// order of the scalar FastNoiseLite code to produce the same values
+namespace {
+    constexpr size_t LANES = 4;
+
+#ifdef NOISE_BATCH_SSE2
+    using vfloat = __m128;
+    using vint = __m128i;
+    using vmask = __m128;
+
+    inline vfloat fset(float value) { return _mm_set1_ps(value); }
+    inline vint iset(int value) { return _mm_set1_epi32(value); }
+    inline vfloat fload(const float* src) { return _mm_loadu_ps(src); }
+    inline void fstore(float* dst, vfloat v) { _mm_storeu_ps(dst, v); }
+    inline void istore(int* dst, vint v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), v);
+    }
+
+    inline vfloat fadd(vfloat a, vfloat b) { return _mm_add_ps(a, b); }
+    inline vfloat fsub(vfloat a, vfloat b) { return _mm_sub_ps(a, b); }
+    inline vfloat fmul(vfloat a, vfloat b) { return _mm_mul_ps(a, b); }
+    inline vfloat fdiv(vfloat a, vfloat b) { return _mm_div_ps(a, b); }
+    inline vfloat fmin(vfloat a, vfloat b) { return _mm_min_ps(a, b); }
+    inline vfloat fmax(vfloat a, vfloat b) { return _mm_max_ps(a, b); }
+
+    inline vmask fgt(vfloat a, vfloat b) { return _mm_cmpgt_ps(a, b); }
+    inline vmask flt(vfloat a, vfloat b) { return _mm_cmplt_ps(a, b); }
+    inline vmask fge(vfloat a, vfloat b) { return _mm_cmpge_ps(a, b); }
+    inline vmask mand(vmask a, vmask b) { return _mm_and_ps(a, b); }
+    /// @return !a && b
+    inline vmask mandnot(vmask a, vmask b) { return _mm_andnot_ps(a, b); }
+    inline vmask mnot(vmask a) {
+        return _mm_xor_ps(a, _mm_castsi128_ps(_mm_set1_epi32(-1)));
+    }
+
+    inline vfloat fselect(vmask mask, vfloat a, vfloat b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    inline vint iselect(vmask mask, vint a, vint b) {
+        __m128i m = _mm_castps_si128(mask);
+        return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+    }
+    /// @return -1 for lanes set in the mask, 0 for others
+    inline vint mask_to_int(vmask mask) { return _mm_castps_si128(mask); }
+
+    inline vint iadd(vint a, vint b) { return _mm_add_epi32(a, b); }
+    inline vint isub(vint a, vint b) { return _mm_sub_epi32(a, b); }
+    inline vint ixor(vint a, vint b) { return _mm_xor_si128(a, b); }
+    inline vint iand(vint a, vint b) { return _mm_and_si128(a, b); }
+    inline vint ior(vint a, vint b) { return _mm_or_si128(a, b); }
+    /// @brief Low 32 bits of product (SSE2 has no _mm_mullo_epi32)
+    inline vint imul(vint a, vint b) {
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(
+            _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))
+        );
+    }
+    template <int N>
+    inline vint isra(vint a) { return _mm_srai_epi32(a, N); }
+
+    inline vint ftrunc(vfloat a) { return _mm_cvttps_epi32(a); }
+    inline vfloat itof(vint a) { return _mm_cvtepi32_ps(a); }
+#else
+    using vfloat = float32x4_t;
+    using vint = int32x4_t;
+    using vmask = uint32x4_t;
+
+    inline vfloat fset(float value) { return vdupq_n_f32(value); }
+    inline vint iset(int value) { return vdupq_n_s32(value); }
+    inline vfloat fload(const float* src) { return vld1q_f32(src); }
+    inline void fstore(float* dst, vfloat v) { vst1q_f32(dst, v); }
+    inline void istore(int* dst, vint v) { vst1q_s32(dst, v); }
+
+    inline vfloat fadd(vfloat a, vfloat b) { return vaddq_f32(a, b); }
+    inline vfloat fsub(vfloat a, vfloat b) { return vsubq_f32(a, b); }
+    inline vfloat fmul(vfloat a, vfloat b) { return vmulq_f32(a, b); }
+    inline vfloat fdiv(vfloat a, vfloat b) { return vdivq_f32(a, b); }
+    inline vfloat fmin(vfloat a, vfloat b) { return vminq_f32(a, b); }
+    inline vfloat fmax(vfloat a, vfloat b) { return vmaxq_f32(a, b); }
+
+    inline vmask fgt(vfloat a, vfloat b) { return vcgtq_f32(a, b); }
+    inline vmask flt(vfloat a, vfloat b) { return vcltq_f32(a, b); }
+    inline vmask fge(vfloat a, vfloat b) { return vcgeq_f32(a, b); }
+    inline vmask mand(vmask a, vmask b) { return vandq_u32(a, b); }
+    /// @return !a && b
+    inline vmask mandnot(vmask a, vmask b) { return vbicq_u32(b, a); }
+    inline vmask mnot(vmask a) { return vmvnq_u32(a); }
+
+    inline vfloat fselect(vmask mask, vfloat a, vfloat b) {
+        return vbslq_f32(mask, a, b);
+    }
+    inline vint iselect(vmask mask, vint a, vint b) {
+        return vbslq_s32(mask, a, b);
+    }
+    /// @return -1 for lanes set in the mask, 0 for others
+    inline vint mask_to_int(vmask mask) { return vreinterpretq_s32_u32(mask); }
+
+    inline vint iadd(vint a, vint b) { return vaddq_s32(a, b); }
+    inline vint isub(vint a, vint b) { return vsubq_s32(a, b); }
+    inline vint ixor(vint a, vint b) { return veorq_s32(a, b); }
+    inline vint iand(vint a, vint b) { return vandq_s32(a, b); }
+    inline vint ior(vint a, vint b) { return vorrq_s32(a, b); }
+    inline vint imul(vint a, vint b) { return vmulq_s32(a, b); }
+    template <int N>
+    inline vint isra(vint a) { return vshrq_n_s32(a, N); }
+
+    inline vint ftrunc(vfloat a) { return vcvtq_s32_f32(a); }
+    inline vfloat itof(vint a) { return vcvtq_f32_s32(a); }
+#endif
+
+    /// @brief Same as _fnlFastFloor (including result for negative integers)
+    inline vint ffloor(vfloat a) {
+        return iadd(ftrunc(a), mask_to_int(flt(a, fset(0.0f))));
+    }
+
+    /// @brief Same as _fnlFastRound
+    inline vint fround(vfloat a) {
+        vfloat half = fselect(fge(a, fset(0.0f)), fset(0.5f), fset(-0.5f));
+        return ftrunc(fadd(a, half));
+    }
+
+    /// @brief Load table[indices[i]] and table[indices[i] | 1] for each lane.
+    /// Indices must be even
+    inline void gather_pairs(
+        const float* table, vint indices, vfloat& first, vfloat& second
+    ) {
+        alignas(16) int idx[LANES];
+        alignas(16) float a[LANES];
+        alignas(16) float b[LANES];
+        istore(idx, indices);
+        for (size_t i = 0; i < LANES; i++) {
+            a[i] = table[idx[i]];
+            b[i] = table[idx[i] | 1];
+        }
+        first = fload(a);
+        second = fload(b);
+    }
+
+    inline vint hash2d(vint seed, vint xPrimed, vint yPrimed) {
+        return imul(ixor(ixor(seed, xPrimed), yPrimed), iset(0x27d4eb2d));
+    }
+
+    inline vfloat grad_coord2d(
+        vint seed, vint xPrimed, vint yPrimed, vfloat xd, vfloat yd
+    ) {
+        vint hash = hash2d(seed, xPrimed, yPrimed);
+        hash = ixor(hash, isra<15>(hash));
+        hash = iand(hash, iset(127 << 1));
+        vfloat gx, gy;
+        gather_pairs(GRADIENTS_2D, hash, gx, gy);
+        return fadd(fmul(xd, gx), fmul(yd, gy));
+    }
+
+    /// @brief Vectorized _fnlSingleSimplex2D (coordinates must be skewed)
+    vfloat simplex2d(vint seed, vfloat x, vfloat y) {
+        const float SQRT3 = 1.7320508075688772935274463415059f;
+        const float G2 = (3 - SQRT3) / 6;
+        const vfloat zero = fset(0.0f);
+        const vfloat half = fset(0.5f);
+
+        vint i = ffloor(x);
+        vint j = ffloor(y);
+        vfloat xi = fsub(x, itof(i));
+        vfloat yi = fsub(y, itof(j));
+
+        vfloat t = fmul(fadd(xi, yi), fset(G2));
+        vfloat x0 = fsub(xi, t);
+        vfloat y0 = fsub(yi, t);
+
+        i = imul(i, iset(PRIME_X));
+        j = imul(j, iset(PRIME_Y));
+
+        vfloat a = fsub(fsub(half, fmul(x0, x0)), fmul(y0, y0));
+        vfloat aa = fmul(a, a);
+        vfloat n0 = fmul(fmul(aa, aa), grad_coord2d(seed, i, j, x0, y0));
+        n0 = fselect(fgt(a, zero), n0, zero);
+
+        vfloat c = fadd(
+            fmul(fset((float)(2 * (1 - 2 * G2) * (1 / G2 - 2))), t),
+            fadd(fset((float)(-2 * (1 - 2 * G2) * (1 - 2 * G2))), a)
+        );
+        vfloat x2 = fadd(x0, fset(2 * (float)G2 - 1));
+        vfloat y2 = fadd(y0, fset(2 * (float)G2 - 1));
+        vfloat cc = fmul(c, c);
+        vfloat n2 = fmul(
+            fmul(cc, cc),
+            grad_coord2d(
+                seed,
+                iadd(i, iset(PRIME_X)),
+                iadd(j, iset(PRIME_Y)),
+                x2,
+                y2
+            )
+        );
+        n2 = fselect(fgt(c, zero), n2, zero);
+
+        vmask upper = fgt(y0, x0);
+        vfloat x1 = fadd(
+            x0, fselect(upper, fset((float)G2), fset((float)G2 - 1))
+        );
+        vfloat y1 = fadd(
+            y0, fselect(upper, fset((float)G2 - 1), fset((float)G2))
+        );
+        vint i1 = iadd(i, iselect(upper, iset(0), iset(PRIME_X)));
+        vint j1 = iadd(j, iselect(upper, iset(PRIME_Y), iset(0)));
+        vfloat b = fsub(fsub(half, fmul(x1, x1)), fmul(y1, y1));
+        vfloat bb = fmul(b, b);
+        vfloat n1 = fmul(fmul(bb, bb), grad_coord2d(seed, i1, j1, x1, y1));
+        n1 = fselect(fgt(b, zero), n1, zero);
+
+        return fmul(fadd(fadd(n0, n1), n2), fset(99.83685446303647f));
+    }
+
+    /// @brief Vectorized _fnlSingleCellular2D for the euclidean squared
+    /// distance function
+    vfloat cellular2d(const fnl_state& state, vint seed, vfloat x, vfloat y) {
+        vint xr = fround(x);
+        vint yr = fround(y);
+
+        vfloat distance0 = fset(FLT_MAX);
+        vfloat distance1 = fset(FLT_MAX);
+        vint closestHash = iset(0);
+
+        vfloat cellularJitter = fset(0.5f * state.cellular_jitter_mod);
+
+        vint xPrimed = imul(iadd(xr, iset(-1)), iset(PRIME_X));
+        vint yPrimedBase = imul(iadd(yr, iset(-1)), iset(PRIME_Y));
+
+        for (int xo = -1; xo <= 1; xo++) {
+            vfloat xDiff = fsub(itof(iadd(xr, iset(xo))), x);
+            vint yPrimed = yPrimedBase;
+
+            for (int yo = -1; yo <= 1; yo++) {
+                vfloat yDiff = fsub(itof(iadd(yr, iset(yo))), y);
+                vint hash = hash2d(seed, xPrimed, yPrimed);
+                vint idx = iand(hash, iset(255 << 1));
+
+                vfloat randX, randY;
+                gather_pairs(RAND_VECS_2D, idx, randX, randY);
+                vfloat vecX = fadd(xDiff, fmul(randX, cellularJitter));
+                vfloat vecY = fadd(yDiff, fmul(randY, cellularJitter));
+
+                vfloat newDistance =
+                    fadd(fmul(vecX, vecX), fmul(vecY, vecY));
+
+                distance1 = fmax(fmin(distance1, newDistance), distance0);
+                vmask closer = flt(newDistance, distance0);
+                distance0 = fselect(closer, newDistance, distance0);
+                closestHash = iselect(closer, hash, closestHash);
+
+                yPrimed = iadd(yPrimed, iset(PRIME_Y));
+            }
+            xPrimed = iadd(xPrimed, iset(PRIME_X));
+        }
+
+        const vfloat one = fset(1.0f);
+        const vfloat half = fset(0.5f);
+        switch (state.cellular_return_type) {
+            case FNL_CELLULAR_RETURN_VALUE_CELLVALUE:
+                return fmul(itof(closestHash), fset(1 / 2147483648.0f));
+            case FNL_CELLULAR_RETURN_VALUE_DISTANCE:
+                return fsub(distance0, one);
+            case FNL_CELLULAR_RETURN_VALUE_DISTANCE2:
+                return fsub(distance1, one);
+            case FNL_CELLULAR_RETURN_VALUE_DISTANCE2ADD:
+                return fsub(fmul(fadd(distance1, distance0), half), one);
+            case FNL_CELLULAR_RETURN_VALUE_DISTANCE2SUB:
+                return fsub(fsub(distance1, distance0), one);
+            case FNL_CELLULAR_RETURN_VALUE_DISTANCE2MUL:
+                return fsub(fmul(fmul(distance1, distance0), half), one);
+            case FNL_CELLULAR_RETURN_VALUE_DISTANCE2DIV:
+                return fsub(fdiv(distance0, distance1), one);
+            default:
+                return fset(0.0f);
+        }
+    }
+
+    /// @brief Load table[indices[i] + 0..2] for each lane
+    inline void gather_triples(
+        const float* table, vint indices, vfloat& first, vfloat& second,
+        vfloat& third
+    ) {
+        alignas(16) int idx[LANES];
+        alignas(16) float a[LANES];
+        alignas(16) float b[LANES];
+        alignas(16) float c[LANES];
+        istore(idx, indices);
+        for (size_t i = 0; i < LANES; i++) {
+            a[i] = table[idx[i]];
+            b[i] = table[idx[i] | 1];
+            c[i] = table[idx[i] | 2];
+        }
+        first = fload(a);
+        second = fload(b);
+        third = fload(c);
+    }
+
+    inline vfloat grad_coord3d(
+        vint seed,
+        vint xPrimed,
+        vint yPrimed,
+        vint zPrimed,
+        vfloat xd,
+        vfloat yd,
+        vfloat zd
+    ) {
+        vint hash = imul(
+            ixor(ixor(ixor(seed, xPrimed), yPrimed), zPrimed),
+            iset(0x27d4eb2d)
+        );
+        hash = ixor(hash, isra<15>(hash));
+        hash = iand(hash, iset(63 << 2));
+        vfloat gx, gy, gz;
+        gather_triples(GRADIENTS_3D, hash, gx, gy, gz);
+        return fadd(fadd(fmul(xd, gx), fmul(yd, gy)), fmul(zd, gz));
+    }
+
+    /// @brief Vectorized _fnlSingleOpenSimplex23D (coordinates must be
+    /// rotated)
+    vfloat simplex3d(vint seed, vfloat x, vfloat y, vfloat z) {
+        const vfloat zero = fset(0.0f);
+
+        vint i = fround(x);
+        vint j = fround(y);
+        vint k = fround(z);
+        vfloat x0 = fsub(x, itof(i));
+        vfloat y0 = fsub(y, itof(j));
+        vfloat z0 = fsub(z, itof(k));
+
+        const vfloat minusOne = fset(-1.0f);
+        vint xNSign = ior(ftrunc(fsub(minusOne, x0)), iset(1));
+        vint yNSign = ior(ftrunc(fsub(minusOne, y0)), iset(1));
+        vint zNSign = ior(ftrunc(fsub(minusOne, z0)), iset(1));
+
+        vfloat ax0 = fmul(itof(xNSign), fsub(zero, x0));
+        vfloat ay0 = fmul(itof(yNSign), fsub(zero, y0));
+        vfloat az0 = fmul(itof(zNSign), fsub(zero, z0));
+
+        i = imul(i, iset(PRIME_X));
+        j = imul(j, iset(PRIME_Y));
+        k = imul(k, iset(PRIME_Z));
+
+        vfloat value = zero;
+        vfloat a = fsub(
+            fsub(fset(0.6f), fmul(x0, x0)),
+            fadd(fmul(y0, y0), fmul(z0, z0))
+        );
+        for (int l = 0;; l++) {
+            vfloat aa = fmul(a, a);
+            vfloat n0 = fmul(
+                fmul(aa, aa), grad_coord3d(seed, i, j, k, x0, y0, z0)
+            );
+            value = fadd(value, fselect(fgt(a, zero), n0, zero));
+
+            vmask useX = mand(fge(ax0, ay0), fge(ax0, az0));
+            vmask useY = mandnot(useX, mand(fgt(ay0, ax0), fge(ay0, az0)));
+            vmask useZ = mandnot(useX, mnot(useY));
+
+            vfloat x1 = fselect(useX, fadd(x0, itof(xNSign)), x0);
+            vfloat y1 = fselect(useY, fadd(y0, itof(yNSign)), y0);
+            vfloat z1 = fselect(useZ, fadd(z0, itof(zNSign)), z0);
+
+            vfloat bx = fmul(itof(iadd(xNSign, xNSign)), x1);
+            vfloat by = fmul(itof(iadd(yNSign, yNSign)), y1);
+            vfloat bz = fmul(itof(iadd(zNSign, zNSign)), z1);
+            vfloat b = fsub(
+                fadd(a, fset(1.0f)),
+                fselect(useX, bx, fselect(useY, by, bz))
+            );
+            vint i1 = isub(
+                i, iand(mask_to_int(useX), imul(xNSign, iset(PRIME_X)))
+            );
+            vint j1 = isub(
+                j, iand(mask_to_int(useY), imul(yNSign, iset(PRIME_Y)))
+            );
+            vint k1 = isub(
+                k, iand(mask_to_int(useZ), imul(zNSign, iset(PRIME_Z)))
+            );
+
+            vfloat bb = fmul(b, b);
+            vfloat n1 = fmul(
+                fmul(bb, bb), grad_coord3d(seed, i1, j1, k1, x1, y1, z1)
+            );
+            value = fadd(value, fselect(fgt(b, zero), n1, zero));
+
+            if (l == 1) {
+                break;
+            }
+            const vfloat half = fset(0.5f);
+            ax0 = fsub(half, ax0);
+            ay0 = fsub(half, ay0);
+            az0 = fsub(half, az0);
+
+            x0 = fmul(itof(xNSign), ax0);
+            y0 = fmul(itof(yNSign), ay0);
+            z0 = fmul(itof(zNSign), az0);
+
+            a = fadd(a, fsub(fsub(fset(0.75f), ax0), fadd(ay0, az0)));
+
+            i = iadd(i, iand(isra<1>(xNSign), iset(PRIME_X)));
+            j = iadd(j, iand(isra<1>(yNSign), iset(PRIME_Y)));
+            k = iadd(k, iand(isra<1>(zNSign), iset(PRIME_Z)));
+
+            xNSign = isub(iset(0), xNSign);
+            yNSign = isub(iset(0), yNSign);
+            zNSign = isub(iset(0), zNSign);
+
+            seed = ixor(seed, iset(-1));
+        }
+        return fmul(value, fset(32.69428253173828125f));
+    }
+}
+#endif
+
+bool noise_batch::is_vectorized(const fnl_state& state) {
+#ifdef NOISE_BATCH_SIMD
+    if (state.fractal_type != FNL_FRACTAL_NONE) {
+        return false;
+    }
+    switch (state.noise_type) {
+        case FNL_NOISE_OPENSIMPLEX2:
+            return true;
+        case FNL_NOISE_CELLULAR:
+            return state.cellular_distance_func ==
+                   FNL_CELLULAR_DISTANCE_EUCLIDEANSQ;
+        default:
+            return false;
+    }
+#else
+    return false;
+#endif
+}
+
+void noise_batch::noise2d(
+    fnl_state& state,
+    const float* xs,
+    const float* ys,
+    size_t count,
+    float* dst
+) {
+    size_t i = 0;
+#ifdef NOISE_BATCH_SIMD
+    if (is_vectorized(state)) {
+        const FNLfloat SQRT3 = (FNLfloat)1.7320508075688772935274463415059;
+        const FNLfloat F2 = 0.5f * (SQRT3 - 1);
+
+        vint seed = iset(state.seed);
+        vfloat frequency = fset(state.frequency);
+        bool simplex = state.noise_type == FNL_NOISE_OPENSIMPLEX2;
+        for (; i + LANES <= count; i += LANES) {
+            vfloat x = fmul(fload(xs + i), frequency);
+            vfloat y = fmul(fload(ys + i), frequency);
+            if (simplex) {
+                vfloat t = fmul(fadd(x, y), fset(F2));
+                x = fadd(x, t);
+                y = fadd(y, t);
+                fstore(dst + i, simplex2d(seed, x, y));
+            } else {
+                fstore(dst + i, cellular2d(state, seed, x, y));
+            }
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = fnlGetNoise2D(&state, xs[i], ys[i]);
+    }
+}
+
+bool noise_batch::is_vectorized3d(const fnl_state& state) {
+#ifdef NOISE_BATCH_SIMD
+    return state.fractal_type == FNL_FRACTAL_NONE &&
+           state.noise_type == FNL_NOISE_OPENSIMPLEX2 &&
+           state.rotation_type_3d == FNL_ROTATION_NONE;
+#else
+    return false;
+#endif
+}
+
+void noise_batch::noise3d(
+    fnl_state& state,
+    const float* xs,
+    const float* ys,
+    const float* zs,
+    size_t count,
+    float* dst
+) {
+    size_t i = 0;
+#ifdef NOISE_BATCH_SIMD
+    if (is_vectorized3d(state)) {
+        const FNLfloat R3 = (FNLfloat)(2.0 / 3.0);
+
+        vint seed = iset(state.seed);
+        vfloat frequency = fset(state.frequency);
+        for (; i + LANES <= count; i += LANES) {
+            vfloat x = fmul(fload(xs + i), frequency);
+            vfloat y = fmul(fload(ys + i), frequency);
+            vfloat z = fmul(fload(zs + i), frequency);
+            vfloat r = fmul(fadd(fadd(x, y), z), fset(R3));
+            fstore(
+                dst + i, simplex3d(seed, fsub(r, x), fsub(r, y), fsub(r, z))
+            );
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        dst[i] = fnlGetNoise3D(&state, xs[i], ys[i], zs[i]);
+    }
+}
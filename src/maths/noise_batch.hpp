@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+
+struct fnl_state;
+
+namespace noise_batch {
+    /// @brief Evaluate fnlGetNoise2D for a batch of points.
+    /// OpenSimplex2 and cellular (euclidean squared) noise without fractal
+    /// are computed 4 points at a time when SSE2 or NEON is available,
+    /// giving the same results as the scalar version. Other settings fall
+    /// back to fnlGetNoise2D
+    /// @param state noise state
+    /// @param xs points x coordinates
+    /// @param ys points y coordinates
+    /// @param count number of points
+    /// @param dst output values
+    void noise2d(
+        fnl_state& state,
+        const float* xs,
+        const float* ys,
+        size_t count,
+        float* dst
+    );
+
+    /// @brief Check if noise2d uses the vectorized implementation for the
+    /// state settings
+    bool is_vectorized(const fnl_state& state);
+
+    /// @brief Evaluate fnlGetNoise3D for a batch of points.
+    /// OpenSimplex2 noise without fractal and 3D rotation is computed
+    /// 4 points at a time when SSE2 or NEON is available. Other settings
+    /// fall back to fnlGetNoise3D
+    /// @param state noise state
+    /// @param xs points x coordinates
+    /// @param ys points y coordinates
+    /// @param zs points z coordinates
+    /// @param count number of points
+    /// @param dst output values
+    void noise3d(
+        fnl_state& state,
+        const float* xs,
+        const float* ys,
+        const float* zs,
+        size_t count,
+        float* dst
+    );
+
+    /// @brief Check if noise3d uses the vectorized implementation for the
+    /// state settings
+    bool is_vectorized3d(const fnl_state& state);
+}
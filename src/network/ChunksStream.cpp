@@ -0,0 +1,453 @@
+#include "ChunksStream.hpp"
+
+#include "Network.hpp"
+#include "coders/byte_utils.hpp"
+#include "debug/Logger.hpp"
+#include "voxels/compressed_chunks.hpp"
+
+using namespace network;
+
+static debug::Logger logger("chunks-stream");
+
+namespace network {
+    struct ChunkEncodeJob {
+        glm::ivec2 key;
+        uint version;
+        uint baseVersion;
+        std::shared_ptr<const util::Buffer<ubyte>> voxelData;
+        std::shared_ptr<const util::Buffer<ubyte>> baseline;
+        BlocksMetadata metadata;
+        bool full;
+        bool delta;
+    };
+
+    struct ChunkEncodeResult {
+        std::shared_ptr<ChunkEncodeJob> job;
+        std::vector<ubyte> full;
+        std::vector<ubyte> delta;
+        bool failed = false;
+    };
+
+    struct ChunkDecodeJob {
+        glm::ivec2 key;
+        ubyte type;
+        uint version;
+        uint baseVersion;
+        std::vector<ubyte> payload;
+        std::shared_ptr<const util::Buffer<ubyte>> baseline;
+    };
+
+    struct ChunkDecodeResult {
+        std::shared_ptr<ChunkDecodeJob> job;
+        std::shared_ptr<util::Buffer<ubyte>> voxelData;
+        BlocksMetadata metadata;
+        std::string error;
+    };
+}
+
+static std::vector<ubyte> build_message(
+    const ChunkEncodeJob& job, ubyte type, const std::vector<ubyte>& payload
+) {
+    ByteBuilder builder(17 + payload.size());
+    builder.put(type);
+    builder.putInt32(job.key.x);
+    builder.putInt32(job.key.y);
+    builder.putInt32(job.version);
+    if (type == chunks_stream::DELTA) {
+        builder.putInt32(job.baseVersion);
+    }
+    builder.put(payload.data(), payload.size());
+    return builder.build();
+}
+
+class ChunkEncodeWorker : public util::Worker<
+                              std::shared_ptr<ChunkEncodeJob>,
+                              std::shared_ptr<ChunkEncodeResult>> {
+    util::Buffer<ubyte> rleBuffer;
+    util::Buffer<ubyte> xorBuffer;
+public:
+    ChunkEncodeWorker()
+        : rleBuffer(CHUNK_DATA_LEN * 2), xorBuffer(CHUNK_DATA_LEN) {
+    }
+
+    std::shared_ptr<ChunkEncodeResult> operator()(
+        const std::shared_ptr<ChunkEncodeJob>& job
+    ) override {
+        auto result = std::make_shared<ChunkEncodeResult>();
+        result->job = job;
+        try {
+            const ubyte* voxelData = job->voxelData->data();
+            if (job->full) {
+                result->full = build_message(
+                    *job,
+                    chunks_stream::FULL,
+                    compressed_chunks::encode(
+                        voxelData, job->metadata, rleBuffer
+                    )
+                );
+            }
+            if (job->delta) {
+                const ubyte* baseline = job->baseline->data();
+                for (size_t i = 0; i < CHUNK_DATA_LEN; i++) {
+                    xorBuffer[i] = voxelData[i] ^ baseline[i];
+                }
+                result->delta = build_message(
+                    *job,
+                    chunks_stream::DELTA,
+                    compressed_chunks::encode(
+                        xorBuffer.data(), job->metadata, rleBuffer
+                    )
+                );
+            }
+        } catch (const std::exception& err) {
+            logger.error() << "could not encode chunk " << job->key.x << ", "
+                           << job->key.y << ": " << err.what();
+            result->failed = true;
+        }
+        return result;
+    }
+};
+
+ChunksStreamServer::ChunksStreamServer(Network& network, int maxWorkers)
+    : network(network),
+      threadPool(
+          "chunks-stream-encoder",
+          []() { return std::make_shared<ChunkEncodeWorker>(); },
+          [this](std::shared_ptr<ChunkEncodeResult>& result) {
+              processResult(*result);
+          },
+          maxWorkers
+      ) {
+    threadPool.setStopOnFail(false);
+}
+
+ChunksStreamServer::~ChunksStreamServer() = default;
+
+void ChunksStreamServer::subscribe(
+    u64id_t connection, const std::shared_ptr<Chunk>& chunk
+) {
+    glm::ivec2 key(chunk->x, chunk->z);
+    auto& state = chunks[key];
+    state.chunk = chunk;
+    state.subscribers.try_emplace(connection, 0);
+    pending.insert(key);
+}
+
+void ChunksStreamServer::unsubscribe(u64id_t connection, int x, int z) {
+    glm::ivec2 key(x, z);
+    const auto& found = chunks.find(key);
+    if (found == chunks.end()) {
+        return;
+    }
+    auto& state = found->second;
+    state.subscribers.erase(connection);
+    if (state.subscribers.empty() && !state.inwork) {
+        chunks.erase(found);
+        pending.erase(key);
+    }
+}
+
+void ChunksStreamServer::unsubscribeAll(u64id_t connection) {
+    for (auto it = chunks.begin(); it != chunks.end();) {
+        auto& state = it->second;
+        state.subscribers.erase(connection);
+        if (state.subscribers.empty() && !state.inwork) {
+            pending.erase(it->first);
+            it = chunks.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ChunksStreamServer::markModified(const Chunk& chunk) {
+    glm::ivec2 key(chunk.x, chunk.z);
+    const auto& found = chunks.find(key);
+    if (found == chunks.end()) {
+        return;
+    }
+    found->second.dirty = true;
+    pending.insert(key);
+}
+
+void ChunksStreamServer::enqueue(const glm::ivec2& key, ChunkState& state) {
+    auto chunk = state.chunk.lock();
+    if (chunk == nullptr) {
+        return;
+    }
+    auto job = std::make_shared<ChunkEncodeJob>();
+    job->key = key;
+    job->baseVersion = state.version;
+    job->metadata = chunk->blocksMetadata;
+    if (state.dirty || state.baseline == nullptr) {
+        // voxel data snapshot is taken in the main thread
+        job->voxelData = std::make_shared<util::Buffer<ubyte>>(
+            chunk->encode(), CHUNK_DATA_LEN
+        );
+        state.revision = chunk->revision;
+        job->version = state.version + 1;
+        job->baseline = state.baseline;
+    } else {
+        // only new subscribers need the chunk
+        job->voxelData = state.baseline;
+        job->version = state.version;
+    }
+    job->full = state.baseline == nullptr;
+    job->delta = false;
+    for (const auto& [_, version] : state.subscribers) {
+        if (version == job->version) {
+            continue;
+        }
+        if (version == state.version && job->baseline) {
+            job->delta = true;
+        } else {
+            job->full = true;
+        }
+    }
+    state.dirty = false;
+    if (!job->full && !job->delta) {
+        return;
+    }
+    state.inwork = true;
+    threadPool.enqueueJob(std::move(job));
+}
+
+void ChunksStreamServer::processResult(ChunkEncodeResult& result) {
+    const auto& job = *result.job;
+    const auto& found = chunks.find(job.key);
+    if (found == chunks.end()) {
+        return;
+    }
+    auto& state = found->second;
+    state.inwork = false;
+    if (result.failed) {
+        return;
+    }
+    state.version = job.version;
+    state.baseline = job.voxelData;
+
+    for (auto it = state.subscribers.begin(); it != state.subscribers.end();) {
+        auto& [id, version] = *it;
+        auto connection = network.getConnection(id);
+        if (connection == nullptr ||
+            connection->getState() == ConnectionState::CLOSED) {
+            it = state.subscribers.erase(it);
+            continue;
+        }
+        if (version == job.version) {
+            // already up to date
+        } else if (version == job.baseVersion && !result.delta.empty()) {
+            connection->sendMessage(result.delta.data(), result.delta.size());
+            version = job.version;
+        } else if (!result.full.empty()) {
+            connection->sendMessage(result.full.data(), result.full.size());
+            version = job.version;
+        } else {
+            // subscribed while the chunk was being encoded
+            pending.insert(job.key);
+        }
+        ++it;
+    }
+    if (state.subscribers.empty()) {
+        pending.erase(job.key);
+        chunks.erase(found);
+    }
+}
+
+void ChunksStreamServer::update() {
+    for (auto it = chunks.begin(); it != chunks.end();) {
+        auto& [key, state] = *it;
+        if (state.inwork) {
+            ++it;
+            continue;
+        }
+        auto chunk = state.chunk.lock();
+        if (chunk == nullptr) {
+            // unloaded
+            pending.erase(key);
+            it = chunks.erase(it);
+            continue;
+        }
+        if (state.baseline && chunk->revision != state.revision) {
+            state.dirty = true;
+            pending.insert(key);
+        }
+        ++it;
+    }
+    for (auto it = pending.begin(); it != pending.end();) {
+        const auto& found = chunks.find(*it);
+        if (found == chunks.end()) {
+            it = pending.erase(it);
+            continue;
+        }
+        if (found->second.inwork) {
+            ++it;
+            continue;
+        }
+        enqueue(found->first, found->second);
+        it = pending.erase(it);
+    }
+    threadPool.update();
+}
+
+size_t ChunksStreamServer::getChunksCount() const {
+    return chunks.size();
+}
+
+class ChunkDecodeWorker : public util::Worker<
+                              std::shared_ptr<ChunkDecodeJob>,
+                              std::shared_ptr<ChunkDecodeResult>> {
+public:
+    std::shared_ptr<ChunkDecodeResult> operator()(
+        const std::shared_ptr<ChunkDecodeJob>& job
+    ) override {
+        auto result = std::make_shared<ChunkDecodeResult>();
+        result->job = job;
+        try {
+            auto voxelData = std::make_shared<util::Buffer<ubyte>>(
+                CHUNK_DATA_LEN
+            );
+            int flags = compressed_chunks::decode(
+                job->payload.data(),
+                job->payload.size(),
+                *voxelData,
+                result->metadata
+            );
+            if (!(flags & compressed_chunks::HAS_VOXELS)) {
+                throw std::runtime_error("voxel data expected");
+            }
+            if (job->type == chunks_stream::DELTA) {
+                ubyte* dst = voxelData->data();
+                const ubyte* baseline = job->baseline->data();
+                for (size_t i = 0; i < CHUNK_DATA_LEN; i++) {
+                    dst[i] ^= baseline[i];
+                }
+            }
+            result->voxelData = std::move(voxelData);
+        } catch (const std::exception& err) {
+            result->error = err.what();
+        }
+        return result;
+    }
+};
+
+ChunksStreamClient::ChunksStreamClient(
+    Network& network,
+    u64id_t connection,
+    consumer<StreamedChunk&> callback,
+    int maxWorkers,
+    size_t maxChunks
+)
+    : network(network),
+      connection(connection),
+      callback(std::move(callback)),
+      maxChunks(maxChunks),
+      threadPool(
+          "chunks-stream-decoder",
+          []() { return std::make_shared<ChunkDecodeWorker>(); },
+          [this](std::shared_ptr<ChunkDecodeResult>& result) {
+              processResult(*result);
+          },
+          maxWorkers
+      ) {
+    threadPool.setStopOnFail(false);
+}
+
+ChunksStreamClient::~ChunksStreamClient() = default;
+
+void ChunksStreamClient::forget(int x, int z) {
+    chunks.erase(glm::ivec2(x, z));
+}
+
+void ChunksStreamClient::dispatch(ChunkState& state) {
+    while (!state.pending.empty()) {
+        auto job = std::move(state.pending.front());
+        state.pending.pop_front();
+        if (job->type == chunks_stream::DELTA) {
+            if (state.baseline == nullptr ||
+                state.version != job->baseVersion) {
+                logger.warning()
+                    << "dropped delta for chunk " << job->key.x << ", "
+                    << job->key.y << " (version " << job->baseVersion
+                    << " is not available)";
+                continue;
+            }
+            job->baseline = state.baseline;
+        }
+        state.current = job;
+        threadPool.enqueueJob(std::move(job));
+        return;
+    }
+}
+
+void ChunksStreamClient::processResult(ChunkDecodeResult& result) {
+    const auto& job = result.job;
+    const auto& found = chunks.find(job->key);
+    if (found == chunks.end() || found->second.current != job) {
+        // forgotten while decoding
+        return;
+    }
+    auto& state = found->second;
+    state.current = nullptr;
+    if (result.error.empty()) {
+        state.version = job->version;
+        state.baseline = result.voxelData;
+
+        StreamedChunk chunk {
+            job->key.x,
+            job->key.y,
+            job->version,
+            result.voxelData->data(),
+            result.metadata};
+        callback(chunk);
+    } else {
+        logger.error() << "could not decode chunk " << job->key.x << ", "
+                       << job->key.y << ": " << result.error;
+        state.version = 0;
+        state.baseline = nullptr;
+    }
+    dispatch(state);
+}
+
+void ChunksStreamClient::update() {
+    if (auto socket = network.getConnection(connection)) {
+        while (socket->recvMessage(message)) {
+            ByteReader reader(message.data(), message.size());
+            auto job = std::make_shared<ChunkDecodeJob>();
+            job->type = reader.get();
+            if (job->type != chunks_stream::FULL &&
+                job->type != chunks_stream::DELTA) {
+                throw std::runtime_error("invalid chunk message type");
+            }
+            job->key.x = reader.getInt32();
+            job->key.y = reader.getInt32();
+            job->version = reader.getInt32();
+            if (job->type == chunks_stream::DELTA) {
+                job->baseVersion = reader.getInt32();
+            }
+            job->payload.assign(
+                reader.pointer(), reader.pointer() + reader.remaining()
+            );
+            auto found = chunks.find(job->key);
+            if (found == chunks.end()) {
+                if (chunks.size() >= maxChunks) {
+                    logger.warning()
+                        << "dropped chunk " << job->key.x << ", "
+                        << job->key.y << " (too many chunks streamed)";
+                    continue;
+                }
+                found = chunks.try_emplace(job->key).first;
+            }
+            auto& state = found->second;
+            state.pending.push_back(std::move(job));
+            if (state.current == nullptr) {
+                dispatch(state);
+            }
+        }
+    }
+    threadPool.update();
+}
+
+size_t ChunksStreamClient::getChunksCount() const {
+    return chunks.size();
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <glm/glm.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+#include "typedefs.hpp"
+#include "delegates.hpp"
+#include "util/Buffer.hpp"
+#include "util/ThreadPool.hpp"
+#include "voxels/Chunk.hpp"
+
+/// @brief Chunks streaming over framed connections (see network/framing.hpp).
+/// Each message contains a single chunk:
+/// - uint8 message type (FULL or DELTA)
+/// - int32 chunk x, int32 chunk z
+/// - uint32 chunk version
+/// - uint32 base version (DELTA only)
+/// - compressed_chunks payload. For DELTA voxel data is XOR-ed
+///   with voxel data of the base version
+/// Connection used for streaming should not be used for other messages.
+namespace network {
+    class Network;
+
+    namespace chunks_stream {
+        inline constexpr ubyte FULL = 1;
+        inline constexpr ubyte DELTA = 2;
+    }
+
+    struct ChunkEncodeJob;
+    struct ChunkEncodeResult;
+
+    /// @brief Sends subscribed chunks to connections. Chunks are encoded
+    /// in worker threads, modified chunks are sent as deltas to connections
+    /// that already have the previous version. Subscriptions to destroyed
+    /// chunks are removed
+    class ChunksStreamServer {
+        struct ChunkState {
+            std::weak_ptr<const Chunk> chunk;
+            uint version = 0;
+            /// @brief Chunk::revision of the last voxel data snapshot
+            uint revision = 0;
+            /// @brief Voxel data of the last sent version
+            std::shared_ptr<const util::Buffer<ubyte>> baseline;
+            /// @brief Connection id -> last chunk version sent to it
+            std::unordered_map<u64id_t, uint> subscribers;
+            bool dirty = false;
+            bool inwork = false;
+        };
+        Network& network;
+        std::unordered_map<glm::ivec2, ChunkState> chunks;
+        /// @brief Chunks to be encoded on next update
+        std::unordered_set<glm::ivec2> pending;
+        util::ThreadPool<
+            std::shared_ptr<ChunkEncodeJob>,
+            std::shared_ptr<ChunkEncodeResult>>
+            threadPool;
+
+        void enqueue(const glm::ivec2& key, ChunkState& state);
+        void processResult(ChunkEncodeResult& result);
+    public:
+        ChunksStreamServer(Network& network, int maxWorkers = 0);
+        ~ChunksStreamServer();
+
+        /// @brief Start sending chunk to the connection. Current chunk
+        /// state is sent on next update
+        void subscribe(u64id_t connection, const std::shared_ptr<Chunk>& chunk);
+
+        void unsubscribe(u64id_t connection, int x, int z);
+
+        /// @brief Stop sending any chunks to the connection
+        void unsubscribeAll(u64id_t connection);
+
+        /// @brief Send changes to subscribers on next update. Not required
+        /// for changes made with Chunk::setModifiedAndUnsaved
+        void markModified(const Chunk& chunk);
+
+        /// @brief Enqueue encoding of modified chunks and send encoded
+        /// ones. Should be called before Network::update
+        void update();
+
+        size_t getChunksCount() const;
+    };
+
+    /// @brief Chunk received by ChunksStreamClient
+    struct StreamedChunk {
+        int x;
+        int z;
+        uint version;
+        /// @brief Voxel data of size CHUNK_DATA_LEN (see Chunk::decode).
+        /// Block ids are not validated
+        const ubyte* voxelData;
+        BlocksMetadata& metadata;
+    };
+
+    struct ChunkDecodeJob;
+    struct ChunkDecodeResult;
+
+    /// @brief Receives chunks sent by ChunksStreamServer, decoding them
+    /// in worker threads. Callback is called in update().
+    /// Number of tracked chunks is limited, messages for new chunks
+    /// are dropped when the limit is reached until some are forgotten
+    class ChunksStreamClient {
+        struct ChunkState {
+            uint version = 0;
+            std::shared_ptr<const util::Buffer<ubyte>> baseline;
+            /// @brief Messages waiting for the previous one to be decoded
+            std::deque<std::shared_ptr<ChunkDecodeJob>> pending;
+            /// @brief Message being decoded
+            std::shared_ptr<ChunkDecodeJob> current;
+        };
+        Network& network;
+        u64id_t connection;
+        consumer<StreamedChunk&> callback;
+        size_t maxChunks;
+        std::unordered_map<glm::ivec2, ChunkState> chunks;
+        util::ThreadPool<
+            std::shared_ptr<ChunkDecodeJob>,
+            std::shared_ptr<ChunkDecodeResult>>
+            threadPool;
+        std::vector<ubyte> message;
+
+        void dispatch(ChunkState& state);
+        void processResult(ChunkDecodeResult& result);
+    public:
+        static inline constexpr size_t MAX_CHUNKS = 64 * 64;
+
+        ChunksStreamClient(
+            Network& network,
+            u64id_t connection,
+            consumer<StreamedChunk&> callback,
+            int maxWorkers = 0,
+            size_t maxChunks = MAX_CHUNKS
+        );
+        ~ChunksStreamClient();
+
+        /// @brief Forget chunk state. Next delta for the chunk is dropped
+        void forget(int x, int z);
+
+        /// @brief Read received messages and pass decoded chunks to
+        /// the callback. Should be called after Network::update
+        /// @throws std::runtime_error if message header is malformed
+        void update();
+
+        size_t getChunksCount() const;
+    };
+}
@@ -4,6 +4,8 @@
 
 #define NOMINMAX
 #include <curl/curl.h>
+#include <atomic>
+#include <chrono>
 #include <stdexcept>
 #include <limits>
 #include <queue>
@@ -21,11 +23,19 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#else
+#include <poll.h>
+#endif
 
 using SOCKET = int;
 #endif // _WIN32
 
 #include "debug/Logger.hpp"
+#include "framing.hpp"
+#include "util/RingBuffer.hpp"
 #include "util/stringutil.hpp"
 
 using namespace network;
@@ -232,6 +242,21 @@ public:
 static inline int closesocket(int descriptor) noexcept {
     return close(descriptor);
 }
+static inline void set_nonblocking(int descriptor) {
+    int flags = fcntl(descriptor, F_GETFL, 0);
+    fcntl(descriptor, F_SETFL, flags | O_NONBLOCK);
+}
+static inline bool would_block() noexcept {
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+static inline bool connect_in_progress() noexcept {
+    return errno == EINPROGRESS;
+}
+#ifndef __linux__
+static inline int pollsockets(pollfd* fds, size_t count, int timeout) noexcept {
+    return poll(fds, count, timeout);
+}
+#endif
 static inline std::runtime_error handle_socket_error(const std::string& message) {
     int err = errno;
     return std::runtime_error(
@@ -240,6 +265,19 @@ static inline std::runtime_error handle_socket_error(const std::string& message)
     );
 }
 #else
+static inline void set_nonblocking(SOCKET descriptor) {
+    u_long mode = 1;
+    ioctlsocket(descriptor, FIONBIO, &mode);
+}
+static inline bool would_block() noexcept {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+static inline bool connect_in_progress() noexcept {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+static inline int pollsockets(pollfd* fds, size_t count, int timeout) noexcept {
+    return WSAPoll(fds, count, timeout);
+}
 static inline std::runtime_error handle_socket_error(const std::string& message) {
     int errorCode = WSAGetLastError();
     wchar_t* s = nullptr;
@@ -279,9 +317,21 @@ static inline int recvsocket(
 static inline int sendsocket(
     int descriptor, const char* buf, size_t len, int flags
 ) noexcept {
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#endif
     return send(descriptor, buf, len, flags);
 }
 
+/// @brief Disable Nagle's algorithm. Small writes are coalesced
+/// by connections before sending
+static inline void set_nodelay(SOCKET descriptor) {
+    int opt = 1;
+    setsockopt(
+        descriptor, IPPROTO_TCP, TCP_NODELAY, (const char*)&opt, sizeof(opt)
+    );
+}
+
 static std::string to_string(const sockaddr_in& addr, bool port=true) {
     char ip[INET_ADDRSTRLEN];
     if (inet_ntop(AF_INET, &(addr.sin_addr), ip, INET_ADDRSTRLEN)) {
@@ -291,85 +341,414 @@ static std::string to_string(const sockaddr_in& addr, bool port=true) {
     return "";
 }
 
-class SocketConnection : public Connection {
+namespace network {
+    /// @brief Socket owner receiving readiness events from SocketEventLoop
+    class PollTarget {
+    public:
+        virtual ~PollTarget() {}
+
+        /// @brief Called from the I/O thread
+        virtual void onPollEvent(bool readable, bool writable, bool error) = 0;
+    };
+
+    /// @brief Single I/O thread multiplexing all non-blocking sockets.
+    /// Uses epoll on Linux and poll (WSAPoll) on other platforms.
+    class SocketEventLoop {
+        struct Entry {
+            std::weak_ptr<PollTarget> target;
+            bool writable;
+        };
+        std::unordered_map<SOCKET, Entry> targets;
+        std::mutex mutex;
+        std::atomic<bool> running = true;
+#ifdef __linux__
+        int epollDescriptor;
+        int wakeDescriptor;
+#endif
+        std::thread thread;
+
+        void dispatch(SOCKET descriptor, bool readable, bool writable, bool error) {
+            std::shared_ptr<PollTarget> target;
+            {
+                std::lock_guard lock(mutex);
+                const auto& found = targets.find(descriptor);
+                if (found == targets.end()) {
+                    return;
+                }
+                target = found->second.target.lock();
+            }
+            if (target == nullptr) {
+                return;
+            }
+            try {
+                target->onPollEvent(readable, writable, error);
+            } catch (const std::exception& err) {
+                logger.error() << err.what();
+            }
+        }
+
+        void run();
+    public:
+        SocketEventLoop();
+        ~SocketEventLoop();
+
+        /// @brief Register socket to receive read (and optionally write)
+        /// readiness events
+        void add(
+            SOCKET descriptor,
+            std::weak_ptr<PollTarget> target,
+            bool writable = false
+        );
+
+        /// @brief Enable or disable write readiness events for the socket
+        void setWritable(SOCKET descriptor, bool writable);
+
+        /// @brief Unregister socket. Must be called before closing it
+        void remove(SOCKET descriptor);
+    };
+}
+
+#ifdef __linux__
+
+static inline uint32_t epoll_events(bool writable) noexcept {
+    return EPOLLIN | (writable ? static_cast<uint32_t>(EPOLLOUT) : 0U);
+}
+
+SocketEventLoop::SocketEventLoop() {
+    epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    if (epollDescriptor == -1) {
+        throw handle_socket_error("epoll_create1(...) error");
+    }
+    wakeDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeDescriptor == -1) {
+        auto error = handle_socket_error("eventfd(...) error");
+        ::close(epollDescriptor);
+        throw error;
+    }
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.fd = wakeDescriptor;
+    epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, wakeDescriptor, &event);
+
+    thread = std::thread([this]() { run(); });
+}
+
+SocketEventLoop::~SocketEventLoop() {
+    running = false;
+    uint64_t value = 1;
+    if (write(wakeDescriptor, &value, sizeof(value)) == -1) {
+        logger.error() << "could not wake up I/O thread";
+    }
+    thread.join();
+    ::close(wakeDescriptor);
+    ::close(epollDescriptor);
+}
+
+void SocketEventLoop::run() {
+    constexpr int MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+    while (running) {
+        int count = epoll_wait(epollDescriptor, events, MAX_EVENTS, -1);
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            logger.error() << handle_socket_error("epoll_wait(...) error").what();
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            const auto& event = events[i];
+            if (event.data.fd == wakeDescriptor) {
+                uint64_t value;
+                while (read(wakeDescriptor, &value, sizeof(value)) > 0);
+                continue;
+            }
+            dispatch(
+                event.data.fd,
+                event.events & EPOLLIN,
+                event.events & EPOLLOUT,
+                event.events & (EPOLLERR | EPOLLHUP)
+            );
+        }
+    }
+}
+
+void SocketEventLoop::add(
+    SOCKET descriptor, std::weak_ptr<PollTarget> target, bool writable
+) {
+    std::lock_guard lock(mutex);
+    epoll_event event {};
+    event.events = epoll_events(writable);
+    event.data.fd = descriptor;
+    if (epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, descriptor, &event) == -1) {
+        throw handle_socket_error("epoll_ctl(...) error");
+    }
+    targets[descriptor] = Entry {std::move(target), writable};
+}
+
+void SocketEventLoop::setWritable(SOCKET descriptor, bool writable) {
+    std::lock_guard lock(mutex);
+    const auto& found = targets.find(descriptor);
+    if (found == targets.end() || found->second.writable == writable) {
+        return;
+    }
+    found->second.writable = writable;
+    epoll_event event {};
+    event.events = epoll_events(writable);
+    event.data.fd = descriptor;
+    epoll_ctl(epollDescriptor, EPOLL_CTL_MOD, descriptor, &event);
+}
+
+void SocketEventLoop::remove(SOCKET descriptor) {
+    std::lock_guard lock(mutex);
+    if (targets.erase(descriptor)) {
+        epoll_ctl(epollDescriptor, EPOLL_CTL_DEL, descriptor, nullptr);
+    }
+}
+
+#else
+
+SocketEventLoop::SocketEventLoop() {
+    thread = std::thread([this]() { run(); });
+}
+
+SocketEventLoop::~SocketEventLoop() {
+    running = false;
+    thread.join();
+}
+
+void SocketEventLoop::run() {
+    // poll has no wake-up descriptor, so timeout limits the delay before
+    // changes in registered sockets are applied
+    constexpr int POLL_TIMEOUT_MS = 20;
+    std::vector<pollfd> descriptors;
+    while (running) {
+        descriptors.clear();
+        {
+            std::lock_guard lock(mutex);
+            for (const auto& [descriptor, entry] : targets) {
+                pollfd pfd {};
+                pfd.fd = descriptor;
+                pfd.events = POLLIN | (entry.writable ? POLLOUT : 0);
+                descriptors.push_back(pfd);
+            }
+        }
+        if (descriptors.empty()) {
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(POLL_TIMEOUT_MS)
+            );
+            continue;
+        }
+        int count = pollsockets(
+            descriptors.data(), descriptors.size(), POLL_TIMEOUT_MS
+        );
+        if (count < 0) {
+            logger.error() << handle_socket_error("poll(...) error").what();
+            continue;
+        }
+        for (const auto& pfd : descriptors) {
+            if (pfd.revents == 0) {
+                continue;
+            }
+            dispatch(
+                pfd.fd,
+                pfd.revents & POLLIN,
+                pfd.revents & POLLOUT,
+                pfd.revents & (POLLERR | POLLHUP | POLLNVAL)
+            );
+        }
+    }
+}
+
+void SocketEventLoop::add(
+    SOCKET descriptor, std::weak_ptr<PollTarget> target, bool writable
+) {
+    std::lock_guard lock(mutex);
+    targets[descriptor] = Entry {std::move(target), writable};
+}
+
+void SocketEventLoop::setWritable(SOCKET descriptor, bool writable) {
+    std::lock_guard lock(mutex);
+    const auto& found = targets.find(descriptor);
+    if (found != targets.end()) {
+        found->second.writable = writable;
+    }
+}
+
+void SocketEventLoop::remove(SOCKET descriptor) {
+    std::lock_guard lock(mutex);
+    targets.erase(descriptor);
+}
+
+#endif // __linux__
+
+class SocketConnection : public Connection,
+                         public PollTarget,
+                         public std::enable_shared_from_this<SocketConnection> {
+    static inline constexpr size_t INITIAL_BUFFER_SIZE = 16'384;
+    /// @brief Minimal contiguous space in readBatch passed to recv
+    static inline constexpr size_t MIN_RECV_SIZE = 4'096;
+
+    SocketEventLoop& loop;
     SOCKET descriptor;
     sockaddr_in addr;
-    size_t totalUpload = 0;
-    size_t totalDownload = 0;
-    ConnectionState state = ConnectionState::INITIAL;
-    std::unique_ptr<std::thread> thread = nullptr;
-    std::vector<char> readBatch;
-    util::Buffer<char> buffer;
+    std::atomic<size_t> totalUpload = 0;
+    std::atomic<size_t> totalDownload = 0;
+    std::atomic<ConnectionState> state = ConnectionState::INITIAL;
+    runnable connectCallback = nullptr;
+    bool closeRequested = false;
+    util::RingBuffer<char> readBatch;
+    util::RingBuffer<char> writeBatch;
     std::mutex mutex;
 
-    void connectSocket() {
-        state = ConnectionState::CONNECTING;
-        logger.info() << "connecting to " << to_string(addr);
-        int res = connectsocket(descriptor, (const sockaddr*)&addr, sizeof(sockaddr_in));
-        if (res < 0) {
-            auto error = handle_socket_error("Connect failed");
-            closesocket(descriptor);
-            state = ConnectionState::CLOSED;
-            logger.error() << error.what();
+    /// @brief Unregister and close socket. Requires mutex to be locked
+    void closeSocket() {
+        if (state == ConnectionState::CLOSED) {
             return;
         }
-        logger.info() << "connected to " << to_string(addr);
-        state = ConnectionState::CONNECTED;
+        loop.remove(descriptor);
+        shutdown(descriptor, 2);
+        closesocket(descriptor);
+        state = ConnectionState::CLOSED;
     }
-public:
-    SocketConnection(SOCKET descriptor, sockaddr_in addr)
-        : descriptor(descriptor), addr(std::move(addr)), buffer(16'384) {}
 
-    ~SocketConnection() {
-        if (state != ConnectionState::CLOSED) {
-            shutdown(descriptor, 2);
+    void finishConnect() {
+        int error = 0;
+        socklen_t length = sizeof(error);
+        if (getsockopt(
+                descriptor, SOL_SOCKET, SO_ERROR, (char*)&error, &length
+            ) ||
+            error) {
+            std::lock_guard lock(mutex);
+            closeSocket();
+            logger.error() << "could not connect to " << to_string(addr)
+                           << " [error=" << error << "]";
+            return;
         }
-        if (thread) {
-            thread->join();
+        logger.info() << "connected to " << to_string(addr);
+        set_nodelay(descriptor);
+        {
+            std::lock_guard lock(mutex);
+            state = ConnectionState::CONNECTED;
+            loop.setWritable(descriptor, !writeBatch.empty());
+        }
+        if (connectCallback) {
+            connectCallback();
         }
     }
 
-    void startListen() {
+    /// @brief Read all available data directly into readBatch.
+    /// Requires mutex to be locked
+    void receive() {
         while (state == ConnectionState::CONNECTED) {
-            int size = recvsocket(descriptor, buffer.data(), buffer.size());
+            char* dst = readBatch.prepare(MIN_RECV_SIZE);
+            size_t capacity = readBatch.writable();
+            int size = recvsocket(descriptor, dst, capacity);
             if (size == 0) {
                 logger.info() << "closed connection with " << to_string(addr);
-                closesocket(descriptor);
-                state = ConnectionState::CLOSED;
+                closeSocket();
                 break;
             } else if (size < 0) {
+                if (would_block()) {
+                    break;
+                }
                 logger.warning() << "an error ocurred while receiving from "
-                            << to_string(addr);
+                                 << to_string(addr);
                 auto error = handle_socket_error("recv(...) error");
-                closesocket(descriptor);
-                state = ConnectionState::CLOSED;
+                closeSocket();
                 logger.error() << error.what();
                 break;
             }
-            {
-                std::lock_guard lock(mutex);
-                for (size_t i = 0; i < size; i++) {
-                    readBatch.emplace_back(buffer[i]);
+            readBatch.commit(size);
+            totalDownload += size;
+            if (logger.isEnabled(debug::LogLevel::debug)) {
+                logger.debug() << "read " << size << " bytes from "
+                               << to_string(addr);
+            }
+            if (static_cast<size_t>(size) < capacity) {
+                break;
+            }
+        }
+    }
+
+    /// @brief Send queued data. Requires mutex to be locked
+    void sendQueued() {
+        while (!writeBatch.empty() && state == ConnectionState::CONNECTED) {
+            int len = sendsocket(
+                descriptor, writeBatch.front(), writeBatch.readable(), 0
+            );
+            if (len < 0) {
+                if (would_block()) {
+                    break;
                 }
-                totalDownload += size;
+                auto error = handle_socket_error("send(...) error");
+                closeSocket();
+                logger.error() << error.what();
+                break;
+            }
+            writeBatch.skip(len);
+            totalUpload += len;
+        }
+        if (writeBatch.empty() && closeRequested) {
+            closeSocket();
+        }
+        if (state == ConnectionState::CONNECTED) {
+            loop.setWritable(descriptor, !writeBatch.empty());
+        }
+    }
+public:
+    SocketConnection(SocketEventLoop& loop, SOCKET descriptor, sockaddr_in addr)
+        : loop(loop),
+          descriptor(descriptor),
+          addr(std::move(addr)),
+          readBatch(INITIAL_BUFFER_SIZE) {}
+
+    ~SocketConnection() {
+        std::lock_guard lock(mutex);
+        closeSocket();
+    }
+
+    void onPollEvent(bool readable, bool writable, bool error) override {
+        if (state == ConnectionState::CONNECTING) {
+            if (writable || error) {
+                finishConnect();
             }
-            logger.debug() << "read " << size << " bytes from " << to_string(addr);
+            return;
+        }
+        std::lock_guard lock(mutex);
+        if (readable || error) {
+            receive();
+        }
+        if (writable) {
+            sendQueued();
         }
     }
 
     void startClient() {
+        set_nonblocking(descriptor);
+        set_nodelay(descriptor);
         state = ConnectionState::CONNECTED;
-        thread = std::make_unique<std::thread>([this]() { startListen();});
+        loop.add(descriptor, weak_from_this());
     }
 
     void connect(runnable callback) override {
-        thread = std::make_unique<std::thread>([this, callback]() {
-            connectSocket();
-            if (state == ConnectionState::CONNECTED) {
-                callback();
-            }
-            startListen();
-        });
+        state = ConnectionState::CONNECTING;
+        logger.info() << "connecting to " << to_string(addr);
+        connectCallback = std::move(callback);
+
+        set_nonblocking(descriptor);
+        int res = connectsocket(
+            descriptor, (const sockaddr*)&addr, sizeof(sockaddr_in)
+        );
+        if (res < 0 && !connect_in_progress()) {
+            auto error = handle_socket_error("Connect failed");
+            closesocket(descriptor);
+            state = ConnectionState::CLOSED;
+            logger.error() << error.what();
+            return;
+        }
+        // completion (even immediate) is reported as write readiness
+        loop.add(descriptor, weak_from_this(), true);
     }
 
     int recv(char* buffer, size_t length) override {
@@ -378,27 +757,57 @@ public:
         if (state != ConnectionState::CONNECTED && readBatch.empty()) {
             return -1;
         }
-        int size = std::min(readBatch.size(), length);
-        std::memcpy(buffer, readBatch.data(), size);
-        readBatch.erase(readBatch.begin(), readBatch.begin() + size);
-        return size;
+        return readBatch.read(buffer, length);
     }
 
     int send(const char* buffer, size_t length) override {
-        if (state == ConnectionState::CLOSED) {
+        std::lock_guard lock(mutex);
+
+        if (state == ConnectionState::CLOSED || closeRequested) {
             return 0;
         }
-        int len = sendsocket(descriptor, buffer, length, 0);
-        if (len == -1) {
-            int err = errno;
-            close();
-            throw std::runtime_error(
-                "Send failed [errno=" + std::to_string(err) + "]: "
-                 + std::string(strerror(err))
-            );
+        writeBatch.write(buffer, length);
+        if (state == ConnectionState::CONNECTED && writeBatch.size() == length) {
+            sendQueued();
+        }
+        return length;
+    }
+
+    void sendMessage(
+        const ubyte* data, size_t length, compression::Method method
+    ) override {
+        std::lock_guard lock(mutex);
+
+        if (state == ConnectionState::CLOSED || closeRequested) {
+            return;
+        }
+        framing::write_message(writeBatch, data, length, method);
+    }
+
+    bool recvMessage(std::vector<ubyte>& dst) override {
+        std::unique_lock lock(mutex);
+        while (true) {
+            try {
+                return framing::read_message(readBatch, dst);
+            } catch (const framing::stream_error& err) {
+                lock.unlock();
+                logger.error() << "malformed stream from " << to_string(addr)
+                               << ": " << err.what();
+                close(true);
+                throw;
+            } catch (const std::runtime_error& err) {
+                // the frame is skipped, the next one is still readable
+                logger.error() << "dropped malformed message from "
+                               << to_string(addr) << ": " << err.what();
+            }
+        }
+    }
+
+    void flush() override {
+        std::lock_guard lock(mutex);
+        if (state == ConnectionState::CONNECTED && !writeBatch.empty()) {
+            sendQueued();
         }
-        totalUpload += len;
-        return len;
     }
 
     int available() override {
@@ -407,31 +816,24 @@ public:
     }
 
     void close(bool discardAll=false) override {
-        {
-            std::lock_guard lock(mutex);
-            readBatch.clear();
+        std::lock_guard lock(mutex);
+        readBatch.clear();
 
-            if (state != ConnectionState::CLOSED) {
-                shutdown(descriptor, 2);
-                closesocket(descriptor);
-            }
-        }
-        if (thread) {
-            thread->join();
-            thread = nullptr;
+        if (!discardAll && !writeBatch.empty() &&
+            state == ConnectionState::CONNECTED) {
+            // closed by I/O thread when queued data is sent
+            closeRequested = true;
+            return;
         }
+        closeSocket();
     }
 
     size_t pullUpload() override {
-        size_t size = totalUpload;
-        totalUpload = 0;
-        return size;
+        return totalUpload.exchange(0);
     }
 
     size_t pullDownload() override {
-        size_t size = totalDownload;
-        totalDownload = 0;
-        return size;
+        return totalDownload.exchange(0);
     }
 
     int getPort() const override {
@@ -443,7 +845,10 @@ public:
     }
 
     static std::shared_ptr<SocketConnection> connect(
-        const std::string& address, int port, runnable callback
+        SocketEventLoop& loop,
+        const std::string& address,
+        int port,
+        runnable callback
     ) {
         addrinfo hints {};
 
@@ -466,7 +871,9 @@ public:
         if (descriptor == -1) {
             throw std::runtime_error("Could not create socket");
         }
-        auto socket = std::make_shared<SocketConnection>(descriptor, std::move(serverAddress));
+        auto socket = std::make_shared<SocketConnection>(
+            loop, descriptor, std::move(serverAddress)
+        );
         socket->connect(std::move(callback));
         return socket;
     }
@@ -476,54 +883,81 @@ public:
     }
 };
 
-class SocketTcpSServer : public TcpServer {
+class SocketTcpSServer : public TcpServer,
+                         public PollTarget,
+                         public std::enable_shared_from_this<SocketTcpSServer> {
     u64id_t id;
     Network* network;
+    SocketEventLoop& loop;
     SOCKET descriptor;
     std::vector<u64id_t> clients;
     std::mutex clientsMutex;
-    bool open = true;
-    std::unique_ptr<std::thread> thread = nullptr;
+    std::atomic<bool> open = true;
+    ConnectCallback handler;
     int port;
+
+    void acceptClients() {
+        while (open) {
+            socklen_t addrlen = sizeof(sockaddr_in);
+            SOCKET clientDescriptor;
+            sockaddr_in address;
+            if ((clientDescriptor = accept(descriptor, (sockaddr*)&address, &addrlen)) == -1) {
+                if (!would_block()) {
+                    logger.error() << handle_socket_error("accept(...) error").what();
+                }
+                break;
+            }
+            logger.info() << "client connected: " << to_string(address);
+            auto socket = std::make_shared<SocketConnection>(
+                loop, clientDescriptor, address
+            );
+            socket->startClient();
+            u64id_t id = network->addConnection(socket);
+            {
+                std::lock_guard lock(clientsMutex);
+                clients.push_back(id);
+            }
+            handler(this->id, id);
+        }
+    }
 public:
-    SocketTcpSServer(u64id_t id, Network* network, SOCKET descriptor, int port)
-    : id(id), network(network), descriptor(descriptor), port(port) {}
+    SocketTcpSServer(
+        u64id_t id,
+        Network* network,
+        SocketEventLoop& loop,
+        SOCKET descriptor,
+        int port
+    )
+        : id(id),
+          network(network),
+          loop(loop),
+          descriptor(descriptor),
+          port(port) {
+    }
 
     ~SocketTcpSServer() {
         closeSocket();
     }
 
+    void onPollEvent(bool readable, bool writable, bool error) override {
+        if (readable) {
+            acceptClients();
+        }
+    }
+
     void startListen(ConnectCallback handler) override {
-        thread = std::make_unique<std::thread>([this, handler]() {
-            while (open) {
-                logger.info() << "listening for connections";
-                if (listen(descriptor, 2) < 0) {
-                    close();
-                    break;
-                }
-                socklen_t addrlen = sizeof(sockaddr_in);
-                SOCKET clientDescriptor;
-                sockaddr_in address;
-                logger.info() << "accepting clients";
-                if ((clientDescriptor = accept(descriptor, (sockaddr*)&address, &addrlen)) == -1) {
-                    close();
-                    break;
-                }
-                logger.info() << "client connected: " << to_string(address);
-                auto socket = std::make_shared<SocketConnection>(
-                    clientDescriptor, address
-                );
-                socket->startClient();
-                u64id_t id = network->addConnection(socket);
-                {
-                    std::lock_guard lock(clientsMutex);
-                    clients.push_back(id);
-                }
-                handler(this->id, id);
-            }
-        });
+        this->handler = std::move(handler);
+        logger.info() << "listening for connections";
+        if (listen(descriptor, SOMAXCONN) < 0) {
+            auto error = handle_socket_error("listen(...) error");
+            closesocket(descriptor);
+            open = false;
+            throw error;
+        }
+        set_nonblocking(descriptor);
+        loop.add(descriptor, weak_from_this());
     }
-    
+
     void closeSocket() {
         if (!open) {
             return;
@@ -538,18 +972,17 @@ public:
                     client->close();
                 }
             }
+            clients.clear();
         }
-        clients.clear();
-
+        loop.remove(descriptor);
         shutdown(descriptor, 2);
         closesocket(descriptor);
-        thread->join();
     }
 
     void close() override {
         closeSocket();
     }
-    
+
     bool isOpen() override {
         return open;
     }
@@ -559,7 +992,11 @@ public:
     }
 
     static std::shared_ptr<SocketTcpSServer> openServer(
-        u64id_t id, Network* network, int port, ConnectCallback handler
+        u64id_t id,
+        Network* network,
+        SocketEventLoop& loop,
+        int port,
+        ConnectCallback handler
     ) {
         SOCKET descriptor = socket(
             AF_INET, SOCK_STREAM, 0
@@ -584,9 +1021,15 @@ public:
             closesocket(descriptor);
             throw std::runtime_error("could not bind port "+std::to_string(port));
         }
+        // port 0 means any free port chosen by the system
+        socklen_t addrlen = sizeof(address);
+        if (getsockname(descriptor, (sockaddr*)&address, &addrlen) == 0) {
+            port = htons(address.sin_port);
+        }
         logger.info() << "opened server at port " << port;
-        auto server =
-            std::make_shared<SocketTcpSServer>(id, network, descriptor, port);
+        auto server = std::make_shared<SocketTcpSServer>(
+            id, network, loop, descriptor, port
+        );
         server->startListen(std::move(handler));
         return server;
     }
@@ -635,20 +1078,29 @@ TcpServer* Network::getServer(u64id_t id) const {
     return found->second.get();
 }
 
+SocketEventLoop& Network::requireEventLoop() {
+    if (eventLoop == nullptr) {
+        eventLoop = std::make_unique<SocketEventLoop>();
+    }
+    return *eventLoop;
+}
+
 u64id_t Network::connect(const std::string& address, int port, consumer<u64id_t> callback) {
     std::lock_guard lock(connectionsMutex);
     
     u64id_t id = nextConnection++;
-    auto socket = SocketConnection::connect(address, port, [id, callback]() {
-        callback(id);
-    });
+    auto socket = SocketConnection::connect(
+        requireEventLoop(), address, port, [id, callback]() { callback(id); }
+    );
     connections[id] = std::move(socket);
     return id;
 }
 
 u64id_t Network::openServer(int port, ConnectCallback handler) {
     u64id_t id = nextServer++;
-    auto server = SocketTcpSServer::openServer(id, this, port, handler);
+    auto server = SocketTcpSServer::openServer(
+        id, this, requireEventLoop(), port, handler
+    );
     servers[id] = std::move(server);
     return id;
 }
@@ -677,6 +1129,7 @@ void Network::update() {
         auto socketiter = connections.begin();
         while (socketiter != connections.end()) {
             auto socket = socketiter->second.get();
+            socket->flush();
             totalDownload += socket->pullDownload();
             totalUpload += socket->pullUpload();
             if (socket->available() == 0 && 
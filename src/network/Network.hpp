@@ -6,6 +6,7 @@
 
 #include "typedefs.hpp"
 #include "settings.hpp"
+#include "coders/compression.hpp"
 #include "util/Buffer.hpp"
 #include "delegates.hpp"
 
@@ -53,6 +54,26 @@ namespace network {
         virtual void close(bool discardAll=false) = 0;
         virtual int available() = 0;
 
+        /// @brief Queue length-prefixed message (see network/framing.hpp).
+        /// Queued messages are sent together on flush(), called by
+        /// Network::update once per tick
+        /// @param method NONE or GZIP
+        virtual void sendMessage(
+            const ubyte* data,
+            size_t length,
+            compression::Method method = compression::Method::NONE
+        ) = 0;
+
+        /// @brief Pop next complete message sent with sendMessage
+        /// @return false if no complete message received yet
+        /// Messages with malformed payload are dropped
+        /// @throws std::runtime_error if frame boundaries are lost.
+        /// The connection is closed in this case
+        virtual bool recvMessage(std::vector<ubyte>& dst) = 0;
+
+        /// @brief Send all queued data
+        virtual void flush() = 0;
+
         virtual size_t pullUpload() = 0;
         virtual size_t pullDownload() = 0;
 
@@ -71,8 +92,13 @@ namespace network {
         virtual int getPort() const = 0;
     };
 
+    class SocketEventLoop;
+
     class Network {
         std::unique_ptr<Requests> requests;
+        /// @brief I/O thread shared by all sockets, created on first use.
+        /// Declared before connections and servers to outlive them
+        std::unique_ptr<SocketEventLoop> eventLoop;
 
         std::unordered_map<u64id_t, std::shared_ptr<Connection>> connections;
         std::mutex connectionsMutex {};
@@ -83,6 +109,8 @@ namespace network {
 
         size_t totalDownload = 0;
         size_t totalUpload = 0;
+
+        SocketEventLoop& requireEventLoop();
     public:
         Network(std::unique_ptr<Requests> requests);
         ~Network();
@@ -0,0 +1,131 @@
+#include "framing.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "coders/gzip.hpp"
+#include "util/data_io.hpp"
+
+using namespace network;
+
+static constexpr size_t SIZE_FIELD = 4;
+static constexpr size_t METHOD_FIELD = 1;
+
+static void write_frame(
+    util::RingBuffer<char>& dst,
+    const ubyte* data,
+    size_t length,
+    compression::Method method,
+    size_t srclen
+) {
+    bool compressed = method != compression::Method::NONE;
+    ubyte header[SIZE_FIELD + METHOD_FIELD + SIZE_FIELD];
+    size_t headerSize = SIZE_FIELD + METHOD_FIELD + compressed * SIZE_FIELD;
+
+    dataio::write_int32_big(headerSize - SIZE_FIELD + length, header, 0);
+    header[SIZE_FIELD] = static_cast<ubyte>(method);
+    if (compressed) {
+        dataio::write_int32_big(srclen, header, SIZE_FIELD + METHOD_FIELD);
+    }
+    dst.write(reinterpret_cast<const char*>(header), headerSize);
+    dst.write(reinterpret_cast<const char*>(data), length);
+}
+
+void framing::write_message(
+    util::RingBuffer<char>& dst,
+    const ubyte* data,
+    size_t length,
+    compression::Method method
+) {
+    if (length > MAX_MESSAGE_SIZE) {
+        throw std::invalid_argument(
+            "message is too big (" + std::to_string(length) + " bytes)"
+        );
+    }
+    switch (method) {
+        case compression::Method::NONE:
+            break;
+        case compression::Method::GZIP: {
+            size_t compressedLength;
+            auto compressed =
+                compression::compress(data, length, compressedLength, method);
+            if (compressedLength < length) {
+                write_frame(
+                    dst, compressed.get(), compressedLength, method, length
+                );
+                return;
+            }
+            break;
+        }
+        default:
+            throw std::invalid_argument(
+                "unsupported message compression method"
+            );
+    }
+    write_frame(dst, data, length, compression::Method::NONE, length);
+}
+
+bool framing::read_message(
+    util::RingBuffer<char>& src, std::vector<ubyte>& dst
+) {
+    ubyte header[SIZE_FIELD + METHOD_FIELD + SIZE_FIELD];
+    if (src.peek(reinterpret_cast<char*>(header), SIZE_FIELD + METHOD_FIELD) <
+        SIZE_FIELD + METHOD_FIELD) {
+        return false;
+    }
+    size_t frameSize = static_cast<uint32_t>(dataio::read_int32_big(header, 0));
+    auto method = static_cast<compression::Method>(header[SIZE_FIELD]);
+    if (frameSize > MAX_MESSAGE_SIZE + METHOD_FIELD + SIZE_FIELD) {
+        // frame boundaries are lost
+        src.clear();
+        throw stream_error(
+            "message is too big (" + std::to_string(frameSize) + " bytes)"
+        );
+    }
+    if (src.size() < SIZE_FIELD + frameSize) {
+        return false;
+    }
+    switch (method) {
+        case compression::Method::NONE: {
+            if (frameSize < METHOD_FIELD) {
+                src.skip(SIZE_FIELD + frameSize);
+                throw std::runtime_error("invalid message frame");
+            }
+            src.skip(SIZE_FIELD + METHOD_FIELD);
+            dst.resize(frameSize - METHOD_FIELD);
+            src.read(reinterpret_cast<char*>(dst.data()), dst.size());
+            return true;
+        }
+        case compression::Method::GZIP: {
+            if (frameSize < METHOD_FIELD + SIZE_FIELD) {
+                src.skip(SIZE_FIELD + frameSize);
+                throw std::runtime_error("invalid message frame");
+            }
+            src.read(reinterpret_cast<char*>(header), sizeof(header));
+            size_t srclen = static_cast<uint32_t>(
+                dataio::read_int32_big(header, SIZE_FIELD + METHOD_FIELD)
+            );
+            std::vector<ubyte> compressed(
+                frameSize - METHOD_FIELD - SIZE_FIELD
+            );
+            src.read(reinterpret_cast<char*>(compressed.data()), compressed.size());
+            // the frame is consumed at this point
+            if (srclen > MAX_MESSAGE_SIZE) {
+                throw std::runtime_error(
+                    "message is too big (" + std::to_string(srclen) + " bytes)"
+                );
+            }
+            dst = gzip::decompress(compressed.data(), compressed.size(), srclen);
+            if (dst.size() != srclen) {
+                throw std::runtime_error(
+                    "expected decompressed size " + std::to_string(srclen) +
+                    " got " + std::to_string(dst.size())
+                );
+            }
+            return true;
+        }
+        default:
+            src.skip(SIZE_FIELD + frameSize);
+            throw std::runtime_error("unsupported message compression method");
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include "typedefs.hpp"
+#include "coders/compression.hpp"
+#include "util/RingBuffer.hpp"
+
+/// @brief Length-prefixed messages used by Connection::sendMessage and
+/// Connection::recvMessage. Frame layout:
+/// - int32 (big-endian) size of the rest of the frame
+/// - uint8 compression method
+/// - int32 (big-endian) payload size before compression (if compressed)
+/// - payload
+namespace network::framing {
+    inline constexpr size_t MAX_MESSAGE_SIZE = 64 * 1024 * 1024;
+
+    /// @brief Frame boundaries are lost, so the rest of the stream
+    /// can not be read
+    class stream_error : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    /// @brief Append message frame to the end of the buffer
+    /// @param method NONE or GZIP. Payload is sent uncompressed
+    /// if compression does not reduce its size
+    /// @throws std::invalid_argument if the message is too big or
+    /// compression method is not supported
+    void write_message(
+        util::RingBuffer<char>& dst,
+        const ubyte* data,
+        size_t length,
+        compression::Method method
+    );
+
+    /// @brief Pop the first complete message frame from the buffer
+    /// @param dst decompressed message payload
+    /// @return false if the buffer does not contain complete frame yet
+    /// @throws std::runtime_error if frame is malformed. A complete frame
+    /// with invalid payload is removed from the buffer
+    /// @throws stream_error if the frame size is invalid. The whole buffer
+    /// is cleared
+    bool read_message(util::RingBuffer<char>& src, std::vector<ubyte>& dst);
+}
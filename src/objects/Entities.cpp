@@ -1,6 +1,7 @@
 #define VC_ENABLE_REFLECTION
 #include "Entities.hpp"
 
+#include <algorithm>
 #include <glm/ext/matrix_transform.hpp>
 #include <sstream>
 
@@ -405,18 +406,45 @@ void Entities::clean() {
     }
 }
 
+/// @brief Diff sorted overlaps with ones collected since the last sensors
+/// tick, emitting batched exit and enter events. Buffers are swapped, so
+/// no allocations happen once capacity is reached
+static void update_sensor_overlaps(Sensor& sensor, size_t index) {
+    auto& prev = sensor.prevEntered;
+    auto& next = sensor.nextEntered;
+    std::sort(next.begin(), next.end());
+    next.erase(std::unique(next.begin(), next.end()), next.end());
+
+    size_t pi = 0;
+    size_t ni = 0;
+    while (pi < prev.size()) {
+        if (ni == next.size() || prev[pi] < next[ni]) {
+            sensor.exitCallback(sensor.entity, index, prev[pi++]);
+        } else {
+            pi += prev[pi] == next[ni];
+            ni++;
+        }
+    }
+    pi = 0;
+    ni = 0;
+    while (ni < next.size()) {
+        if (pi == prev.size() || next[ni] < prev[pi]) {
+            sensor.enterCallback(sensor.entity, index, next[ni++]);
+        } else {
+            ni += next[ni] == prev[pi];
+            pi++;
+        }
+    }
+    std::swap(prev, next);
+    next.clear();
+}
+
 void Entities::updateSensors(
     Rigidbody& body, const Transform& tsf, std::vector<Sensor*>& sensors
 ) {
     for (size_t i = 0; i < body.sensors.size(); i++) {
         auto& sensor = body.sensors[i];
-        for (auto oid : sensor.prevEntered) {
-            if (sensor.nextEntered.find(oid) == sensor.nextEntered.end()) {
-                sensor.exitCallback(sensor.entity, i, oid);
-            }
-        }
-        sensor.prevEntered = sensor.nextEntered;
-        sensor.nextEntered.clear();
+        update_sensor_overlaps(sensor, i);
 
         switch (sensor.type) {
             case SensorType::AABB:
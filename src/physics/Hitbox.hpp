@@ -4,8 +4,8 @@
 #include "typedefs.hpp"
 #include "util/EnumMetadata.hpp"
 
-#include <set>
 #include <string>
+#include <vector>
 #include <functional>
 #include <glm/glm.hpp>
 
@@ -31,8 +31,11 @@ struct Sensor {
     entityid_t entity;
     SensorParams params;
     SensorParams calculated;
-    std::set<entityid_t> prevEntered;
-    std::set<entityid_t> nextEntered;
+    /// @brief Sorted entities overlapped at the last sensors tick
+    std::vector<entityid_t> prevEntered;
+    /// @brief Entities overlapped since the last sensors tick
+    /// (unsorted, may contain duplicates)
+    std::vector<entityid_t> nextEntered;
     sensorcallback enterCallback;
     sensorcallback exitCallback;
 };
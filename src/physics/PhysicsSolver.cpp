@@ -110,10 +110,10 @@ void PhysicsSolver::step(
                 break;
         }
         if (triggered) {
-            if (sensor.prevEntered.find(entity) == sensor.prevEntered.end()) {
-                sensor.enterCallback(sensor.entity, sensor.index, entity);
+            auto& entered = sensor.nextEntered;
+            if (entered.empty() || entered.back() != entity) {
+                entered.push_back(entity);
             }
-            sensor.nextEntered.insert(entity);
         }
     }
 }
@@ -90,6 +90,8 @@ struct DebugSettings {
     FlagSetting generatorTestMode {false};
     /// @brief Write lights cache
     FlagSetting doWriteLights {true};
+    /// @brief Write generator prototypes (biomes, heightmaps) cache
+    FlagSetting doWritePrototypes {true};
 };
 
 struct UiSettings {
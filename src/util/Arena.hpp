@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace util {
+    /// @brief Monotonic allocator. Memory is released all at once when
+    /// the arena is destroyed. Not thread-safe
+    class Arena {
+        static constexpr size_t FIRST_BLOCK_SIZE = 4096;
+        static constexpr size_t MAX_BLOCK_SIZE = 65536;
+
+        std::vector<std::unique_ptr<std::byte[]>> blocks;
+        std::byte* pos = nullptr;
+        size_t left = 0;
+        size_t nextBlockSize = FIRST_BLOCK_SIZE;
+        size_t allocated = 0;
+    public:
+        Arena() = default;
+        Arena(const Arena&) = delete;
+
+        void* allocate(size_t size, size_t alignment) {
+            void* ptr = pos;
+            if (pos == nullptr || !std::align(alignment, size, ptr, left)) {
+                size_t blockSize = std::max(nextBlockSize, size + alignment);
+                nextBlockSize = std::min(nextBlockSize * 2, MAX_BLOCK_SIZE);
+                blocks.emplace_back(std::make_unique<std::byte[]>(blockSize));
+                ptr = blocks.back().get();
+                left = blockSize;
+                std::align(alignment, size, ptr, left);
+            }
+            pos = static_cast<std::byte*>(ptr) + size;
+            left -= size;
+            allocated += size;
+            return ptr;
+        }
+
+        /// @return total size of allocations made
+        size_t getAllocated() const {
+            return allocated;
+        }
+    };
+
+    /// @brief Standard allocator using the arena. Keeps the arena alive,
+    /// so containers and shared pointers created with it (std::allocate_shared)
+    /// may outlive the code that created the arena
+    template <class T>
+    class ArenaAllocator {
+        template <class U>
+        friend class ArenaAllocator;
+
+        std::shared_ptr<Arena> arena;
+    public:
+        using value_type = T;
+
+        ArenaAllocator(std::shared_ptr<Arena> arena) : arena(std::move(arena)) {
+        }
+
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {
+        }
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, size_t) noexcept {
+        }
+
+        template <class U>
+        bool operator==(const ArenaAllocator<U>& other) const noexcept {
+            return arena == other.arena;
+        }
+
+        template <class U>
+        bool operator!=(const ArenaAllocator<U>& other) const noexcept {
+            return arena != other.arena;
+        }
+    };
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+namespace util {
+    /// @brief Bounded lock-free queue for multiple producers and a single
+    /// consumer. Each slot has a sequence number telling whether it is
+    /// ready to be written or read, so producers only contend on the
+    /// head index
+    /// @tparam T default constructible and move assignable elements type
+    template <typename T>
+    class MPSCRing {
+        struct Slot {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+        std::unique_ptr<Slot[]> slots;
+        size_t mask;
+        alignas(64) std::atomic<size_t> head {0};
+        alignas(64) size_t tail = 0;
+    public:
+        /// @param capacity max number of elements, must be a power of two
+        explicit MPSCRing(size_t capacity)
+            : slots(std::make_unique<Slot[]>(capacity)), mask(capacity - 1) {
+            if (capacity == 0 || (capacity & mask)) {
+                throw std::invalid_argument("capacity must be a power of two");
+            }
+            for (size_t i = 0; i < capacity; i++) {
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MPSCRing(const MPSCRing&) = delete;
+
+        /// @brief Push element. May be called from any thread
+        /// @return false if the queue is full (value is not moved)
+        bool tryPush(T&& value) {
+            size_t pos = head.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true) {
+                slot = &slots[pos & mask];
+                size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(sequence) -
+                            static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (head.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed
+                        )) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = head.load(std::memory_order_relaxed);
+                }
+            }
+            slot->value = std::move(value);
+            slot->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief Pop element. Must be called from the consumer thread only
+        /// @return false if the queue is empty
+        bool tryPop(T& dst) {
+            Slot& slot = slots[tail & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != tail + 1) {
+                return false;
+            }
+            dst = std::move(slot.value);
+            slot.sequence.store(tail + mask + 1, std::memory_order_release);
+            tail++;
+            return true;
+        }
+
+        size_t capacity() const {
+            return mask + 1;
+        }
+    };
+}
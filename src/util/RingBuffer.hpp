@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace util {
+    /// @brief Growable FIFO queue over a power-of-two sized circular buffer.
+    /// Gives direct access to contiguous regions, so producers may write
+    /// into the buffer and consumers may read from it without copying
+    /// through temporary buffers
+    /// @tparam T trivially copyable elements type
+    template <typename T>
+    class RingBuffer {
+        std::unique_ptr<T[]> buffer;
+        size_t capacity = 0;
+        size_t head = 0;
+        size_t length = 0;
+
+        /// @brief Move stored elements to the start of a buffer
+        /// with at least given capacity
+        void realign(size_t minCapacity) {
+            size_t newCapacity = std::max<size_t>(capacity, 16);
+            while (newCapacity < minCapacity) {
+                newCapacity *= 2;
+            }
+            if (newCapacity == capacity) {
+                std::rotate(
+                    buffer.get(), buffer.get() + head, buffer.get() + capacity
+                );
+            } else {
+                auto newBuffer = std::make_unique<T[]>(newCapacity);
+                peek(newBuffer.get(), length);
+                buffer = std::move(newBuffer);
+                capacity = newCapacity;
+            }
+            head = 0;
+        }
+    public:
+        RingBuffer() = default;
+
+        RingBuffer(size_t capacity) {
+            realign(capacity);
+        }
+
+        RingBuffer(RingBuffer&&) = default;
+        RingBuffer& operator=(RingBuffer&&) = default;
+
+        size_t size() const {
+            return length;
+        }
+
+        bool empty() const {
+            return length == 0;
+        }
+
+        size_t getCapacity() const {
+            return capacity;
+        }
+
+        void clear() {
+            head = 0;
+            length = 0;
+        }
+
+        /// @brief Append elements to the end of the queue
+        void write(const T* src, size_t count) {
+            while (count) {
+                T* dst = prepare(1);
+                size_t n = std::min(count, writable());
+                std::memcpy(dst, src, n * sizeof(T));
+                commit(n);
+                src += n;
+                count -= n;
+            }
+        }
+
+        /// @brief Copy elements from the front of the queue without removing
+        /// @param offset number of elements to skip
+        /// @return number of copied elements
+        size_t peek(T* dst, size_t count, size_t offset = 0) const {
+            if (offset >= length) {
+                return 0;
+            }
+            count = std::min(count, length - offset);
+            size_t start = (head + offset) & (capacity - 1);
+            size_t first = std::min(count, capacity - start);
+            std::memcpy(dst, buffer.get() + start, first * sizeof(T));
+            std::memcpy(dst + first, buffer.get(), (count - first) * sizeof(T));
+            return count;
+        }
+
+        /// @brief Move elements from the front of the queue
+        /// @return number of moved elements
+        size_t read(T* dst, size_t count) {
+            count = peek(dst, count);
+            skip(count);
+            return count;
+        }
+
+        /// @brief Remove elements from the front of the queue
+        void skip(size_t count) {
+            count = std::min(count, length);
+            length -= count;
+            head = length ? ((head + count) & (capacity - 1)) : 0;
+        }
+
+        /// @brief Get first contiguous region of stored elements
+        /// (see readable())
+        const T* front() const {
+            return buffer.get() + head;
+        }
+
+        /// @brief Get size of the first contiguous region of stored elements
+        size_t readable() const {
+            return std::min(length, capacity - head);
+        }
+
+        /// @brief Get contiguous free space at the end of the queue,
+        /// growing or realigning the buffer if needed
+        /// @param minimum minimal required number of elements
+        /// @return pointer to free space of writable() elements
+        /// @attention pointer becomes invalid after any write operation
+        T* prepare(size_t minimum) {
+            if (writable() < minimum) {
+                realign(length + minimum);
+            }
+            return buffer.get() + ((head + length) & (capacity - 1));
+        }
+
+        /// @brief Get size of contiguous free space at the end of the queue
+        size_t writable() const {
+            if (capacity == 0) {
+                return 0;
+            }
+            size_t tail = head + length;
+            if (tail >= capacity) {
+                return capacity - length;
+            }
+            return capacity - tail;
+        }
+
+        /// @brief Append elements written to the space given by prepare(...)
+        void commit(size_t count) {
+            length += count;
+        }
+    };
+}
@@ -160,6 +160,42 @@ namespace util {
             std::memcpy(buffer.data(), src + sizeof(Tindex), buffer.size());
         }
 
+        /// @brief Deserialize untrusted data. Every entry must lie inside
+        /// the data, entries must be sorted by index and the last one must
+        /// end exactly at the end of the data
+        /// @throws std::runtime_error if data is invalid (heap is unchanged)
+        void deserializeChecked(const ubyte* src, size_t size) {
+            if (size < sizeof(Tindex)) {
+                throw std::runtime_error("heap data is too short");
+            }
+            auto count = read_int_le<Tindex>(src);
+            const ubyte* entries = src + sizeof(Tindex);
+            size_t length = size - sizeof(Tindex);
+            size_t offset = 0;
+            Tindex prevIndex = 0;
+            for (size_t i = 0; i < count; i++) {
+                if (length - offset < sizeof(Tindex) + sizeof(Tsize)) {
+                    throw std::runtime_error("heap entry header out of bounds");
+                }
+                auto index = read_int_le<Tindex>(entries + offset);
+                if (i > 0 && index <= prevIndex) {
+                    throw std::runtime_error("heap entries are not sorted");
+                }
+                prevIndex = index;
+                offset += sizeof(Tindex);
+                auto entrySize = read_int_le<Tsize>(entries + offset);
+                offset += sizeof(Tsize);
+                if (length - offset < entrySize) {
+                    throw std::runtime_error("heap entry out of bounds");
+                }
+                offset += entrySize;
+            }
+            if (offset != length) {
+                throw std::runtime_error("heap data size mismatch");
+            }
+            deserialize(src, size);
+        }
+
         struct const_iterator {
         private:
             const std::vector<uint8_t>& buffer;
@@ -1,13 +1,36 @@
 #include "command_line.hpp"
 
+#include <fstream>
 #include <iostream>
 
+#include "debug/binary_log.hpp"
 #include "io/engine_paths.hpp"
 #include "util/ArgsReader.hpp"
 #include "engine/Engine.hpp"
 
 namespace EngineFilesystem = std::filesystem;
 
+static debug::LogLevel parse_log_level(const std::string& name) {
+    if (name == "debug") {
+        return debug::LogLevel::debug;
+    } else if (name == "info") {
+        return debug::LogLevel::info;
+    } else if (name == "warning") {
+        return debug::LogLevel::warning;
+    } else if (name == "error") {
+        return debug::LogLevel::error;
+    }
+    throw std::runtime_error("unknown log level " + name);
+}
+
+static void decode_log(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("could not open " + filename);
+    }
+    debug::binary_log::decode(file, std::cout);
+}
+
 /** Perform read keywords in Engine. */
 static bool perform_keyword(
     util::ArgsReader& reader, const std::string& keyword, CoreParameters& params
@@ -29,6 +52,12 @@ static bool perform_keyword(
         std::cout << " --headless - run in headless mode\n";
         std::cout << " --test <path> - test script file\n";
         std::cout << " --script <path> - main script file\n";
+        std::cout << " --log-level <level> - min log level "
+                     "(debug, info, warning, error)\n";
+        std::cout << " --log-binary - write log file in binary format\n";
+        std::cout << " --decode-log <path> - print binary log file as text\n";
+        std::cout << " --pregen <world> <x> <z> <width> <depth> - generate "
+                     "area of chunks in headless mode and quit\n";
         std::cout << std::endl;
         return false;
     } else if (keyword == "--version") {
@@ -44,6 +73,19 @@ static bool perform_keyword(
         auto token = reader.next();
         params.testMode = false;
         params.scriptFile = token;
+    } else if (keyword == "--log-level") {
+        debug::Logger::setDefaultLevel(parse_log_level(reader.next()));
+    } else if (keyword == "--log-binary") {
+        params.binaryLog = true;
+    } else if (keyword == "--decode-log") {
+        decode_log(reader.next());
+        return false;
+    } else if (keyword == "--pregen") {
+        params.headless = true;
+        params.pregenWorld = reader.next();
+        for (int& value : params.pregenArea) {
+            value = std::stoi(reader.next());
+        }
     } else {
         throw std::runtime_error("unknown argument " + keyword);
     }
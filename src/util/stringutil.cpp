@@ -7,6 +7,15 @@
 #include <sstream>
 #include <stdexcept>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define STRINGUTIL_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define STRINGUTIL_NEON
+#endif
+
 std::string util::escape(std::string_view s, bool escapeUnicode) {
     std::stringstream ss;
     ss << '"';
@@ -611,3 +620,53 @@ std::pair<std::string, std::string> util::split_at(
         std::string(view.substr(0, idx)), std::string(view.substr(idx + 1))
     );
 }
+
+size_t util::find_any_of(std::string_view s, char a, char b, char c) {
+    const char* data = s.data();
+    size_t length = s.length();
+    size_t i = 0;
+#if defined(STRINGUTIL_SSE2)
+    const __m128i va = _mm_set1_epi8(a);
+    const __m128i vb = _mm_set1_epi8(b);
+    const __m128i vc = _mm_set1_epi8(c);
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i eq = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)),
+            _mm_cmpeq_epi8(chunk, vc)
+        );
+        int mask = _mm_movemask_epi8(eq);
+        if (mask) {
+            int index = 0;
+            while (!(mask & 1)) {
+                mask >>= 1;
+                index++;
+            }
+            return i + index;
+        }
+    }
+#elif defined(STRINGUTIL_NEON)
+    const uint8x16_t va = vdupq_n_u8(static_cast<uint8_t>(a));
+    const uint8x16_t vb = vdupq_n_u8(static_cast<uint8_t>(b));
+    const uint8x16_t vc = vdupq_n_u8(static_cast<uint8_t>(c));
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t chunk =
+            vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        uint8x16_t eq = vorrq_u8(
+            vorrq_u8(vceqq_u8(chunk, va), vceqq_u8(chunk, vb)),
+            vceqq_u8(chunk, vc)
+        );
+        if (vmaxvq_u8(eq)) {
+            break;
+        }
+    }
+#endif
+    for (; i < length; i++) {
+        char next = data[i];
+        if (next == a || next == b || next == c) {
+            return i;
+        }
+    }
+    return length;
+}
@@ -116,6 +116,11 @@ namespace util {
 
     std::pair<std::string, std::string> split_at(std::string_view view, char c);
 
+    /// @brief Find first occurrence of any of three characters,
+    /// scanning 16 bytes at once with SSE2 or NEON where available
+    /// @return index of the character or s.length() if not found
+    size_t find_any_of(std::string_view s, char a, char b, char c);
+
     template <typename CharT>
     std::vector<std::basic_string<CharT>> split_by_n(
         const std::basic_string<CharT>& str, size_t n
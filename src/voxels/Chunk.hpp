@@ -38,6 +38,8 @@ public:
         bool entities : 1;
         bool blocksData : 1;
     } flags {};
+    /// @brief Incremented on each setModifiedAndUnsaved call
+    uint revision = 0;
 
     /// @brief Block inventories map where key is index of block in voxels array
     ChunkInventoriesMap inventories;
@@ -49,7 +51,7 @@ public:
     /// @brief Refresh `bottom` and `top` values
     void updateHeights();
 
-    // unused
+    /// @brief Copy voxels and lights (flags and inventories are not copied)
     std::unique_ptr<Chunk> clone() const;
 
     /// @brief Creates new block inventory given size
@@ -66,6 +68,7 @@ public:
     inline void setModifiedAndUnsaved() {
         flags.modified = true;
         flags.unsaved = true;
+        revision++;
     }
 
     /// @brief Encode chunk to bytes array of size CHUNK_DATA_LEN
@@ -33,7 +33,9 @@ Chunks::Chunks(
       areaMap(w, d) {
     areaMap.setCenter(ox - w / 2, oz - d / 2);
     areaMap.setOutCallback([this](int, int, const auto& chunk) {
-        this->events->trigger(LevelEventType::CHUNK_HIDDEN, chunk.get());
+        if (this->events) {
+            this->events->trigger(LevelEventType::CHUNK_HIDDEN, chunk.get());
+        }
     });
 }
 
@@ -6,8 +6,7 @@
 #include "world/files/WorldFiles.hpp"
 #include "content/Content.hpp"
 
-inline constexpr int HAS_VOXELS = 0x1;
-inline constexpr int HAS_METADATA = 0x2;
+using namespace compressed_chunks;
 
 std::vector<ubyte> compressed_chunks::encode(
     const ubyte* data,
@@ -40,13 +39,53 @@ std::vector<ubyte> compressed_chunks::encode(const Chunk& chunk) {
     return encode(data.get(), chunk.blocksMetadata, rleBuffer);
 }
 
+static size_t read_size(ByteReader& reader) {
+    size_t size = static_cast<uint32_t>(reader.getInt32());
+    if (size > reader.remaining()) {
+        throw std::runtime_error("buffer underflow");
+    }
+    return size;
+}
+
 static void read_voxel_data(ByteReader& reader, util::Buffer<ubyte>& dst) {
-    size_t gzipCompressedSize = reader.getInt32();
+    size_t gzipCompressedSize = read_size(reader);
         
-    auto rleData = gzip::decompress(reader.pointer(), gzipCompressedSize);
+    // extrle::encode16 output never exceeds CHUNK_DATA_LEN * 2
+    auto rleData = gzip::decompress(
+        reader.pointer(), gzipCompressedSize, CHUNK_DATA_LEN * 2
+    );
     reader.skip(gzipCompressedSize);
 
-    extrle::decode16(rleData.data(), rleData.size(), dst.data());
+    size_t length = extrle::decode16(
+        rleData.data(), rleData.size(), dst.data(), dst.size()
+    );
+    if (length != CHUNK_DATA_LEN) {
+        throw std::runtime_error("invalid chunk data length");
+    }
+}
+
+int compressed_chunks::decode(
+    const ubyte* src,
+    size_t size,
+    util::Buffer<ubyte>& voxelData,
+    BlocksMetadata& metadata
+) {
+    ByteReader reader(src, size);
+
+    ubyte flags = reader.get();
+    reader.skip(1); // reserved byte
+    if (flags & HAS_VOXELS) {
+        read_voxel_data(reader, voxelData);
+    }
+    if (flags & HAS_METADATA) {
+        size_t metadataSize = read_size(reader);
+        if (metadataSize > reader.remaining()) {
+            throw std::runtime_error("invalid blocks metadata");
+        }
+        metadata.deserializeChecked(reader.pointer(), metadataSize);
+        reader.skip(metadataSize);
+    }
+    return flags;
 }
 
 void compressed_chunks::decode(
@@ -77,8 +116,13 @@ void compressed_chunks::decode(
         chunk.updateHeights();
     }
     if (flags & HAS_METADATA) {
-        size_t metadataSize = reader.getInt32();
-        chunk.blocksMetadata.deserialize(reader.pointer(), metadataSize);
+        size_t metadataSize = read_size(reader);
+        if (metadataSize > reader.remaining()) {
+            throw std::runtime_error("invalid blocks metadata");
+        }
+        chunk.blocksMetadata.deserializeChecked(
+            reader.pointer(), metadataSize
+        );
         reader.skip(metadataSize);
     }
     chunk.setModifiedAndUnsaved();
@@ -99,7 +143,7 @@ void compressed_chunks::save(
         );
     }
     if (flags & HAS_METADATA) {
-        size_t metadataSize = reader.getInt32();
+        size_t metadataSize = read_size(reader);
         regions.put(
             x,
             z,
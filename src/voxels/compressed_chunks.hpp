@@ -10,12 +10,30 @@ class ContentIndices;
 class WorldRegions;
 
 namespace compressed_chunks {
+    inline constexpr int HAS_VOXELS = 0x1;
+    inline constexpr int HAS_METADATA = 0x2;
+
+    /// @brief Thread-safe encoder
+    /// @param voxelData chunk data of size CHUNK_DATA_LEN (see Chunk::encode)
+    /// @param rleBuffer temporary buffer of size CHUNK_DATA_LEN * 2
     std::vector<ubyte> encode(
         const ubyte* voxelData,
         const BlocksMetadata& metadata,
         util::Buffer<ubyte>& rleBuffer
     );
     std::vector<ubyte> encode(const Chunk& chunk);
+
+    /// @brief Thread-safe decoder validating data sizes and blocks metadata
+    /// entries, so may be used with data received from network
+    /// @param voxelData destination buffer of size CHUNK_DATA_LEN
+    /// @return flags (HAS_VOXELS, HAS_METADATA)
+    /// @throws std::runtime_error if data is malformed
+    int decode(
+        const ubyte* src,
+        size_t size,
+        util::Buffer<ubyte>& voxelData,
+        BlocksMetadata& metadata
+    );
     void decode(
         Chunk& chunk,
         const ubyte* src,
@@ -47,6 +47,7 @@ WorldFiles::WorldFiles(const io::path& directory, const DebugSettings& settings)
     doWriteLights = settings.doWriteLights.get();
     regions.generatorTestMode = generatorTestMode;
     regions.doWriteLights = doWriteLights;
+    regions.doWritePrototypes = settings.doWritePrototypes.get();
 }
 
 WorldFiles::~WorldFiles() = default;
@@ -7,6 +7,7 @@
 #include "debug/Logger.hpp"
 #include "coders/json.hpp"
 #include "coders/byte_utils.hpp"
+#include "coders/gzip.hpp"
 #include "coders/rle.hpp"
 #include "coders/binary_json.hpp"
 #include "items/Inventory.hpp"
@@ -75,6 +76,10 @@ WorldRegions::WorldRegions(const io::path& directory) : directory(directory) {
 
     auto& blocksData = layers[REGION_LAYER_BLOCKS_DATA];
     blocksData.folder = directory / "blocksdata";
+
+    auto& prototypes = layers[REGION_LAYER_PROTOTYPES];
+    prototypes.folder = directory / "prototypes";
+    prototypes.compression = compression::Method::GZIP;
 }
 
 WorldRegions::~WorldRegions() = default;
@@ -121,11 +126,15 @@ static std::unique_ptr<ubyte[]> write_inventories(
     const ChunkInventoriesMap& inventories, uint32_t& datasize
 ) {
     ByteBuilder builder;
+    // reused for all inventories
+    ByteBuilder document;
     builder.putInt32(inventories.size());
     for (auto& entry : inventories) {
         builder.putInt32(entry.first);
         auto map = entry.second->serialize();
-        auto bytes = json::to_binary(map, true);
+        document.clear();
+        json::to_binary(document, map);
+        auto bytes = gzip::compress(document.data(), document.size());
         builder.putInt32(bytes.size());
         builder.put(bytes.data(), bytes.size());
     }
@@ -195,9 +204,7 @@ void WorldRegions::put(Chunk* chunk, std::vector<ubyte> entitiesData) {
     // Writing entities
     if (!entitiesData.empty()) {
         auto data = std::make_unique<ubyte[]>(entitiesData.size());
-        for (size_t i = 0; i < entitiesData.size(); i++) {
-            data[i] = entitiesData[i];
-        }
+        std::memcpy(data.get(), entitiesData.data(), entitiesData.size());
         put(chunk->x,
             chunk->z,
             REGION_LAYER_ENTITIES,
@@ -264,6 +271,31 @@ BlocksMetadata WorldRegions::getBlocksData(int x, int z) {
     return heap;
 }
 
+util::Buffer<ubyte> WorldRegions::loadPrototype(int x, int z) {
+    if (generatorTestMode || !doWritePrototypes) {
+        return nullptr;
+    }
+    uint32_t size;
+    uint32_t srcSize;
+    auto& layer = layers[REGION_LAYER_PROTOTYPES];
+    auto* bytes = layer.getData(x, z, size, srcSize);
+    if (bytes == nullptr) {
+        return nullptr;
+    }
+    auto data = compression::decompress(
+        bytes, size, srcSize, layer.compression
+    );
+    return util::Buffer<ubyte>(std::move(data), srcSize);
+}
+
+void WorldRegions::storePrototype(int x, int z, util::Buffer<ubyte> data) {
+    if (generatorTestMode || !doWritePrototypes) {
+        return;
+    }
+    size_t size = data.size();
+    put(x, z, REGION_LAYER_PROTOTYPES, data.release(), size);
+}
+
 void WorldRegions::processInventories(int x, int z, const InventoryProc& func) {
     processRegion(x, z, REGION_LAYER_INVENTORIES,
     [=](std::unique_ptr<ubyte[]> data, uint32_t* size) {
@@ -14,6 +14,7 @@
 #include "coders/compression.hpp"
 #include "io/io.hpp"
 #include "world_regions_fwd.hpp"
+#include "world/generator/PrototypesStorage.hpp"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/hash.hpp>
@@ -173,7 +174,7 @@ struct RegionsLayer {
     );
 };
 
-class WorldRegions {
+class WorldRegions : public PrototypesStorage {
     /// @brief World directory
     io::path directory;
 
@@ -181,6 +182,7 @@ class WorldRegions {
 public:
     bool generatorTestMode = false;
     bool doWriteLights = true;
+    bool doWritePrototypes = true;
 
     WorldRegions(const io::path& directory);
     WorldRegions(const WorldRegions&) = delete;
@@ -216,6 +218,13 @@ public:
     ChunkInventoriesMap fetchInventories(int x, int z);
 
     BlocksMetadata getBlocksData(int x, int z);
+
+    /// @brief Get cached generator prototype for chunk at x,z
+    /// @return encoded prototype or nullptr
+    util::Buffer<ubyte> loadPrototype(int x, int z) override;
+
+    /// @brief Put generator prototype to the prototypes cache layer
+    void storePrototype(int x, int z, util::Buffer<ubyte> data) override;
     
     /// @brief Load saved entities data for chunk
     /// @param x chunk.x
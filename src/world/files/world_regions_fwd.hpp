@@ -8,6 +8,7 @@ enum RegionLayerIndex : uint {
     REGION_LAYER_INVENTORIES,
     REGION_LAYER_ENTITIES,
     REGION_LAYER_BLOCKS_DATA,
+    REGION_LAYER_PROTOTYPES,
     
     REGION_LAYERS_COUNT
 };
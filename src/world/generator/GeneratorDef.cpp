@@ -15,6 +15,17 @@ GeneratorDef::GeneratorDef(std::string name)
 }
 
 void GeneratorDef::prepare(const Content* content) {
+    if (density.enabled) {
+        density.rt.id = content->blocks.require(density.block).rt.id;
+    }
+    for (auto& structure : structures) {
+        // pre-calculate rotated structure variants
+        auto& fragments = structure->fragments;
+        fragments[0]->prepare(*content);
+        for (int i = 1; i < fragments.size(); i++) {
+            fragments[i] = fragments[i - 1]->rotated(*content);
+        }
+    }
     for (auto& biome : biomes) {
         for (auto& layer : biome.groundLayers.layers) {
             layer.rt.id = content->blocks.require(layer.block).rt.id;
@@ -128,6 +128,14 @@ public:
 
     virtual void initialize(uint64_t seed) = 0;
 
+    /// @brief Create not initialized script instance with isolated state
+    /// loading the same generator scripts. Instance may be used in another
+    /// thread concurrently with this one
+    /// @return nullptr if concurrent instances are not supported
+    virtual std::unique_ptr<GeneratorScript> createWorker() const {
+        return nullptr;
+    }
+
     /// @brief Generate a heightmap with values in range 0..1
     /// @param offset position of the heightmap in the world
     /// @param size size of the heightmap
@@ -191,6 +199,39 @@ struct VoxelStructure {
     );
 };
 
+/// @brief 3D density field carving generated ground (caves, overhangs).
+/// Noise is sampled at low resolution and trilinearly interpolated
+struct DensityCarving {
+    /// @brief Octave frequency multiplier is 1 << octave index
+    static constexpr uint MAX_OCTAVES = 16;
+
+    /// @brief Carving is enabled if generator has density section
+    bool enabled = false;
+    /// @brief Block placed to carved space
+    std::string block = "core:air";
+    /// @brief Horizontal blocks per noise sample
+    /// (chunk width and depth must be multiple of it)
+    uint bpd = 4;
+    /// @brief Vertical blocks per noise sample
+    uint verticalBpd = 8;
+    /// @brief Noise frequency of the first octave
+    float frequency = 0.02f;
+    /// @brief Number of noise octaves (1..MAX_OCTAVES)
+    uint octaves = 2;
+    /// @brief Voxels with density (-1..1) greater than threshold are carved
+    float threshold = 0.5f;
+    /// @brief Lowest carved blocks level
+    uint minHeight = 1;
+    /// @brief Highest carved blocks level
+    uint maxHeight = 255;
+    /// @brief Number of surface blocks that are never carved
+    uint surfaceDepth = 0;
+
+    struct {
+        blockid_t id;
+    } rt;
+};
+
 /// @brief Generator information
 struct GeneratorDef {
     /// @brief Generator full name - packid:name
@@ -199,6 +240,8 @@ struct GeneratorDef {
     std::string caption;
 
     std::unique_ptr<GeneratorScript> script;
+    /// @brief CRC32 of the main generator script source, 0 if no script
+    uint32_t scriptHash = 0;
 
     /// @brief Sea level (top of seaLayers)
     uint seaLevel = 0;
@@ -222,9 +265,17 @@ struct GeneratorDef {
     /// structures placement triggered
     uint wideStructsChunksRadius = 3;
 
+    /// @brief Width of square block of chunks biome parameter maps and
+    /// heightmaps are generated for by a single script call. 1 - disabled.
+    /// Script functions must depend on the world position only
+    uint batchChunks = 1;
+
     /// @brief Indices of biome parameter maps passed to generate_heightmap
     std::vector<uint8_t> heightmapInputs;
 
+    /// @brief Native 3D carving stage applied to the ground
+    DensityCarving density;
+
     std::unordered_map<std::string, size_t> structuresIndices;
     std::vector<std::unique_ptr<VoxelStructure>> structures;
     std::vector<Biome> biomes;
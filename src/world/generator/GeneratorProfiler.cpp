@@ -0,0 +1,97 @@
+#include "GeneratorProfiler.hpp"
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+static const char* STAGE_NAMES[GENERATOR_STAGES_COUNT] {
+    "wide-structures",
+    "biomes",
+    "heightmap",
+    "structures",
+    "land",
+    "density",
+    "placements",
+    "plants",
+};
+
+GeneratorStageStats WorldGenProfile::total() const {
+    GeneratorStageStats total {};
+    for (const auto& stats : stages) {
+        total.calls += stats.calls;
+        total.time += stats.time;
+        total.scriptTime += stats.scriptTime;
+    }
+    return total;
+}
+
+static dv::value serialize_stats(const GeneratorStageStats& stats) {
+    auto map = dv::object();
+    map["calls"] = static_cast<dv::integer_t>(stats.calls);
+    map["time"] = static_cast<dv::integer_t>(stats.time);
+    map["script-time"] = static_cast<dv::integer_t>(stats.scriptTime);
+    map["native-time"] = static_cast<dv::integer_t>(
+        stats.time > stats.scriptTime ? stats.time - stats.scriptTime : 0
+    );
+    return map;
+}
+
+dv::value WorldGenProfile::serialize() const {
+    auto root = dv::object();
+    root["interval"] = static_cast<dv::integer_t>(interval);
+    auto& stagesMap = root.object("stages");
+    for (size_t i = 0; i < GENERATOR_STAGES_COUNT; i++) {
+        stagesMap[STAGE_NAMES[i]] = serialize_stats(stages[i]);
+    }
+    root["total"] = serialize_stats(total());
+    return root;
+}
+
+GeneratorProfiler::GeneratorProfiler(uint64_t minInterval)
+    : intervalStart(steady_clock::now()), minInterval(minInterval) {
+}
+
+void GeneratorProfiler::add(
+    GeneratorStage stage, uint calls, uint64_t time, uint64_t scriptTime
+) {
+    auto& stageCounters = counters[static_cast<size_t>(stage)];
+    stageCounters.calls.fetch_add(calls, std::memory_order_relaxed);
+    stageCounters.time.fetch_add(time, std::memory_order_relaxed);
+    stageCounters.scriptTime.fetch_add(scriptTime, std::memory_order_relaxed);
+}
+
+void GeneratorProfiler::update() {
+    auto now = steady_clock::now();
+    uint64_t interval = duration_cast<microseconds>(now - intervalStart).count();
+    if (interval < minInterval) {
+        return;
+    }
+    intervalStart = now;
+    profile.interval = interval;
+    for (size_t i = 0; i < GENERATOR_STAGES_COUNT; i++) {
+        auto& stats = profile.stages[i];
+        stats.calls = counters[i].calls.exchange(0, std::memory_order_relaxed);
+        stats.time = counters[i].time.exchange(0, std::memory_order_relaxed);
+        stats.scriptTime =
+            counters[i].scriptTime.exchange(0, std::memory_order_relaxed);
+    }
+}
+
+const char* GeneratorProfiler::getStageName(GeneratorStage stage) {
+    return STAGE_NAMES[static_cast<size_t>(stage)];
+}
+
+GeneratorStageTimer::GeneratorStageTimer(
+    GeneratorProfiler& profiler, GeneratorStage stage, uint calls
+)
+    : profiler(profiler),
+      stage(stage),
+      calls(calls),
+      start(steady_clock::now()) {
+}
+
+GeneratorStageTimer::~GeneratorStageTimer() {
+    uint64_t time =
+        duration_cast<microseconds>(steady_clock::now() - start).count();
+    profiler.add(stage, calls, time, scriptTime);
+}
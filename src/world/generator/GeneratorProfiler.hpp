@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+
+#include "typedefs.hpp"
+#include "data/dv.hpp"
+
+/// @brief World generation pipeline stages
+enum class GeneratorStage {
+    WIDE_STRUCTS = 0,
+    BIOMES,
+    HEIGHTMAP,
+    STRUCTURES,
+    LAND,
+    DENSITY,
+    PLACEMENTS,
+    PLANTS,
+    COUNT
+};
+
+inline constexpr size_t GENERATOR_STAGES_COUNT =
+    static_cast<size_t>(GeneratorStage::COUNT);
+
+struct GeneratorStageStats {
+    /// @brief number of stage calls (a call may process a batch of chunks)
+    uint64_t calls = 0;
+    /// @brief total stage time in microseconds
+    uint64_t time = 0;
+    /// @brief generator script time in microseconds (included in time)
+    uint64_t scriptTime = 0;
+};
+
+/// @brief Generator stages statistics aggregated over an interval
+struct WorldGenProfile {
+    std::array<GeneratorStageStats, GENERATOR_STAGES_COUNT> stages {};
+    /// @brief interval duration in microseconds
+    uint64_t interval = 0;
+
+    /// @brief Sum of all stages statistics
+    GeneratorStageStats total() const;
+
+    dv::value serialize() const;
+};
+
+/// @brief Per-stage generator time counters. Stats may be added from
+/// multiple threads
+class GeneratorProfiler {
+    struct Counters {
+        std::atomic<uint64_t> calls {0};
+        std::atomic<uint64_t> time {0};
+        std::atomic<uint64_t> scriptTime {0};
+    };
+    std::array<Counters, GENERATOR_STAGES_COUNT> counters;
+    std::chrono::steady_clock::time_point intervalStart;
+    /// @brief Minimal aggregation interval in microseconds
+    uint64_t minInterval;
+    WorldGenProfile profile;
+public:
+    /// @brief Default minimal aggregation interval in microseconds
+    static inline constexpr uint64_t INTERVAL = 1'000'000;
+
+    /// @param minInterval minimal aggregation interval in microseconds
+    GeneratorProfiler(uint64_t minInterval = INTERVAL);
+
+    /// @param minInterval minimal aggregation interval in microseconds,
+    /// 0 - complete the interval on every update
+    void setInterval(uint64_t minInterval) {
+        this->minInterval = minInterval;
+    }
+
+    /// @param time stage time in microseconds
+    /// @param scriptTime generator script time in microseconds
+    void add(
+        GeneratorStage stage, uint calls, uint64_t time, uint64_t scriptTime
+    );
+
+    /// @brief Complete aggregation interval if the minimal interval passed.
+    /// Must not be called concurrently with getProfile
+    void update();
+
+    /// @return statistics of the last completed interval
+    const WorldGenProfile& getProfile() const {
+        return profile;
+    }
+
+    static const char* getStageName(GeneratorStage stage);
+};
+
+/// @brief Measures stage time until destroyed
+class GeneratorStageTimer {
+    GeneratorProfiler& profiler;
+    GeneratorStage stage;
+    uint calls;
+    std::chrono::steady_clock::time_point start;
+    uint64_t scriptTime = 0;
+public:
+    GeneratorStageTimer(
+        GeneratorProfiler& profiler, GeneratorStage stage, uint calls = 1
+    );
+    ~GeneratorStageTimer();
+
+    /// @param time generator script time in microseconds
+    void addScriptTime(uint64_t time) {
+        scriptTime += time;
+    }
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "typedefs.hpp"
+#include "util/Buffer.hpp"
+
+/// @brief Persistent storage of encoded chunk prototypes used by
+/// WorldGenerator to skip biomes and heightmap generation for chunks
+/// explored before
+class PrototypesStorage {
+public:
+    virtual ~PrototypesStorage() = default;
+
+    /// @brief Get encoded prototype
+    /// @param x chunk.x
+    /// @param z chunk.z
+    /// @return encoded prototype or nullptr if not stored
+    virtual util::Buffer<ubyte> loadPrototype(int x, int z) = 0;
+
+    /// @brief Store encoded prototype
+    /// @param x chunk.x
+    /// @param z chunk.z
+    /// @param data encoded prototype
+    virtual void storePrototype(int x, int z, util::Buffer<ubyte> data) = 0;
+};
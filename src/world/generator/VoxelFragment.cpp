@@ -168,6 +168,25 @@ void VoxelFragment::prepare(const Content& content) {
         voxelsRuntime[i].id = content.blocks.require(name).rt.id;
         voxelsRuntime[i].state = voxels[i].state;
     }
+    runsRuntime.clear();
+    for (int y = 0; y < size.y; y++) {
+        for (int z = 0; z < size.z; z++) {
+            const voxel* row = &voxelsRuntime[vox_index(0, y, z, size.x, size.z)];
+            int x = 0;
+            while (x < size.x) {
+                if (row[x].id == BLOCK_AIR) {
+                    x++;
+                    continue;
+                }
+                VoxelsRun run {x, y, z, 0, false};
+                for (; x < size.x && row[x].id != BLOCK_AIR; x++) {
+                    run.structAir |= row[x].id == BLOCK_STRUCT_AIR;
+                }
+                run.length = x - run.x;
+                runsRuntime.push_back(run);
+            }
+        }
+    }
 }
 
 void VoxelFragment::place(
@@ -196,6 +215,10 @@ void VoxelFragment::place(
 }
 
 std::unique_ptr<VoxelFragment> VoxelFragment::rotated(const Content& content) const {
+    std::vector<const Block*> defs(blockNames.size());
+    for (size_t i = 0; i < blockNames.size(); i++) {
+        defs[i] = &content.blocks.require(blockNames[i]);
+    }
     std::vector<voxel> newVoxels(voxels.size());
 
     for (int y = 0; y < size.y; y++) {
@@ -207,7 +230,7 @@ std::unique_ptr<VoxelFragment> VoxelFragment::rotated(const Content& content) co
                 voxel.state.segment = ((voxel.state.segment & 0b001) << 2)
                                     | (voxel.state.segment & 0b010)
                                     | ((voxel.state.segment & 0b100) >> 2);
-                auto& def = content.blocks.require(blockNames[voxel.id]);
+                const auto& def = *defs.at(voxel.id);
                 if (def.rotations.name == BlockRotProfile::PANE_NAME ||
                       def.rotations.name == BlockRotProfile::PIPE_NAME) {
                     if (voxel.state.rotation < 4) {
@@ -13,6 +13,16 @@ class Level;
 class Content;
 class GlobalChunks;
 
+/// @brief Contiguous X-axis run of non-air fragment voxels
+struct VoxelsRun {
+    int x;
+    int y;
+    int z;
+    int length;
+    /// @brief Run contains struct air voxels
+    bool structAir;
+};
+
 class VoxelFragment : public Serializable {
     glm::ivec3 size;
 
@@ -23,6 +33,8 @@ class VoxelFragment : public Serializable {
 
     /// @brief Structure voxels built on prepare(...) call
     std::vector<voxel> voxelsRuntime;
+    /// @brief Runs of non-air runtime voxels ordered by Y, then Z
+    std::vector<VoxelsRun> runsRuntime;
 public:
     VoxelFragment() : size() {}
 
@@ -39,7 +51,7 @@ public:
     void deserialize(const dv::value& src) override;
     void crop();
 
-    /// @brief Build runtime voxel indices
+    /// @brief Build runtime voxel indices and non-air voxels runs
     /// @param content world content
     void prepare(const Content& content);
 
@@ -64,8 +76,13 @@ public:
     }
 
     /// @return Voxels with indices valid to current world content
-    const std::vector<voxel>& getRuntimeVoxels() {
+    const std::vector<voxel>& getRuntimeVoxels() const {
         assert(!voxelsRuntime.empty());
         return voxelsRuntime;
     }
+
+    /// @return Runs of non-air runtime voxels ordered by Y, then Z
+    const std::vector<VoxelsRun>& getRuntimeRuns() const {
+        return runsRuntime;
+    }
 };
@@ -1,16 +1,23 @@
 #include "WorldGenerator.hpp"
 
 #include <cstring>
+#include <chrono>
+#include <thread>
 #include <algorithm>
 
 #include "maths/util.hpp"
+#include "maths/FastNoiseLite.h"
+#include "maths/noise_batch.hpp"
 #include "content/Content.hpp"
 #include "voxels/Block.hpp"
 #include "voxels/Chunk.hpp"
 #include "GeneratorDef.hpp"
+#include "PrototypesStorage.hpp"
 #include "VoxelFragment.hpp"
+#include "coders/byte_utils.hpp"
 #include "util/timeutil.hpp"
 #include "util/listutil.hpp"
+#include "util/ThreadPool.hpp"
 #include "maths/voxmaths.hpp"
 #include "maths/util.hpp"
 #include "debug/Logger.hpp"
@@ -23,33 +30,134 @@ static inline constexpr uint MAX_PARAMETERS = 4;
 /// @brief Initial + wide_structs + biomes + heightmaps + complete
 static inline constexpr uint BASIC_PROTOTYPE_LAYERS = 5;
 
+/// @brief Version of the prototypes storage format
+static inline constexpr ubyte PROTOTYPE_FORMAT_VERSION = 1;
+
+/// @brief Encoded prototype size: version, fingerprint, heights, biomes
+static inline constexpr size_t PROTOTYPE_DATA_LEN =
+    1 + 4 + CHUNK_W * CHUNK_D * (sizeof(float) + sizeof(int16_t));
+
+/// @brief 32 bit FNV-1a hash
+static uint32_t fnv1a(uint32_t hash, const void* data, size_t size) {
+    auto bytes = static_cast<const ubyte*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint32_t fnv1a(uint32_t hash, const std::string& str) {
+    return fnv1a(hash, str.data(), str.length() + 1);
+}
+
+/// @brief Hash of everything stored prototypes depend on: generator name,
+/// seed, script source, biomes and heights maps settings and biomes
+/// selection parameters. Modules required by the script are not included
+static uint32_t fingerprint(const GeneratorDef& def, uint64_t seed) {
+    uint32_t hash = fnv1a(2166136261u, def.name);
+    hash = fnv1a(hash, &seed, sizeof(seed));
+    hash = fnv1a(hash, &def.scriptHash, sizeof(def.scriptHash));
+
+    uint32_t params[] {
+        def.biomeParameters,
+        def.biomesBPD,
+        def.heightsBPD,
+        static_cast<uint32_t>(def.biomesInterpolation),
+        static_cast<uint32_t>(def.heightsInterpolation),
+        static_cast<uint32_t>(def.heightmapInputs.size())};
+    hash = fnv1a(hash, params, sizeof(params));
+    hash = fnv1a(hash, def.heightmapInputs.data(), def.heightmapInputs.size());
+    for (const auto& biome : def.biomes) {
+        hash = fnv1a(hash, biome.name);
+        for (const auto& parameter : biome.parameters) {
+            hash = fnv1a(hash, &parameter.value, sizeof(parameter.value));
+            hash = fnv1a(hash, &parameter.weight, sizeof(parameter.weight));
+        }
+    }
+    return hash;
+}
+
+/// @brief Prototypes of the chunks batch generated by a script worker
+struct PrototypesBatch {
+    /// @brief Any chunk of the batch
+    glm::ivec2 chunk;
+    std::unordered_map<glm::ivec2, ChunkPrototype*> prototypes;
+};
+
+struct PrototypesBatchResult {
+    std::shared_ptr<PrototypesBatch> batch;
+    bool success;
+};
+
+class PrototypesWorker : public util::Worker<
+                             std::shared_ptr<PrototypesBatch>,
+                             PrototypesBatchResult> {
+    const WorldGenerator& generator;
+    GeneratorScript& script;
+public:
+    PrototypesWorker(const WorldGenerator& generator, GeneratorScript& script)
+        : generator(generator), script(script) {
+    }
+
+    PrototypesBatchResult operator()(
+        const std::shared_ptr<PrototypesBatch>& batch
+    ) override {
+        try {
+            generator.generateBatchAhead(script, *batch);
+        } catch (const std::exception& err) {
+            logger.error() << "could not generate prototypes ahead: "
+                           << err.what();
+            return PrototypesBatchResult {batch, false};
+        }
+        return PrototypesBatchResult {batch, true};
+    }
+};
+
+/// @brief Run of the same block in a column
+struct BlocksSpan {
+    blockid_t id;
+    /// @brief Level above the last level of the span
+    int end;
+};
+
 WorldGenerator::WorldGenerator(
     const GeneratorDef& def, const Content& content, uint64_t seed
 )
     : def(def), 
       content(content), 
       seed(seed),
-      surroundMap(0, BASIC_PROTOTYPE_LAYERS + def.wideStructsChunksRadius * 2)
+      surroundMap(0, BASIC_PROTOTYPE_LAYERS + def.wideStructsChunksRadius * 2),
+      prototypes(
+          surroundMap.getArea().getWidth(), surroundMap.getArea().getHeight()
+      ),
+      batchSize(def.batchChunks)
 {
     def.script->initialize(seed);
 
+    prototypesFingerprint = fingerprint(def, seed);
+
+    if (batchSize > 1 &&
+        (CHUNK_W % def.biomesBPD || CHUNK_D % def.biomesBPD ||
+         CHUNK_W % def.heightsBPD || CHUNK_D % def.heightsBPD)) {
+        logger.warning() << "batch-chunks requires chunk size to be a "
+                            "multiple of biomes-bpd and heights-bpd";
+        batchSize = 1;
+    }
+
     uint levels = BASIC_PROTOTYPE_LAYERS + def.wideStructsChunksRadius * 2;
 
     surroundMap = SurroundMap(0, levels);
     logger.info() << "total number of prototype levels is " << levels;
-    surroundMap.setOutCallback([this](int const x, int const z, int8_t) {
-        const auto& found = prototypes.find({x, z});
-        if (found == prototypes.end()) {
-            logger.warning() << "unable to remove non-existing chunk prototype";
-            return;
+    prototypes.setOutCallback(
+        [this](int const, int const, ChunkPrototype* const& prototype) {
+            releasePrototype(prototype);
         }
-        prototypes.erase({x, z});
-    });
+    );
     surroundMap.setLevelCallback(1, [this](int const x, int const z) {
-        if (prototypes.find({x, z}) != prototypes.end()) {
+        if (prototypes.get(x, z)) {
             return;
         }
-        prototypes[{x, z}] = generatePrototype(x, z);
+        prototypes.set(x, z, generatePrototype(x, z));
     });
     surroundMap.setLevelCallback(def.wideStructsChunksRadius + 1, 
     [this](int const x, int const z) {
@@ -64,36 +172,90 @@ WorldGenerator::WorldGenerator(
     surroundMap.setLevelCallback(levels-1, [this](int const x, int const z) {
         generateStructures(requirePrototype(x, z), x, z);
     });
-    for (int i = 0; i < def.structures.size(); i++) {
-        // pre-calculate rotated structure variants
-        def.structures[i]->fragments[0]->prepare(content);
-        for (int j = 1; j < 4; j++) {
-            def.structures[i]->fragments[j] = 
-                def.structures[i]->fragments[j-1]->rotated(content);
-        }
-    }
 }
 
-WorldGenerator::~WorldGenerator() {}
+WorldGenerator::~WorldGenerator() {
+    // workers write to prototypes and use worker scripts
+    aheadPool.reset();
+}
 
 ChunkPrototype& WorldGenerator::requirePrototype(int x, int z) {
-    const auto& found = prototypes.find({x, z});
-    if (found == prototypes.end()) {
+    auto found = prototypes.get(x, z);
+    if (found == nullptr) {
         throw std::runtime_error("prototype not found");
     }
-    return *found->second;
+    return *found;
 }
 
-static inline void generate_pole(
+const ChunkPrototype& WorldGenerator::requirePrototype(int x, int z) const {
+    auto found = prototypes.get(x, z);
+    if (found == nullptr) {
+        throw std::runtime_error("prototype not found");
+    }
+    return *found;
+}
+
+void ChunkPrototype::reset() {
+    level = ChunkPrototypeLevel::VOID;
+    biomes = nullptr;
+    heightmap = nullptr;
+    placements.clear();
+    heightmapInputs.clear();
+    batchHeightmapInputs = nullptr;
+    aheadPlacements = nullptr;
+    stored = false;
+}
+
+ChunkPrototype* WorldGenerator::acquirePrototype() {
+    if (freePrototypes.empty()) {
+        prototypesPool.push_back(std::make_unique<ChunkPrototype>());
+        return prototypesPool.back().get();
+    }
+    auto prototype = freePrototypes.back();
+    freePrototypes.pop_back();
+    return prototype;
+}
+
+void WorldGenerator::releasePrototype(ChunkPrototype* prototype) {
+    auto& heightmap = prototype->heightmap;
+    // heightmap may be still referenced by the generator script
+    if (heightmap && heightmap.use_count() == 1 &&
+        heightmap->getWidth() == CHUNK_W && heightmap->getHeight() == CHUNK_D) {
+        std::lock_guard lock(heightmapsMutex);
+        freeHeightmaps.push_back(std::move(heightmap));
+    }
+    prototype->reset();
+    freePrototypes.push_back(prototype);
+}
+
+std::shared_ptr<Heightmap> WorldGenerator::acquireHeightmap() const {
+    {
+        std::lock_guard lock(heightmapsMutex);
+        if (!freeHeightmaps.empty()) {
+            auto heightmap = std::move(freeHeightmaps.back());
+            freeHeightmaps.pop_back();
+            return heightmap;
+        }
+    }
+    return std::make_shared<Heightmap>(CHUNK_W, CHUNK_D);
+}
+
+/// @brief Fill column levels covered by the layers
+/// @param top first (highest) level of the layers
+/// @param bottom level the resizeable layer is stretched to
+/// @param column column blocks from the bottom up (CHUNK_H)
+static inline void fill_pole(
     const BlocksLayers& layers,
     int top, int bottom,
     int seaLevel,
-    voxel* voxels,
-    int x, int z
+    blockid_t* column
 ) {
-    uint y = top;
-    uint layerExtension = 0;
+    int y = top;
+    int layerExtension = 0;
     for (const auto& layer : layers.layers) {
+        if (y < 0) {
+            break;
+        }
         // skip layer if can't be generated under sea level
         if (y < seaLevel && !layer.belowSeaLevel) {
             layerExtension = std::max(0, layer.height);
@@ -106,11 +268,19 @@ static inline void generate_pole(
         } else {
             layerHeight += layerExtension;
         }
-        layerHeight = std::min(static_cast<uint>(layerHeight), y+1);
-
-        for (uint i = 0; i < layerHeight; i++, y--) {
-            voxels[vox_index(x, y, z)].id = layer.rt.id;
+        if (layerHeight < 0 || layerHeight > y + 1) {
+            layerHeight = y + 1;
         }
+        blockid_t id = layer.rt.id;
+        if (id == BLOCK_STRUCT_AIR) {
+            id = BLOCK_AIR;
+        }
+        int end = std::min(y + 1, CHUNK_H);
+        int begin = y + 1 - layerHeight;
+        if (begin < end) {
+            std::fill(column + begin, column + end, id);
+        }
+        y -= layerHeight;
         layerExtension = 0;
     }
 }
@@ -142,10 +312,261 @@ static inline const Biome* choose_biome(
     return chosenBiome;
 }
 
-std::unique_ptr<ChunkPrototype> WorldGenerator::generatePrototype(
-    int chunkX, int chunkZ
+/// @brief Copy rectangular area of the map
+static std::shared_ptr<Heightmap> slice_map(
+    const Heightmap& map, uint x, uint y, uint width, uint height
+) {
+    std::vector<float> buffer(width * height);
+    const float* src = map.getValues();
+    for (uint row = 0; row < height; row++) {
+        std::memcpy(
+            buffer.data() + row * width,
+            src + (y + row) * map.getWidth() + x,
+            width * sizeof(float)
+        );
+    }
+    return std::make_shared<Heightmap>(width, height, std::move(buffer));
+}
+
+static void check_map_size(const Heightmap& map, const glm::ivec2& size) {
+    if (static_cast<int>(map.getWidth()) != size.x ||
+        static_cast<int>(map.getHeight()) != size.y) {
+        throw std::runtime_error(
+            "generator returned map of invalid size " +
+            std::to_string(map.getWidth()) + "x" +
+            std::to_string(map.getHeight())
+        );
+    }
+}
+
+ChunkPrototype* WorldGenerator::generatePrototype(int chunkX, int chunkZ) {
+    const auto& found = aheadPrototypes.find({chunkX, chunkZ});
+    if (found != aheadPrototypes.end()) {
+        auto prototype = found->second;
+        aheadPrototypes.erase(found);
+        return prototype;
+    }
+    auto prototype = acquirePrototype();
+    if (prototypesStorage) {
+        loadPrototype(*prototype, chunkX, chunkZ);
+    }
+    return prototype;
+}
+
+bool WorldGenerator::loadPrototype(
+    ChunkPrototype& prototype, int chunkX, int chunkZ
+) {
+    auto data = prototypesStorage->loadPrototype(chunkX, chunkZ);
+    if (data == nullptr) {
+        return false;
+    }
+    if (data.size() != PROTOTYPE_DATA_LEN) {
+        logger.warning() << "invalid prototype data size " << data.size()
+                         << " at " << chunkX << " " << chunkZ;
+        return false;
+    }
+    ByteReader reader(data.data(), data.size());
+    if (reader.get() != PROTOTYPE_FORMAT_VERSION ||
+        static_cast<uint32_t>(reader.getInt32()) != prototypesFingerprint) {
+        return false;
+    }
+    auto heightmap = acquireHeightmap();
+    float* heights = heightmap->getValues();
+    for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+        heights[i] = reader.getFloat32();
+    }
+    auto biomes = std::make_unique<const Biome*[]>(CHUNK_W * CHUNK_D);
+    for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+        uint index = static_cast<uint16_t>(reader.getInt16());
+        if (index >= def.biomes.size()) {
+            return false;
+        }
+        biomes[i] = &def.biomes[index];
+    }
+    prototype.heightmap = std::move(heightmap);
+    prototype.biomes = std::move(biomes);
+    prototype.stored = true;
+    return true;
+}
+
+void WorldGenerator::storePrototype(
+    ChunkPrototype& prototype, int chunkX, int chunkZ
 ) {
-    return std::make_unique<ChunkPrototype>();
+    ByteBuilder builder(PROTOTYPE_DATA_LEN);
+    builder.put(PROTOTYPE_FORMAT_VERSION);
+    builder.putInt32(prototypesFingerprint);
+    const float* heights = prototype.heightmap->getValues();
+    for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+        builder.putFloat32(heights[i]);
+    }
+    for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+        builder.putInt16(prototype.biomes[i] - def.biomes.data());
+    }
+    prototypesStorage->storePrototype(
+        chunkX, chunkZ, util::Buffer<ubyte>(builder.data(), builder.size())
+    );
+    prototype.stored = true;
+}
+
+void WorldGenerator::setPrototypesStorage(PrototypesStorage* storage) {
+    prototypesStorage = storage;
+}
+
+bool WorldGenerator::createWorkers(uint count) {
+    std::vector<std::unique_ptr<GeneratorScript>> scripts;
+    for (uint i = 0; i < count; i++) {
+        auto script = def.script->createWorker();
+        if (script == nullptr) {
+            return false;
+        }
+        script->initialize(seed);
+        scripts.push_back(std::move(script));
+    }
+    aheadPool.reset();
+    aheadPending.clear();
+    aheadRemaining = 0;
+    workers = std::move(scripts);
+    return true;
+}
+
+void WorldGenerator::generateAhead(const std::vector<glm::ivec2>& chunks) {
+    startAhead(chunks);
+    while (!updateAhead()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void WorldGenerator::startAhead(const std::vector<glm::ivec2>& chunks) {
+    if (workers.empty()) {
+        return;
+    }
+    std::unordered_map<glm::ivec2, std::shared_ptr<PrototypesBatch>> batches;
+    for (const auto& pos : chunks) {
+        if (prototypes.get(pos.x, pos.y) ||
+            aheadPrototypes.find(pos) != aheadPrototypes.end() ||
+            aheadPending.find(pos) != aheadPending.end()) {
+            continue;
+        }
+        glm::ivec2 batchPos(
+            floordiv(pos.x, batchSize), floordiv(pos.y, batchSize)
+        );
+        auto& batch = batches[batchPos];
+        if (batch == nullptr) {
+            batch = std::make_shared<PrototypesBatch>();
+            batch->chunk = pos;
+        }
+        auto& prototype = batch->prototypes[pos];
+        if (prototype) {
+            continue;
+        }
+        prototype = acquirePrototype();
+        aheadPending.insert(pos);
+        if (prototypesStorage) {
+            loadPrototype(*prototype, pos.x, pos.y);
+        }
+    }
+    if (batches.empty()) {
+        return;
+    }
+    if (aheadPool == nullptr) {
+        auto nextWorker = std::make_shared<size_t>(0);
+        aheadPool = std::make_unique<util::ThreadPool<
+            std::shared_ptr<PrototypesBatch>,
+            PrototypesBatchResult>>(
+            "prototypes-worker",
+            [this, nextWorker]() {
+                return std::make_shared<PrototypesWorker>(
+                    *this, *workers[(*nextWorker)++]
+                );
+            },
+            [this](PrototypesBatchResult& result) {
+                aheadRemaining--;
+                for (auto& [pos, prototype] : result.batch->prototypes) {
+                    aheadPending.erase(pos);
+                    if (result.success) {
+                        aheadPrototypes[pos] = prototype;
+                    } else {
+                        releasePrototype(prototype);
+                    }
+                }
+            },
+            workers.size()
+        );
+        aheadPool->setStopOnFail(false);
+    }
+    for (auto& [_, batch] : batches) {
+        aheadRemaining++;
+        aheadPool->enqueueJob(batch);
+    }
+}
+
+bool WorldGenerator::updateAhead() {
+    if (aheadRemaining == 0) {
+        return true;
+    }
+    aheadPool->update();
+    return aheadRemaining == 0;
+}
+
+void WorldGenerator::generateBatchAhead(
+    GeneratorScript& script, PrototypesBatch& batch
+) const {
+    auto& batchPrototypes = batch.prototypes;
+    PrototypeFinder find = [&batchPrototypes](int x, int z) {
+        const auto& found = batchPrototypes.find({x, z});
+        if (found == batchPrototypes.end()) {
+            return static_cast<ChunkPrototype*>(nullptr);
+        }
+        return found->second;
+    };
+    int x = batch.chunk.x;
+    int z = batch.chunk.y;
+
+    std::shared_ptr<const std::vector<std::shared_ptr<Heightmap>>> inputs;
+    bool noHeightmaps = false;
+    for (const auto& [_, prototype] : batchPrototypes) {
+        if (prototype->biomes == nullptr) {
+            GeneratorStageTimer stageTimer(profiler, GeneratorStage::BIOMES);
+            generateBiomesBatch(script, x, z, find);
+            break;
+        }
+    }
+    for (const auto& [_, prototype] : batchPrototypes) {
+        if (prototype->heightmap == nullptr) {
+            noHeightmaps = true;
+            if (prototype->batchHeightmapInputs) {
+                inputs = prototype->batchHeightmapInputs;
+            }
+        }
+    }
+    if (noHeightmaps) {
+        GeneratorStageTimer stageTimer(profiler, GeneratorStage::HEIGHTMAP);
+        static const std::vector<std::shared_ptr<Heightmap>> noInputs;
+        generateHeightmapsBatch(
+            script, x, z, inputs ? *inputs : noInputs, find
+        );
+    }
+    // structures stage calls are counted on completion
+    GeneratorStageTimer stageTimer(profiler, GeneratorStage::STRUCTURES, 0);
+    for (auto& [pos, prototype] : batchPrototypes) {
+        prototype->batchHeightmapInputs = nullptr;
+        timeutil::Timer timer;
+        prototype->aheadPlacements = std::make_unique<std::vector<Placement>>(
+            script.placeStructures(
+                {pos.x * CHUNK_W, pos.y * CHUNK_D},
+                {CHUNK_W, CHUNK_D},
+                prototype->heightmap,
+                CHUNK_H
+            )
+        );
+        stageTimer.addScriptTime(timer.stop());
+    }
+}
+
+WorldGenerator::PrototypeFinder WorldGenerator::findPrototypes() {
+    return [this](int x, int z) {
+        return prototypes.get(x, z);
+    };
 }
 
 inline AABB gen_chunk_aabb(int chunkX, int chunkZ) {
@@ -165,11 +586,11 @@ void WorldGenerator::placeStructure(
     AABB aabb(position, position + size);
     for (int lcz = -1; lcz <= 1; lcz++) {
         for (int lcx = -1; lcx <= 1; lcx++) {
-            const auto& found = prototypes.find({chunkX + lcx, chunkZ + lcz});
-            if (found == prototypes.end()) {
+            auto found = prototypes.get(chunkX + lcx, chunkZ + lcz);
+            if (found == nullptr) {
                 continue;
             }
-            auto& otherPrototype = *found->second;
+            auto& otherPrototype = *found;
             auto chunkAABB = gen_chunk_aabb(chunkX + lcx, chunkZ + lcz);
             if (chunkAABB.intersect(aabb)) {
                 otherPrototype.placements.emplace_back(
@@ -196,9 +617,8 @@ void WorldGenerator::placeLine(const LinePlacement& line, int priority) {
     int czb = floordiv<CHUNK_D>(aabb.b.z);
     for (int cz = cza; cz <= czb; cz++) {
         for (int cx = cxa; cx <= cxb; cx++) {
-            const auto& found = prototypes.find({cx, cz});
-            if (found != prototypes.end()) {
-                found->second->placements.emplace_back(priority, line);
+            if (auto found = prototypes.get(cx, cz)) {
+                found->placements.emplace_back(priority, line);
             }
         }
     }
@@ -230,9 +650,12 @@ void WorldGenerator::generateStructuresWide(
     if (prototype.level >= ChunkPrototypeLevel::WIDE_STRUCTS) {
         return;
     }
+    GeneratorStageTimer stageTimer(profiler, GeneratorStage::WIDE_STRUCTS);
+    timeutil::Timer timer;
     auto placements = def.script->placeStructuresWide(
         {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D}, CHUNK_H
     );
+    stageTimer.addScriptTime(timer.stop());
     placeStructures(placements, prototype, chunkX, chunkZ);
 
     prototype.level = ChunkPrototypeLevel::WIDE_STRUCTS;
@@ -247,11 +670,19 @@ void WorldGenerator::generateStructures(
     const auto& biomes = prototype.biomes;
     const auto& heightmap = prototype.heightmap;
 
-    auto placements = def.script->placeStructures(
-        {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D},
-        heightmap, CHUNK_H
-    );
-    placeStructures(placements, prototype, chunkX, chunkZ);
+    GeneratorStageTimer stageTimer(profiler, GeneratorStage::STRUCTURES);
+    if (prototype.aheadPlacements) {
+        placeStructures(*prototype.aheadPlacements, prototype, chunkX, chunkZ);
+        prototype.aheadPlacements = nullptr;
+    } else {
+        timeutil::Timer timer;
+        auto placements = def.script->placeStructures(
+            {chunkX * CHUNK_W, chunkZ * CHUNK_D}, {CHUNK_W, CHUNK_D},
+            heightmap, CHUNK_H
+        );
+        stageTimer.addScriptTime(timer.stop());
+        placeStructures(placements, prototype, chunkX, chunkZ);
+    }
 
     util::PseudoRandom structsRand;
     structsRand.setSeed(chunkX, chunkZ);
@@ -291,28 +722,11 @@ void WorldGenerator::generateStructures(
     prototype.level = ChunkPrototypeLevel::STRUCTURES;
 }
 
-void WorldGenerator::generateBiomes(
-    ChunkPrototype& prototype, int chunkX, int chunkZ
-) {
-    if (prototype.level >= ChunkPrototypeLevel::BIOMES) {
-        return;
-    }
+void WorldGenerator::chooseBiomes(
+    ChunkPrototype& prototype,
+    std::vector<std::shared_ptr<Heightmap>>& biomeParams
+) const {
     uint bpd = def.biomesBPD;
-    auto biomeParams = def.script->generateParameterMaps(
-        {floordiv(chunkX * CHUNK_W, bpd), floordiv(chunkZ * CHUNK_D, bpd)},
-        {floordiv(CHUNK_W, bpd)+1, floordiv(CHUNK_D, bpd)+1},
-        bpd
-    );
-    for (auto index : def.heightmapInputs) {
-        // copy non-scaled maps
-        auto copy = std::make_shared<Heightmap>(*biomeParams[index]);
-        copy->resize(
-            floordiv(CHUNK_W, def.heightsBPD) + 1,
-            floordiv(CHUNK_D, def.heightsBPD) + 1,
-            def.heightsInterpolation
-        );
-        prototype.heightmapInputs.push_back(std::move(copy));
-    }
     for (const auto& map : biomeParams) {
         map->resize(
             CHUNK_W + bpd, CHUNK_D + bpd, def.biomesInterpolation
@@ -329,34 +743,208 @@ void WorldGenerator::generateBiomes(
         }
     }
     prototype.biomes = std::move(chunkBiomes);
+}
+
+void WorldGenerator::generateBiomes(
+    ChunkPrototype& prototype, int chunkX, int chunkZ
+) {
+    if (prototype.level >= ChunkPrototypeLevel::BIOMES) {
+        return;
+    }
+    // biomes may be already generated with the batch
+    if (prototype.biomes == nullptr && batchSize > 1) {
+        GeneratorStageTimer stageTimer(profiler, GeneratorStage::BIOMES);
+        generateBiomesBatch(*def.script, chunkX, chunkZ, findPrototypes());
+    } else if (prototype.biomes == nullptr) {
+        GeneratorStageTimer stageTimer(profiler, GeneratorStage::BIOMES);
+        uint bpd = def.biomesBPD;
+        timeutil::Timer timer;
+        auto biomeParams = def.script->generateParameterMaps(
+            {floordiv(chunkX * CHUNK_W, bpd), floordiv(chunkZ * CHUNK_D, bpd)},
+            {floordiv(CHUNK_W, bpd)+1, floordiv(CHUNK_D, bpd)+1},
+            bpd
+        );
+        stageTimer.addScriptTime(timer.stop());
+        for (auto index : def.heightmapInputs) {
+            // copy non-scaled maps
+            auto copy = std::make_shared<Heightmap>(*biomeParams[index]);
+            copy->resize(
+                floordiv(CHUNK_W, def.heightsBPD) + 1,
+                floordiv(CHUNK_D, def.heightsBPD) + 1,
+                def.heightsInterpolation
+            );
+            prototype.heightmapInputs.push_back(std::move(copy));
+        }
+        chooseBiomes(prototype, biomeParams);
+    }
     prototype.level = ChunkPrototypeLevel::BIOMES;
 }
 
+void WorldGenerator::generateBiomesBatch(
+    GeneratorScript& script,
+    int chunkX,
+    int chunkZ,
+    const PrototypeFinder& find
+) const {
+    int batchX = floordiv(chunkX, batchSize) * batchSize;
+    int batchZ = floordiv(chunkZ, batchSize) * batchSize;
+    uint bpd = def.biomesBPD;
+    int dotsW = CHUNK_W / bpd;
+    int dotsD = CHUNK_D / bpd;
+    glm::ivec2 size {dotsW * batchSize + 1, dotsD * batchSize + 1};
+
+    timeutil::Timer timer;
+    auto biomeParams = script.generateParameterMaps(
+        {floordiv(batchX * CHUNK_W, bpd), floordiv(batchZ * CHUNK_D, bpd)},
+        size,
+        bpd
+    );
+    profiler.add(GeneratorStage::BIOMES, 0, 0, timer.stop());
+    for (const auto& map : biomeParams) {
+        check_map_size(*map, size);
+    }
+
+    std::shared_ptr<std::vector<std::shared_ptr<Heightmap>>> inputs;
+    if (!def.heightmapInputs.empty()) {
+        inputs = std::make_shared<std::vector<std::shared_ptr<Heightmap>>>();
+        for (auto index : def.heightmapInputs) {
+            // copy non-scaled maps
+            auto copy = std::make_shared<Heightmap>(*biomeParams[index]);
+            copy->resize(
+                CHUNK_W / def.heightsBPD * batchSize + 1,
+                CHUNK_D / def.heightsBPD * batchSize + 1,
+                def.heightsInterpolation
+            );
+            inputs->push_back(std::move(copy));
+        }
+    }
+    for (int lz = 0; lz < batchSize; lz++) {
+        for (int lx = 0; lx < batchSize; lx++) {
+            auto prototype = find(batchX + lx, batchZ + lz);
+            if (prototype == nullptr || prototype->biomes) {
+                continue;
+            }
+            std::vector<std::shared_ptr<Heightmap>> chunkParams;
+            for (const auto& map : biomeParams) {
+                chunkParams.push_back(slice_map(
+                    *map, lx * dotsW, lz * dotsD, dotsW + 1, dotsD + 1
+                ));
+            }
+            prototype->batchHeightmapInputs = inputs;
+            chooseBiomes(*prototype, chunkParams);
+        }
+    }
+}
+
 void WorldGenerator::generateHeightmap(
     ChunkPrototype& prototype, int chunkX, int chunkZ
 ) {
     if (prototype.level >= ChunkPrototypeLevel::HEIGHTMAP) {
         return;
     }
+    // heightmap may be already generated with the batch
+    if (prototype.heightmap == nullptr && batchSize > 1) {
+        GeneratorStageTimer stageTimer(profiler, GeneratorStage::HEIGHTMAP);
+        static const std::vector<std::shared_ptr<Heightmap>> noInputs;
+        auto inputs = prototype.batchHeightmapInputs;
+        generateHeightmapsBatch(
+            *def.script,
+            chunkX,
+            chunkZ,
+            inputs ? *inputs : noInputs,
+            findPrototypes()
+        );
+    } else if (prototype.heightmap == nullptr) {
+        GeneratorStageTimer stageTimer(profiler, GeneratorStage::HEIGHTMAP);
+        uint bpd = def.heightsBPD;
+        timeutil::Timer timer;
+        auto heightmap = def.script->generateHeightmap(
+            {floordiv(chunkX * CHUNK_W, bpd), floordiv(chunkZ * CHUNK_D, bpd)},
+            {floordiv(CHUNK_W, bpd)+1, floordiv(CHUNK_D, bpd)+1},
+            bpd,
+            prototype.heightmapInputs
+        );
+        stageTimer.addScriptTime(timer.stop());
+        heightmap->clamp();
+        prototype.heightmap = acquireHeightmap();
+        heightmap->resampleTo(
+            *prototype.heightmap,
+            0, 0,
+            heightmap->getWidth(), heightmap->getHeight(),
+            CHUNK_W + bpd, CHUNK_D + bpd,
+            def.heightsInterpolation
+        );
+    }
+    prototype.batchHeightmapInputs = nullptr;
+    prototype.level = ChunkPrototypeLevel::HEIGHTMAP;
+
+    if (prototypesStorage && !prototype.stored) {
+        storePrototype(prototype, chunkX, chunkZ);
+    }
+}
+
+void WorldGenerator::generateHeightmapsBatch(
+    GeneratorScript& script,
+    int chunkX,
+    int chunkZ,
+    const std::vector<std::shared_ptr<Heightmap>>& inputs,
+    const PrototypeFinder& find
+) const {
+    int batchX = floordiv(chunkX, batchSize) * batchSize;
+    int batchZ = floordiv(chunkZ, batchSize) * batchSize;
     uint bpd = def.heightsBPD;
-    prototype.heightmap = def.script->generateHeightmap(
-        {floordiv(chunkX * CHUNK_W, bpd), floordiv(chunkZ * CHUNK_D, bpd)},
-        {floordiv(CHUNK_W, bpd)+1, floordiv(CHUNK_D, bpd)+1},
+    int dotsW = CHUNK_W / bpd;
+    int dotsD = CHUNK_D / bpd;
+    glm::ivec2 size {dotsW * batchSize + 1, dotsD * batchSize + 1};
+
+    timeutil::Timer timer;
+    auto heightmap = script.generateHeightmap(
+        {floordiv(batchX * CHUNK_W, bpd), floordiv(batchZ * CHUNK_D, bpd)},
+        size,
         bpd,
-        prototype.heightmapInputs
-    );
-    prototype.heightmap->clamp();
-    prototype.heightmap->resize(
-        CHUNK_W + bpd, CHUNK_D + bpd, def.heightsInterpolation
+        inputs
     );
-    prototype.heightmap->crop(0, 0, CHUNK_W, CHUNK_D);
-    prototype.level = ChunkPrototypeLevel::HEIGHTMAP;
+    profiler.add(GeneratorStage::HEIGHTMAP, 0, 0, timer.stop());
+    check_map_size(*heightmap, size);
+    heightmap->clamp();
+
+    for (int lz = 0; lz < batchSize; lz++) {
+        for (int lx = 0; lx < batchSize; lx++) {
+            auto prototype = find(batchX + lx, batchZ + lz);
+            if (prototype == nullptr || prototype->heightmap) {
+                continue;
+            }
+            prototype->heightmap = acquireHeightmap();
+            heightmap->resampleTo(
+                *prototype->heightmap,
+                lx * dotsW, lz * dotsD,
+                dotsW + 1, dotsD + 1,
+                CHUNK_W + bpd, CHUNK_D + bpd,
+                def.heightsInterpolation
+            );
+        }
+    }
 }
 
 void WorldGenerator::update(int centerX, int centerY, int loadDistance) {
+    profiler.update();
+
+    const auto& area = surroundMap.getArea();
     surroundMap.setCenter(centerX, centerY);
+    prototypes.setCenter(centerX, centerY);
     surroundMap.resize(loadDistance);
+    prototypes.resize(area.getWidth(), area.getHeight());
     surroundMap.setCenter(centerX, centerY);
+    prototypes.setCenter(centerX, centerY);
+
+    for (auto it = aheadPrototypes.begin(); it != aheadPrototypes.end();) {
+        if (area.isInside(it->first.x, it->first.y)) {
+            ++it;
+        } else {
+            releasePrototype(it->second);
+            it = aheadPrototypes.erase(it);
+        }
+    }
 }
 
 void WorldGenerator::generatePlants(
@@ -366,7 +954,7 @@ void WorldGenerator::generatePlants(
     int chunkX,
     int chunkZ,
     const Biome** biomes
-) {
+) const {
     const auto& indices = content.getIndices()->blocks;
     util::PseudoRandom plantsRand;
     plantsRand.setSeed(chunkX, chunkZ);
@@ -408,69 +996,225 @@ void WorldGenerator::generateLand(
     int chunkX,
     int chunkZ,
     const Biome** biomes
-) {
-    uint seaLevel = def.seaLevel;
-    for (uint z = 0; z < CHUNK_D; z++) {
-        for (uint x = 0; x < CHUNK_W; x++) {
-            const Biome* biome = biomes[z * CHUNK_W + x];
+) const {
+    constexpr uint AREA = CHUNK_W * CHUNK_D;
+    int seaLevel = def.seaLevel;
+
+    // columns as runs of the same block from the bottom up
+    std::vector<BlocksSpan> spans;
+    spans.reserve(AREA * 4);
+    uint firstSpans[AREA];
+    blockid_t column[CHUNK_H];
+    for (uint i = 0; i < AREA; i++) {
+        const Biome* biome = biomes[i];
+
+        int height = values[i] * CHUNK_H;
+        height = std::max(0, height);
 
-            int height = values[z * CHUNK_W + x] * CHUNK_H;
-            height = std::max(0, height);
+        std::fill(column, column + CHUNK_H, BLOCK_AIR);
+        fill_pole(biome->seaLayers, seaLevel, height, seaLevel, column);
+        fill_pole(biome->groundLayers, height, 0, seaLevel, column);
+
+        firstSpans[i] = spans.size();
+        for (int y = 1; y <= CHUNK_H; y++) {
+            if (y == CHUNK_H || column[y] != column[y - 1]) {
+                spans.push_back(BlocksSpan {column[y - 1], y});
+            }
+        }
+    }
 
-            const auto& groundLayers = biome->groundLayers;
-            const auto& seaLayers = biome->seaLayers;
+    // levels below are the same block in all columns
+    blockid_t bottomBlock = spans[0].id;
+    int bottomEnd = CHUNK_H;
+    // levels above are air in all columns
+    int airBegin = 0;
+    for (uint i = 0; i < AREA; i++) {
+        const auto& first = spans[firstSpans[i]];
+        bottomEnd = first.id == bottomBlock ? std::min(bottomEnd, first.end) : 0;
 
-            generate_pole(seaLayers, seaLevel, height, seaLevel, voxels, x, z);
-            generate_pole(groundLayers, height, 0, seaLevel, voxels, x, z);
+        uint last = (i + 1 < AREA ? firstSpans[i + 1] : spans.size()) - 1;
+        if (spans[last].id != BLOCK_AIR) {
+            airBegin = CHUNK_H;
+        } else if (last > firstSpans[i]) {
+            airBegin = std::max(airBegin, spans[last - 1].end);
         }
     }
+    airBegin = std::max(airBegin, bottomEnd);
+
+    std::fill(voxels, voxels + bottomEnd * AREA, voxel {bottomBlock, {}});
+    for (int y = bottomEnd; y < airBegin; y++) {
+        voxel* slab = voxels + y * AREA;
+        for (uint i = 0; i < AREA; i++) {
+            uint& index = firstSpans[i];
+            if (spans[index].end <= y) {
+                index++;
+            }
+            slab[i] = {spans[index].id, {}};
+        }
+    }
+    std::memset(
+        voxels + airBegin * AREA, 0, (CHUNK_H - airBegin) * AREA * sizeof(voxel)
+    );
 }
 
 void WorldGenerator::generate(voxel* voxels, int chunkX, int chunkZ) {
+    prepare(chunkX, chunkZ);
+    generateVoxels(voxels, chunkX, chunkZ);
+}
+
+void WorldGenerator::prepare(int chunkX, int chunkZ) {
     surroundMap.completeAt(chunkX, chunkZ);
+}
 
+void WorldGenerator::generateVoxels(
+    voxel* voxels, int chunkX, int chunkZ
+) const {
     const auto& prototype = requirePrototype(chunkX, chunkZ);
     const auto values = prototype.heightmap->getValues();
 
-    uint seaLevel = def.seaLevel;
-
-    std::memset(voxels, 0, sizeof(voxel) * CHUNK_VOL);
-
     const auto& biomes = prototype.biomes.get();
-    for (uint z = 0; z < CHUNK_D; z++) {
-        for (uint x = 0; x < CHUNK_W; x++) {
-            const Biome* biome = biomes[z * CHUNK_W + x];
-
-            int height = values[z * CHUNK_W + x] * CHUNK_H;
-            height = std::max(0, height);
-
-            const auto& groundLayers = biome->groundLayers;
-            const auto& seaLayers = biome->seaLayers;
-
-            generate_pole(seaLayers, seaLevel, height, seaLevel, voxels, x, z);
-            generate_pole(groundLayers, height, 0, seaLevel, voxels, x, z);
-        }
+    {
+        GeneratorStageTimer timer(profiler, GeneratorStage::LAND);
+        generateLand(prototype, values, voxels, chunkX, chunkZ, biomes);
+    }
+    glm::ivec2 structAirLevels;
+    {
+        GeneratorStageTimer timer(profiler, GeneratorStage::PLACEMENTS);
+        structAirLevels = generatePlacements(prototype, voxels, chunkX, chunkZ);
+    }
+    if (def.density.enabled) {
+        GeneratorStageTimer timer(profiler, GeneratorStage::DENSITY);
+        generateDensity(values, voxels, chunkX, chunkZ);
+    }
+    {
+        GeneratorStageTimer timer(profiler, GeneratorStage::PLANTS);
+        generatePlants(prototype, values, voxels, chunkX, chunkZ, biomes);
     }
-    generatePlacements(prototype, voxels, chunkX, chunkZ);
-    generatePlants(prototype, values, voxels, chunkX, chunkZ, biomes);
 
-    [[maybe_unused]] const auto& indices = content.getIndices()->blocks;
-    for (uint i = 0; i < CHUNK_VOL; i++) {
+    // struct air is kept until plants are placed
+    for (uint i = structAirLevels.x * CHUNK_W * CHUNK_D;
+         i < structAirLevels.y * CHUNK_W * CHUNK_D;
+         i++) {
         blockid_t& id = voxels[i].id;
         if (id == BLOCK_STRUCT_AIR) {
             id = BLOCK_AIR;
         }
+    }
 #ifndef NDEBUG
-        if (indices.get(id) == nullptr) {
+    const auto& indices = content.getIndices()->blocks;
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        if (indices.get(voxels[i].id) == nullptr) {
             abort();
         }
+    }
 #endif
+}
+
+void WorldGenerator::generateDensity(
+    const float* heights, voxel* voxels, int chunkX, int chunkZ
+) const {
+    const auto& density = def.density;
+
+    // highest carved level of each column (exclusive)
+    int tops[CHUNK_W * CHUNK_D];
+    int top = 0;
+    for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+        int height = heights[i] * CHUNK_H;
+        tops[i] = std::min(
+            height - static_cast<int>(density.surfaceDepth),
+            std::min(static_cast<int>(density.maxHeight) + 1, CHUNK_H)
+        );
+        top = std::max(top, tops[i]);
+    }
+    int bottom = density.minHeight;
+    if (top <= bottom) {
+        return;
+    }
+
+    // coarse noise samples grid covering [bottom, top) levels
+    int bpd = density.bpd;
+    int vbpd = density.verticalBpd;
+    int sizeX = CHUNK_W / bpd + 1;
+    int sizeZ = CHUNK_D / bpd + 1;
+    int firstLayer = bottom / vbpd;
+    int sizeY = (top - 1) / vbpd - firstLayer + 2;
+    int layerSize = sizeX * sizeZ;
+    size_t count = layerSize * sizeY;
+
+    std::vector<float> xs(count);
+    std::vector<float> ys(count);
+    std::vector<float> zs(count);
+    for (int ly = 0; ly < sizeY; ly++) {
+        for (int lz = 0; lz < sizeZ; lz++) {
+            for (int lx = 0; lx < sizeX; lx++) {
+                size_t index = (ly * sizeZ + lz) * sizeX + lx;
+                xs[index] = chunkX * CHUNK_W + lx * bpd;
+                ys[index] = (firstLayer + ly) * vbpd;
+                zs[index] = chunkZ * CHUNK_D + lz * bpd;
+            }
+        }
+    }
+    std::vector<float> samples(count);
+    std::vector<float> octave(count);
+    fnl_state noise = fnlCreateState();
+    float amplitude = 1.0f;
+    float totalAmplitude = 0.0f;
+    for (uint c = 0; c < density.octaves; c++) {
+        noise.seed = static_cast<int>(seed) + static_cast<int>(c);
+        noise.frequency = density.frequency * static_cast<float>(1 << c);
+        noise_batch::noise3d(
+            noise, xs.data(), ys.data(), zs.data(), count, octave.data()
+        );
+        for (size_t i = 0; i < count; i++) {
+            samples[i] += octave[i] * amplitude;
+        }
+        totalAmplitude += amplitude;
+        amplitude *= 0.5f;
+    }
+    // scaling threshold instead of the samples
+    float threshold = density.threshold * totalAmplitude;
+
+    // trilinear interpolation: levels, then rows, then columns
+    std::vector<float> layer(layerSize);
+    float row[CHUNK_W + 1];
+    float values[CHUNK_W];
+    blockid_t block = density.rt.id;
+    for (int y = bottom; y < top; y++) {
+        int ly = y / vbpd - firstLayer;
+        float ty = static_cast<float>(y % vbpd) / vbpd;
+        const float* lower = samples.data() + ly * layerSize;
+        const float* upper = lower + layerSize;
+        for (int i = 0; i < layerSize; i++) {
+            layer[i] = lower[i] + (upper[i] - lower[i]) * ty;
+        }
+        for (int z = 0; z < CHUNK_D; z++) {
+            int lz = z / bpd;
+            float tz = static_cast<float>(z % bpd) / bpd;
+            const float* near = layer.data() + lz * sizeX;
+            const float* far = near + sizeX;
+            for (int lx = 0; lx < sizeX; lx++) {
+                row[lx] = near[lx] + (far[lx] - near[lx]) * tz;
+            }
+            for (int x = 0; x < CHUNK_W; x++) {
+                int lx = x / bpd;
+                float tx = static_cast<float>(x % bpd) / bpd;
+                values[x] = row[lx] + (row[lx + 1] - row[lx]) * tx;
+            }
+            const int* columnTops = tops + z * CHUNK_W;
+            voxel* line = voxels + vox_index(0, y, z);
+            for (int x = 0; x < CHUNK_W; x++) {
+                if (values[x] > threshold && y < columnTops[x]) {
+                    line[x] = {block, {}};
+                }
+            }
+        }
     }
 }
 
-void WorldGenerator::generatePlacements(
+glm::ivec2 WorldGenerator::generatePlacements(
     const ChunkPrototype& prototype, voxel* voxels, int chunkX, int chunkZ
-) {
+) const {
+    glm::ivec2 structAirLevels {CHUNK_H, 0};
     auto placements = prototype.placements;
     std::stable_sort(
         placements.begin(),
@@ -481,52 +1225,67 @@ void WorldGenerator::generatePlacements(
     );
     for (const auto& placement : placements) {
         if (auto structure = std::get_if<StructurePlacement>(&placement.placement)) {
-            generateStructure(prototype, *structure, voxels, chunkX, chunkZ);
+            generateStructure(
+                prototype, *structure, voxels, chunkX, chunkZ, structAirLevels
+            );
         } else {
             const auto& line = std::get<LinePlacement>(placement.placement);
-            generateLine(prototype, line, voxels, chunkX, chunkZ);
+            generateLine(
+                prototype, line, voxels, chunkX, chunkZ, structAirLevels
+            );
         }
     }
+    return structAirLevels;
 }
 
 void WorldGenerator::generateStructure(
     const ChunkPrototype& prototype, 
     const StructurePlacement& placement,
     voxel* voxels, 
-    int chunkX, int chunkZ
-) {
+    int chunkX, int chunkZ,
+    glm::ivec2& structAirLevels
+) const {
     if (placement.structure < 0 || placement.structure >= def.structures.size()) {
         logger.error() << "invalid structure index " << placement.structure;
         return;
     }
     auto& generatingStructure = def.structures[placement.structure];
     auto& structure = *generatingStructure->fragments[placement.rotation];
-    auto& structVoxels = structure.getRuntimeVoxels();
+    const auto& structVoxels = structure.getRuntimeVoxels();
+    const auto& runs = structure.getRuntimeRuns();
     const auto& offset = placement.position;
     const auto& size = structure.getSize();
 
-    for (int y = 0; y < size.y; y++) {
-        int sy = y + offset.y;
-        if (sy < 0 || sy >= CHUNK_H) {
+    // runs are ordered by Y, so skipping ones below the chunk
+    auto run = std::lower_bound(
+        runs.begin(), runs.end(), -offset.y,
+        [](const VoxelsRun& run, int y) { return run.y < y; }
+    );
+    for (; run != runs.end(); ++run) {
+        int sy = run->y + offset.y;
+        if (sy >= CHUNK_H) {
+            break;
+        }
+        int sz = run->z + offset.z;
+        if (sz < 0 || sz >= CHUNK_D) {
             continue;
         }
-        for (int z = 0; z < size.z; z++) {
-            int sz = z + offset.z;
-            if (sz < 0 || sz >= CHUNK_D) {
-                continue;
-            }
-            for (int x = 0; x < size.x; x++) {
-                int sx = x + offset.x;
-                if (sx < 0 || sx >= CHUNK_W) {
-                    continue;
-                }
-                const auto& structVoxel = 
-                    structVoxels[vox_index(x, y, z, size.x, size.z)];
-                if (structVoxel.id) {
-                    voxels[vox_index(sx, sy, sz)] = structVoxel;
-                }
-            }
+        int begin = std::max(0, run->x + offset.x);
+        int end = std::min(CHUNK_W, run->x + run->length + offset.x);
+        if (begin >= end) {
+            continue;
         }
+        if (run->structAir) {
+            structAirLevels.x = std::min(structAirLevels.x, sy);
+            structAirLevels.y = std::max(structAirLevels.y, sy + 1);
+        }
+        std::copy_n(
+            &structVoxels[vox_index(
+                begin - offset.x, run->y, run->z, size.x, size.z
+            )],
+            end - begin,
+            &voxels[vox_index(begin, sy, sz)]
+        );
     }
 }
 
@@ -534,8 +1293,9 @@ void WorldGenerator::generateLine(
     const ChunkPrototype& prototype, 
     const LinePlacement& line,
     voxel* voxels, 
-    int chunkX, int chunkZ
-) {
+    int chunkX, int chunkZ,
+    glm::ivec2& structAirLevels
+) const {
     const auto& indices = content.getIndices()->blocks;
 
     int cgx = chunkX * CHUNK_W;
@@ -555,6 +1315,11 @@ void WorldGenerator::generateLine(
     int minY = std::max(0, std::min(a.y-radius, b.y-radius));
     int maxY = std::min(CHUNK_H, std::max(a.y+radius, b.y+radius));
 
+    if (line.block == BLOCK_STRUCT_AIR && minY < maxY) {
+        structAirLevels.x = std::min(structAirLevels.x, minY);
+        structAirLevels.y = std::max(structAirLevels.y, maxY);
+    }
+
     for (int y = minY; y < maxY; y++) {
         for (int z = minZ; z < maxZ; z++) {
             for (int x = minX; x < maxX; x++) {
@@ -609,6 +1374,14 @@ WorldGenDebugInfo WorldGenerator::createDebugInfo() const {
     };
 }
 
+const WorldGenProfile& WorldGenerator::getProfile() const {
+    return profiler.getProfile();
+}
+
+void WorldGenerator::setProfileInterval(uint64_t interval) {
+    profiler.setInterval(interval);
+}
+
 uint64_t WorldGenerator::getSeed() const {
     return seed;
 }
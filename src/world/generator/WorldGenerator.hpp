@@ -2,17 +2,24 @@
 
 #include <array>
 #include <string>
+#include <mutex>
 #include <memory>
 #include <vector>
+#include <functional>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "constants.hpp"
 #include "typedefs.hpp"
 #include "voxels/voxel.hpp"
+#include "util/AreaMap2D.hpp"
 #include "SurroundMap.hpp"
 #include "StructurePlacement.hpp"
+#include "GeneratorProfiler.hpp"
 
 class Content;
+class PrototypesStorage;
+class GeneratorScript;
 struct GeneratorDef;
 class Heightmap;
 struct Biome;
@@ -35,6 +42,22 @@ struct ChunkPrototype {
 
     /// @brief biome parameters maps saved until heightmaps generation
     std::vector<std::shared_ptr<Heightmap>> heightmapInputs {};
+
+    /// @brief heightmap inputs of the whole chunks batch (if batching
+    /// is enabled) saved until heightmaps generation
+    std::shared_ptr<const std::vector<std::shared_ptr<Heightmap>>>
+        batchHeightmapInputs;
+
+    /// @brief placements returned by the generator script worker in
+    /// advance (see WorldGenerator::generateAhead)
+    std::unique_ptr<std::vector<Placement>> aheadPlacements;
+
+    /// @brief biomes and heightmap are loaded from or written to
+    /// the prototypes storage
+    bool stored = false;
+
+    /// @brief Clear prototype to reuse it for another chunk
+    void reset();
 };
 
 struct WorldGenDebugInfo {
@@ -45,25 +68,87 @@ struct WorldGenDebugInfo {
     std::unique_ptr<ubyte[]> areaLevels;
 };
 
+struct PrototypesBatch;
+struct PrototypesBatchResult;
+
+namespace util {
+    template <class T, class R>
+    class ThreadPool;
+}
+
 /// @brief High-level world generation controller
 class WorldGenerator {
+    friend class PrototypesWorker;
+
+    using PrototypeFinder = std::function<ChunkPrototype*(int, int)>;
+
     /// @param def generator definition
     const GeneratorDef& def;
     /// @param content world content
     const Content& content;
     /// @param seed world seed
     uint64_t seed;
-    /// @brief Chunk prototypes main storage
-    std::unordered_map<glm::ivec2, std::unique_ptr<ChunkPrototype>> prototypes;
     /// @brief Chunk prototypes loading surround map
     SurroundMap surroundMap;
+    /// @brief Chunk prototypes main storage. Window is moved and resized
+    /// with the surround map area, so a prototype exists where the
+    /// surround map level is not zero
+    util::AreaMap2D<ChunkPrototype*> prototypes;
+    /// @brief All allocated chunk prototypes
+    std::vector<std::unique_ptr<ChunkPrototype>> prototypesPool;
+    /// @brief Released chunk prototypes available for reuse
+    std::vector<ChunkPrototype*> freePrototypes;
+    /// @brief Released chunk heightmaps available for reuse
+    mutable std::vector<std::shared_ptr<Heightmap>> freeHeightmaps;
+    mutable std::mutex heightmapsMutex;
+    /// @brief Width of chunks batch (see GeneratorDef::batchChunks)
+    int batchSize;
+    /// @brief Optional persistent prototypes storage
+    PrototypesStorage* prototypesStorage = nullptr;
+    /// @brief Hash of the generator name, seed and biomes used to discard
+    /// prototypes stored with other generator settings
+    uint32_t prototypesFingerprint;
+    /// @brief Isolated generator script instances used by generateAhead
+    std::vector<std::unique_ptr<GeneratorScript>> workers;
+    /// @brief Prototypes generated in advance by workers, moved to the
+    /// main storage when requested by the surround map
+    std::unordered_map<glm::ivec2, ChunkPrototype*> aheadPrototypes;
+    /// @brief Positions of prototypes being generated ahead by workers
+    std::unordered_set<glm::ivec2> aheadPending;
+    /// @brief Workers pool kept between startAhead calls
+    std::unique_ptr<util::ThreadPool<
+        std::shared_ptr<PrototypesBatch>, PrototypesBatchResult>>
+        aheadPool;
+    /// @brief Number of enqueued batches not consumed yet
+    size_t aheadRemaining = 0;
+    /// @brief Stages time counters, updated from const generateVoxels too
+    mutable GeneratorProfiler profiler;
+
+    /// @brief Write prototype biomes and heightmap to the prototypes storage
+    void storePrototype(ChunkPrototype& prototype, int x, int z);
+
+    /// @brief Read prototype biomes and heightmap from the prototypes storage
+    /// @return false if prototype is not stored or stored data is outdated
+    bool loadPrototype(ChunkPrototype& prototype, int x, int z);
 
     /// @brief Generate chunk prototype (see ChunkPrototype)
     /// @param x chunk position X divided by CHUNK_W
     /// @param z chunk position Y divided by CHUNK_D
-    std::unique_ptr<ChunkPrototype> generatePrototype(int x, int z);
+    /// @return prototype taken from the pool
+    ChunkPrototype* generatePrototype(int x, int z);
+
+    /// @brief Take empty prototype from the pool
+    ChunkPrototype* acquirePrototype();
+
+    /// @brief Bring prototype back to the pool
+    void releasePrototype(ChunkPrototype* prototype);
+
+    /// @brief Take CHUNK_W x CHUNK_D heightmap from the pool.
+    /// Thread-safe
+    std::shared_ptr<Heightmap> acquireHeightmap() const;
 
     ChunkPrototype& requirePrototype(int x, int z);
+    const ChunkPrototype& requirePrototype(int x, int z) const;
 
     void generateStructuresWide(ChunkPrototype& prototype, int x, int z);
 
@@ -73,6 +158,41 @@ class WorldGenerator {
 
     void generateHeightmap(ChunkPrototype& prototype, int x, int z);
 
+    /// @brief Get finder of prototypes in the main storage
+    PrototypeFinder findPrototypes();
+
+    /// @brief Generate biomes for all prototypes of the chunks batch
+    /// containing the chunk
+    /// @param script generator script instance to use
+    /// @param find prototypes finder returning nullptr for chunks to skip
+    void generateBiomesBatch(
+        GeneratorScript& script, int x, int z, const PrototypeFinder& find
+    ) const;
+
+    /// @brief Generate heightmaps for all prototypes of the chunks batch
+    /// containing the chunk
+    /// @param script generator script instance to use
+    /// @param find prototypes finder returning nullptr for chunks to skip
+    void generateHeightmapsBatch(
+        GeneratorScript& script,
+        int x,
+        int z,
+        const std::vector<std::shared_ptr<Heightmap>>& inputs,
+        const PrototypeFinder& find
+    ) const;
+
+    /// @brief Generate biomes, heightmaps and placements of the batch
+    /// prototypes using worker script instance. Called from worker threads
+    void generateBatchAhead(
+        GeneratorScript& script, PrototypesBatch& batch
+    ) const;
+
+    /// @brief Choose biomes using chunk biome parameter maps
+    void chooseBiomes(
+        ChunkPrototype& prototype,
+        std::vector<std::shared_ptr<Heightmap>>& parameters
+    ) const;
+
     void placeStructure(
         const StructurePlacement& placement, int priority, 
         int chunkX, int chunkZ
@@ -80,21 +200,28 @@ class WorldGenerator {
 
     void placeLine(const LinePlacement& line, int priority);
 
-    void generatePlacements(
+    /// @return range of levels where struct air may be placed
+    glm::ivec2 generatePlacements(
         const ChunkPrototype& prototype, voxel* voxels, int x, int z
-    );
+    ) const;
+    /// @param structAirLevels range of levels to extend with placed
+    /// struct air
     void generateLine(
         const ChunkPrototype& prototype, 
         const LinePlacement& placement,
         voxel* voxels, 
-        int x, int z
-    );
+        int x, int z,
+        glm::ivec2& structAirLevels
+    ) const;
+    /// @param structAirLevels range of levels to extend with placed
+    /// struct air
     void generateStructure(
         const ChunkPrototype& prototype, 
         const StructurePlacement& placement,
         voxel* voxels, 
-        int x, int z
-    );
+        int x, int z,
+        glm::ivec2& structAirLevels
+    ) const;
     void generatePlants(
         const ChunkPrototype& prototype,
         float* values,
@@ -102,7 +229,9 @@ class WorldGenerator {
         int x,
         int z,
         const Biome** biomes
-    );
+    ) const;
+    /// @brief Fill chunk with biome layers. Columns are converted
+    /// to runs of blocks and written level by level
     void generateLand(
         const ChunkPrototype& prototype,
         float* values,
@@ -110,7 +239,12 @@ class WorldGenerator {
         int x,
         int z,
         const Biome** biomes
-    );
+    ) const;
+
+    /// @brief Carve ground using 3D density field (see DensityCarving)
+    void generateDensity(
+        const float* heights, voxel* voxels, int x, int z
+    ) const;
 
     void placeStructures(
         const std::vector<Placement>& placements,
@@ -127,13 +261,71 @@ public:
 
     void update(int centerX, int centerY, int loadDistance);
 
+    /// @brief Set persistent storage used to cache biomes and heightmaps
+    /// of generated prototypes
+    /// @param storage prototypes storage or nullptr to disable caching
+    void setPrototypesStorage(PrototypesStorage* storage);
+
+    /// @brief Create isolated generator script instances for generateAhead
+    /// @param count number of instances
+    /// @return false if the generator script does not support concurrent
+    /// instances
+    bool createWorkers(uint count);
+
+    /// @brief Generate biomes, heightmaps and structure placements of
+    /// not loaded prototypes concurrently using generator script workers
+    /// (see createWorkers). Result is the same as generated by the main
+    /// generator script. Must be called from the main thread only.
+    /// Blocks until all prototypes are generated
+    /// @param chunks chunks positions
+    void generateAhead(const std::vector<glm::ivec2>& chunks);
+
+    /// @brief Non-blocking variant of generateAhead. Enqueues prototypes
+    /// generation to workers, results are collected by updateAhead.
+    /// Other generator methods must not be called until updateAhead
+    /// returns true
+    /// @param chunks chunks positions
+    void startAhead(const std::vector<glm::ivec2>& chunks);
+
+    /// @brief Collect prototypes generated ahead by workers.
+    /// Must be called from the main thread only
+    /// @return true if no prototypes generation is pending
+    bool updateAhead();
+
+    /// @brief Get width of chunks batch generated by one script call
+    int getBatchSize() const {
+        return batchSize;
+    }
+
     /// @brief Generate complete chunk voxels
     /// @param voxels destinatiopn chunk voxels buffer
     /// @param x chunk position X divided by CHUNK_W
     /// @param z chunk position Y divided by CHUNK_D
     void generate(voxel* voxels, int x, int z);
 
+    /// @brief Complete chunk prototype required for generateVoxels.
+    /// Calls generator script, so must be called from the main thread only
+    /// @param x chunk position X divided by CHUNK_W
+    /// @param z chunk position Y divided by CHUNK_D
+    void prepare(int x, int z);
+
+    /// @brief Generate chunk voxels using prototype completed with prepare.
+    /// May be called from multiple threads while prepare and update are
+    /// not called
+    /// @param voxels destinatiopn chunk voxels buffer
+    /// @param x chunk position X divided by CHUNK_W
+    /// @param z chunk position Y divided by CHUNK_D
+    void generateVoxels(voxel* voxels, int x, int z) const;
+
     WorldGenDebugInfo createDebugInfo() const;
 
+    /// @brief Get generator stages statistics of the last completed
+    /// interval (see GeneratorProfiler). Interval is completed by update
+    const WorldGenProfile& getProfile() const;
+
+    /// @brief Set minimal profiling interval in microseconds
+    /// (see GeneratorProfiler::INTERVAL)
+    void setProfileInterval(uint64_t interval);
+
     uint64_t getSeed() const;
 };
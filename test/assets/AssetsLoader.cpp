@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+#include "assets/Assets.hpp"
+#include "assets/AssetsLoader.hpp"
+#include "audio/audio.hpp"
+#include "engine/Engine.hpp"
+#include "io/devices/StdfsDevice.hpp"
+#include "io/engine_paths.hpp"
+#include "settings.hpp"
+#include "util/data_io.hpp"
+
+namespace fs = std::filesystem;
+
+/// @brief Write 16-bit mono PCM WAV file
+static void write_wav(const io::path& file, int samples) {
+    std::vector<ubyte> bytes(44 + samples * 2);
+    auto put = [&bytes](size_t offset, const char* tag) {
+        std::memcpy(bytes.data() + offset, tag, 4);
+    };
+    auto put32 = [&bytes](size_t offset, uint32_t value) {
+        for (int i = 0; i < 4; i++) {
+            bytes[offset + i] = value >> (i * 8);
+        }
+    };
+    put(0, "RIFF");
+    put32(4, bytes.size() - 8);
+    put(8, "WAVE");
+    put(12, "fmt ");
+    put32(16, 16);
+    put32(20, 1 | (1 << 16)); // PCM, mono
+    put32(24, 8000); // sample rate
+    put32(28, 8000 * 2); // byte rate
+    put32(32, 2 | (16 << 16)); // block align, bits per sample
+    put(36, "data");
+    put32(40, samples * 2);
+    for (int i = 0; i < samples; i++) {
+        bytes[44 + i * 2 + 1] = i % 64;
+    }
+    io::write_bytes(file, bytes.data(), bytes.size());
+}
+
+TEST(AssetsLoader, HeadlessSounds) {
+    auto root = fs::temp_directory_path() / "voxelcore-assets-test";
+    fs::remove_all(root);
+    fs::create_directories(root / "sounds");
+    io::set_device("assetstest", std::make_shared<io::StdfsDevice>(root));
+    write_wav("assetstest:sounds/click.wav", 8000);
+    write_wav("assetstest:sounds/step_0.wav", 4000);
+    write_wav("assetstest:sounds/step_1.wav", 4000);
+
+    // no audio device: PCM is decoded in workers without samples
+    AudioSettings settings;
+    audio::initialize(false, settings);
+    ASSERT_TRUE(audio::is_dummy());
+    {
+        Engine engine;
+        Assets assets;
+        ResPaths paths({PathsRoot("test", "assetstest:")});
+        AssetsLoader loader(engine, assets, paths);
+        loader.add(AssetType::SOUND, "sounds/click", "click");
+        loader.add(AssetType::SOUND, "sounds/step", "step");
+        loader.loadAll(2);
+
+        auto click = assets.get<audio::Sound>("click");
+        ASSERT_NE(click, nullptr);
+        EXPECT_DOUBLE_EQ(click->getDuration(), 1.0);
+        EXPECT_TRUE(click->variants.empty());
+
+        auto step = assets.get<audio::Sound>("step");
+        ASSERT_NE(step, nullptr);
+        EXPECT_DOUBLE_EQ(step->getDuration(), 0.5);
+        EXPECT_EQ(step->variants.size(), 1);
+
+        loader.add(AssetType::SOUND, "sounds/missing", "missing");
+        EXPECT_THROW(loader.loadAll(2), assetload::error);
+    }
+    audio::close();
+    io::remove_device("assetstest");
+    fs::remove_all(root);
+}
+
+TEST(AssetsLoader, FinalizeOrder) {
+    Engine engine;
+    Assets assets;
+    ResPaths paths;
+    AssetsLoader loader(engine, assets, paths);
+
+    std::vector<std::string> finalized;
+    loader.addLoader(
+        AssetType::TEXTURE,
+        [&finalized](
+            AssetsLoader* loader,
+            const ResPaths&,
+            const std::string& file,
+            const std::string& name,
+            const std::shared_ptr<AssetCfg>&
+        ) -> assetload::postfunc {
+            // the first assets are decoded last
+            int index = std::stoi(file);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10 - index));
+            if (index == 0) {
+                // enqueued by a worker
+                loader->add(AssetType::TEXTURE, "10", "from-worker");
+            }
+            return [&finalized, loader, index, name](auto) {
+                finalized.push_back(name);
+                if (index == 1) {
+                    // enqueued while finalizing
+                    loader->add(AssetType::TEXTURE, "10", "from-postfunc");
+                }
+            };
+        }
+    );
+    for (int i = 0; i < 8; i++) {
+        loader.add(AssetType::TEXTURE, std::to_string(i), "t" + std::to_string(i));
+    }
+    loader.loadAll(4);
+
+    ASSERT_EQ(finalized.size(), 10);
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(finalized[i], "t" + std::to_string(i));
+    }
+    EXPECT_EQ(finalized[8], "from-worker");
+    EXPECT_EQ(finalized[9], "from-postfunc");
+    EXPECT_FALSE(loader.hasNext());
+}
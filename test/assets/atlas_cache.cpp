@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "assets/atlas_cache.hpp"
+#include "graphics/core/Atlas.hpp"
+#include "graphics/core/ImageData.hpp"
+
+TEST(atlas_cache, EncodeDecode) {
+    auto image = std::make_unique<ImageData>(ImageFormat::rgba8888, 64, 32);
+    ubyte* data = image->getData();
+    for (size_t i = 0; i < image->getDataSize(); i++) {
+        data[i] = i * 31 % 251;
+    }
+    std::unordered_map<std::string, UVRegion> regions;
+    regions["stone"] = UVRegion(0.0f, 0.0f, 0.25f, 0.5f);
+    regions["dirt"] = UVRegion(0.25f, 0.5f, 0.5f, 1.0f);
+    Atlas atlas(std::move(image), regions, false);
+
+    auto bytes = atlas_cache::encode(atlas, 42);
+    EXPECT_EQ(atlas_cache::decode(bytes.data(), bytes.size(), 43), nullptr);
+
+    auto decoded = atlas_cache::decode(bytes.data(), bytes.size(), 42);
+    ASSERT_NE(decoded, nullptr);
+    const auto& srcImage = *atlas.getImage();
+    const auto& dstImage = *decoded->getImage();
+    EXPECT_EQ(dstImage.getWidth(), srcImage.getWidth());
+    EXPECT_EQ(dstImage.getHeight(), srcImage.getHeight());
+    EXPECT_EQ(dstImage.getFormat(), srcImage.getFormat());
+    EXPECT_EQ(
+        std::memcmp(
+            dstImage.getData(), srcImage.getData(), srcImage.getDataSize()
+        ),
+        0
+    );
+    ASSERT_EQ(decoded->getRegions().size(), regions.size());
+    for (const auto& [name, region] : regions) {
+        const auto& found = decoded->get(name);
+        EXPECT_EQ(found.u1, region.u1);
+        EXPECT_EQ(found.v1, region.v1);
+        EXPECT_EQ(found.u2, region.u2);
+        EXPECT_EQ(found.v2, region.v2);
+    }
+    auto corrupted = bytes;
+    // image width follows magic, version, key and format
+    std::memset(corrupted.data() + 21, 0xFF, 4);
+    EXPECT_THROW(
+        atlas_cache::decode(corrupted.data(), corrupted.size(), 42),
+        std::runtime_error
+    );
+    bytes.resize(bytes.size() / 2);
+    EXPECT_THROW(
+        atlas_cache::decode(bytes.data(), bytes.size(), 42), std::runtime_error
+    );
+}
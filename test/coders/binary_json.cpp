@@ -2,6 +2,7 @@
 
 #include "util/Buffer.hpp"
 #include "coders/binary_json.hpp"
+#include "coders/byte_utils.hpp"
 
 TEST(BJSON, EncodeDecode) {
     const std::string name = "JSON-encoder";
@@ -36,3 +37,58 @@ TEST(BJSON, EncodeDecode) {
         }
     }
 }
+
+TEST(BJSON, NestedDocuments) {
+    auto object = dv::object();
+    auto& inner = object.object("inner");
+    auto& list = inner.list("list");
+    list.add(1);
+    list.add(2.5);
+    list.add("three");
+    list.add(dv::object());
+    inner.object("deeper")["value"] = 70000;
+    object["after"] = "tail";
+
+    ByteBuilder builder;
+    builder.put(42);
+    json::to_binary(builder, object);
+    auto bytes = builder.build();
+
+    // same bytes as standalone document
+    auto standalone = json::to_binary(object);
+    EXPECT_TRUE(std::equal(standalone.begin(), standalone.end(), bytes.begin() + 1));
+
+    ByteReader reader(bytes.data() + 1, bytes.size() - 1);
+    auto decoded = json::from_binary(reader);
+    EXPECT_FALSE(reader.hasNext());
+    EXPECT_EQ(decoded["inner"]["deeper"]["value"].asInteger(), 70000);
+    EXPECT_EQ(decoded["inner"]["list"][2].asString(), "three");
+    EXPECT_EQ(decoded["after"].asString(), "tail");
+}
+
+TEST(BJSON, ReadSubset) {
+    auto object = dv::object();
+    auto& skipped = object.list("skipped");
+    skipped.add(dv::object());
+    skipped.add("text");
+    skipped.add(1e10);
+    skipped.add(true);
+    object.object("nested")["large"] = dv::objects::Bytes(1000);
+    object["wanted"] = 7;
+    auto bytes = json::to_binary(object);
+
+    ByteReader reader(bytes);
+    std::vector<std::string> keys;
+    dv::value wanted;
+    json::read_binary_object(reader, [&](auto key, ByteReader& reader) {
+        keys.emplace_back(key);
+        if (key == "wanted") {
+            wanted = json::from_binary(reader);
+        } else if (key == "skipped") {
+            json::skip_binary(reader);
+        }
+    });
+    EXPECT_FALSE(reader.hasNext());
+    EXPECT_EQ(keys.size(), 3);
+    EXPECT_EQ(wanted.asInteger(), 7);
+}
@@ -40,3 +40,27 @@ TEST(JSON, EncodeDecode) {
         }
     }
 }
+
+TEST(JSON, StringsAndNumbers) {
+    std::string long_string(100, 'a');
+    auto value = json::parse(
+        "{\"plain\": \"" + long_string + "\", \"escaped\": \"" + long_string +
+        "\\n\\\"\\u0041\", "
+        "\"numbers\": [0, -12, 9223372036854775807, 0.1, -123.456, 1e-5, "
+        "2.5E+3, 0x1F, 12345678901234567890.5]}"
+    );
+    EXPECT_EQ(value["plain"].asString(), long_string);
+    EXPECT_EQ(value["escaped"].asString(), long_string + "\n\"A");
+
+    const auto& numbers = value["numbers"];
+    EXPECT_EQ(numbers[0].getType(), dv::value_type::integer);
+    EXPECT_EQ(numbers[1].asInteger(), -12);
+    EXPECT_EQ(numbers[2].asInteger(), INT64_MAX);
+    EXPECT_EQ(numbers[3].asNumber(), 0.1);
+    EXPECT_EQ(numbers[4].asNumber(), -123.456);
+    EXPECT_EQ(numbers[5].asNumber(), 1e-5);
+    EXPECT_EQ(numbers[6].getType(), dv::value_type::number);
+    EXPECT_EQ(numbers[6].asNumber(), 2500.0);
+    EXPECT_EQ(numbers[7].asInteger(), 31);
+    EXPECT_NEAR(numbers[8].asNumber(), 12345678901234567890.5, 1e5);
+}
@@ -48,3 +48,21 @@ TEST(ExtRLE16, EncodeDecode) {
     test_encode_decode(extrle::encode16, extrle::decode16, 13);
     test_encode_decode(extrle::encode16, extrle::decode16, 90123);
 }
+
+TEST(ExtRLE16, DecodeBounded) {
+    const size_t size = 1000;
+    uint8_t initial[size] {};
+    uint8_t encoded[size * 2];
+    size_t encoded_size = extrle::encode16(initial, size, encoded);
+
+    uint8_t decoded[size];
+    EXPECT_EQ(extrle::decode16(encoded, encoded_size, decoded, size), size);
+    EXPECT_THROW(
+        extrle::decode16(encoded, encoded_size, decoded, size / 2),
+        std::runtime_error
+    );
+    EXPECT_THROW(
+        extrle::decode16(encoded, encoded_size - 1, decoded, size),
+        std::runtime_error
+    );
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "content/ContentPack.hpp"
+#include "content/loading/PreloadedDefs.hpp"
+#include "io/devices/StdfsDevice.hpp"
+
+namespace fs = std::filesystem;
+
+static std::vector<ContentPack> create_packs(const fs::path& root) {
+    fs::create_directories(root / "pack" / "blocks");
+    fs::create_directories(root / "pack" / "items");
+    io::set_device("defstest", std::make_shared<io::StdfsDevice>(root));
+
+    ContentPack pack;
+    pack.id = "pack";
+    pack.folder = "defstest:pack";
+    return {pack};
+}
+
+TEST(PreloadedDefs, Preload) {
+    auto root = fs::temp_directory_path() / "voxelcore-defs-test";
+    fs::remove_all(root);
+    auto packs = create_packs(root);
+    io::write_string("defstest:pack/blocks/stone.json", R"({"hardness": 2})");
+    io::write_string("defstest:pack/items/stick.toml", "stack-size = 16");
+    io::write_string("defstest:pack/blocks/broken.json", "{\"hardness\": ");
+
+    PreloadedDefs defs;
+    defs.preload(packs, 2);
+    EXPECT_EQ(defs.size(), 3);
+    EXPECT_EQ(
+        defs.read("defstest:pack/blocks/stone.json")["hardness"].asInteger(), 2
+    );
+    EXPECT_EQ(
+        defs.read("defstest:pack/items/stick.toml")["stack-size"].asInteger(),
+        16
+    );
+    // parsing error is thrown when the file is requested
+    EXPECT_ANY_THROW(defs.read("defstest:pack/blocks/broken.json"));
+
+    io::remove_device("defstest");
+    fs::remove_all(root);
+}
+
+TEST(PreloadedDefs, CacheInvalidation) {
+    auto root = fs::temp_directory_path() / "voxelcore-defs-cache-test";
+    fs::remove_all(root);
+    auto packs = create_packs(root);
+    auto file = root / "pack" / "blocks" / "stone.json";
+    io::write_string("defstest:pack/blocks/stone.json", R"({"hardness": 2})");
+    auto writeTime = fs::last_write_time(file);
+    io::path cacheFile = "defstest:cache/defs.bjson";
+    {
+        PreloadedDefs defs(cacheFile);
+        defs.preload(packs);
+    }
+    ASSERT_TRUE(io::is_regular_file(cacheFile));
+
+    // same size and modification time: restored from the cache
+    io::write_string("defstest:pack/blocks/stone.json", R"({"hardness": 7})");
+    fs::last_write_time(file, writeTime);
+    {
+        PreloadedDefs defs(cacheFile);
+        defs.preload(packs);
+        EXPECT_EQ(
+            defs.read("defstest:pack/blocks/stone.json")["hardness"].asInteger(),
+            2
+        );
+    }
+    // modified file is parsed again
+    fs::last_write_time(file, writeTime + std::chrono::seconds(10));
+    {
+        PreloadedDefs defs(cacheFile);
+        defs.preload(packs);
+        EXPECT_EQ(
+            defs.read("defstest:pack/blocks/stone.json")["hardness"].asInteger(),
+            7
+        );
+    }
+    // new file changes the hash too
+    io::write_string("defstest:pack/items/stick.toml", "stack-size = 16");
+    {
+        PreloadedDefs defs(cacheFile);
+        defs.preload(packs);
+        EXPECT_EQ(defs.size(), 2);
+    }
+    io::remove_device("defstest");
+    fs::remove_all(root);
+}
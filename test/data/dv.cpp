@@ -27,3 +27,88 @@ TEST(dv, dv) {
         }
     }
 }
+
+TEST(dv, ObjectManyKeys) {
+    auto object = dv::object();
+    for (int i = 0; i < 1000; i++) {
+        object[std::to_string(i)] = i;
+    }
+    auto& first = object["0"];
+    object["1000"] = 1000;
+    // references stay valid after insertion
+    EXPECT_EQ(first.asInteger(), 0);
+
+    object.erase("500");
+    object.erase("missing");
+    EXPECT_EQ(object.size(), 1000);
+    EXPECT_FALSE(object.has("500"));
+    EXPECT_TRUE(object.has("501"));
+
+    int expected = 0;
+    for (const auto& [key, value] : object.asObject()) {
+        if (expected == 500) {
+            expected++;
+        }
+        EXPECT_EQ(key, std::to_string(expected));
+        EXPECT_EQ(value.asInteger(), expected);
+        expected++;
+    }
+    EXPECT_EQ(expected, 1001);
+
+    object["500"] = "again";
+    EXPECT_EQ(object["500"].asString(), "again");
+    EXPECT_EQ(object.size(), 1001);
+}
+
+TEST(dv, ObjectErasedReuse) {
+    auto object = dv::object();
+    auto& kept = object["kept"];
+    kept = -1;
+    for (int i = 0; i < 20; i++) {
+        object[std::to_string(i)] = i;
+    }
+    for (int i = 20; i < 10000; i++) {
+        object.erase(std::to_string(i - 20));
+        object[std::to_string(i)] = i;
+        ASSERT_EQ(object.size(), 21);
+    }
+    // references to other entries stay valid
+    EXPECT_EQ(&kept, &object["kept"]);
+    EXPECT_EQ(kept.asInteger(), -1);
+    for (int i = 9980; i < 10000; i++) {
+        EXPECT_EQ(object[std::to_string(i)].asInteger(), i);
+    }
+    EXPECT_FALSE(object.has("9979"));
+
+    int count = 0;
+    for (const auto& [key, value] : object.asObject()) {
+        if (key != "kept") {
+            EXPECT_EQ(key, std::to_string(value.asInteger()));
+        }
+        count++;
+    }
+    EXPECT_EQ(count, 21);
+}
+
+TEST(dv, ArenaScope) {
+    dv::value root;
+    {
+        dv::ArenaScope arena;
+        root = dv::object();
+        auto& list = root.list("list");
+        for (int i = 0; i < 100; i++) {
+            list.object()["value"] = i;
+        }
+    }
+    // arena is kept alive by allocated values
+    auto element = root["list"][42];
+    root = nullptr;
+    EXPECT_EQ(element["value"].asInteger(), 42);
+
+    // growing out of the scope
+    for (int i = 0; i < 100; i++) {
+        element[std::to_string(i)] = i;
+    }
+    EXPECT_EQ(element["99"].asInteger(), 99);
+    EXPECT_EQ(element["value"].asInteger(), 42);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "debug/binary_log.hpp"
+
+using namespace debug;
+
+TEST(binary_log, EncodeDecode) {
+    std::stringstream stream;
+    binary_log::Encoder encoder;
+    encoder.writeHeader(stream);
+
+    std::vector<LogRecord> records {
+        {LogLevel::info, 1700000000123456, "engine", "started"},
+        {LogLevel::warning, 1700000001000000, "network", "timeout"},
+        {LogLevel::error, 1700000002000000, "engine", "multi\nline"},
+    };
+    for (const auto& record : records) {
+        encoder.write(stream, record);
+    }
+
+    std::stringstream text;
+    EXPECT_EQ(binary_log::decode(stream, text), records.size());
+
+    std::stringstream expected;
+    for (const auto& record : records) {
+        expected << format_log_record(record) << '\n';
+    }
+    EXPECT_EQ(text.str(), expected.str());
+
+    std::stringstream truncated(stream.str().substr(0, 30));
+    std::stringstream output;
+    EXPECT_THROW(binary_log::decode(truncated, output), std::runtime_error);
+
+    // corrupted message length must not be allocated
+    std::stringstream single;
+    binary_log::Encoder singleEncoder;
+    singleEncoder.writeHeader(single);
+    singleEncoder.write(single, records[0]);
+    std::string corrupted = single.str();
+    size_t lengthOffset = corrupted.length() - records[0].message.length() - 4;
+    corrupted.replace(lengthOffset, 4, "\xF0\xFF\xFF\xFF");
+    std::stringstream corruptedStream(corrupted);
+    EXPECT_THROW(
+        binary_log::decode(corruptedStream, output), std::runtime_error
+    );
+}
+
+TEST(Logger, LevelFiltering) {
+    Logger logger("test");
+    logger.setLevel(LogLevel::warning);
+    EXPECT_FALSE(logger.isEnabled(LogLevel::debug));
+    EXPECT_FALSE(logger.isEnabled(LogLevel::info));
+    EXPECT_TRUE(logger.isEnabled(LogLevel::warning));
+    EXPECT_TRUE(logger.isEnabled(LogLevel::error));
+    EXPECT_TRUE(logger.isEnabled(LogLevel::print));
+}
+
+static size_t count_lines(const std::string& filename, const std::string& text) {
+    std::ifstream file(filename);
+    std::string line;
+    size_t count = 0;
+    while (std::getline(file, line)) {
+        if (line.find(text) != std::string::npos) {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST(Logger, AsyncShutdown) {
+    auto filename =
+        (std::filesystem::temp_directory_path() / "logger_test.log").u8string();
+    Logger::init(filename, LogFormat::text, true);
+
+    Logger logger("logtest");
+    logger.setLevel(LogLevel::info);
+    logger.error() << "fatal";
+    // error records are written before log returns
+    EXPECT_EQ(count_lines(filename, "logtest] fatal"), 1);
+
+    const int threadsCount = 4;
+    const int messagesCount = 200;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadsCount; i++) {
+        threads.emplace_back([&logger]() {
+            for (int j = 0; j < messagesCount; j++) {
+                logger.info() << "message " << j;
+            }
+        });
+    }
+    // records pushed concurrently with the shutdown must not be lost
+    Logger::shutdown();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    Logger::flush();
+    EXPECT_EQ(
+        count_lines(filename, "logtest] message"),
+        threadsCount * messagesCount
+    );
+}
@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+
+#include "coders/imageio.hpp"
+#include "graphics/core/ImageData.hpp"
+#include "io/devices/StdfsDevice.hpp"
+#include "io/io.hpp"
+
+static ubyte value_at(uint x, uint y, uint c) {
+    return (x * 7 + y * 13 + c * 61) % 256;
+}
+
+static std::unique_ptr<ImageData> create_image(
+    ImageFormat format, uint width, uint height
+) {
+    auto image = std::make_unique<ImageData>(format, width, height);
+    uint comps = format == ImageFormat::rgba8888 ? 4 : 3;
+    ubyte* data = image->getData();
+    for (uint y = 0; y < height; y++) {
+        for (uint x = 0; x < width; x++) {
+            for (uint c = 0; c < comps; c++) {
+                data[(y * width + x) * comps + c] = value_at(x, y, c);
+            }
+        }
+    }
+    return image;
+}
+
+TEST(ImageData, Flip) {
+    for (auto format : {ImageFormat::rgb888, ImageFormat::rgba8888}) {
+        uint comps = format == ImageFormat::rgba8888 ? 4 : 3;
+        const uint width = 37;
+        const uint height = 5;
+        auto image = create_image(format, width, height);
+        image->flipX();
+        const ubyte* data = image->getData();
+        for (uint y = 0; y < height; y++) {
+            for (uint x = 0; x < width; x++) {
+                for (uint c = 0; c < comps; c++) {
+                    ASSERT_EQ(
+                        data[(y * width + x) * comps + c],
+                        value_at(width - x - 1, y, c)
+                    );
+                }
+            }
+        }
+        image->flipX();
+        image->flipY();
+        for (uint y = 0; y < height; y++) {
+            for (uint x = 0; x < width; x++) {
+                for (uint c = 0; c < comps; c++) {
+                    ASSERT_EQ(
+                        data[(y * width + x) * comps + c],
+                        value_at(x, height - y - 1, c)
+                    );
+                }
+            }
+        }
+    }
+}
+
+TEST(ImageData, Blit) {
+    ImageData dst(ImageFormat::rgba8888, 10, 10);
+    std::memset(dst.getData(), 0, dst.getDataSize());
+    auto src = create_image(ImageFormat::rgb888, 4, 4);
+    dst.blit(*src, -1, 8);
+    dst.blit(*src, 20, 20);
+    const ubyte* data = dst.getData();
+    for (uint y = 0; y < 10; y++) {
+        for (uint x = 0; x < 10; x++) {
+            const ubyte* pixel = data + (y * 10 + x) * 4;
+            if (x < 3 && y >= 8) {
+                for (uint c = 0; c < 3; c++) {
+                    EXPECT_EQ(pixel[c], value_at(x + 1, y - 8, c));
+                }
+                EXPECT_EQ(pixel[3], 255);
+            } else {
+                EXPECT_EQ(pixel[3], 0);
+            }
+        }
+    }
+}
+
+TEST(ImageData, Extrude) {
+    auto image = create_image(ImageFormat::rgba8888, 8, 8);
+    image->extrude(2, 2, 3, 3);
+    const ubyte* data = image->getData();
+    auto pixel = [data](int x, int y) {
+        uint32_t value;
+        std::memcpy(&value, data + (y * 8 + x) * 4, 4);
+        return value;
+    };
+    for (int i = 2; i < 5; i++) {
+        EXPECT_EQ(pixel(1, i), pixel(2, i));
+        EXPECT_EQ(pixel(5, i), pixel(4, i));
+        EXPECT_EQ(pixel(i, 1), pixel(i, 2));
+        EXPECT_EQ(pixel(i, 5), pixel(i, 4));
+    }
+    EXPECT_EQ(pixel(1, 1), pixel(2, 2));
+    EXPECT_EQ(pixel(5, 1), pixel(4, 2));
+    EXPECT_EQ(pixel(1, 5), pixel(2, 4));
+    EXPECT_EQ(pixel(5, 5), pixel(4, 4));
+}
+
+TEST(ImageData, FixAlphaColor) {
+    ImageData image(ImageFormat::rgba8888, 7, 1);
+    const ubyte pixels[] {
+        10, 20, 30, 255,
+        0, 0, 0, 0,
+        20, 40, 60, 1,
+        0, 0, 0, 0,
+        30, 60, 90, 128,
+        0, 0, 0, 0,
+        40, 80, 120, 255,
+    };
+    std::memcpy(image.getData(), pixels, sizeof(pixels));
+    image.fixAlphaColor();
+    const ubyte* data = image.getData();
+    for (uint i = 0; i < 7; i++) {
+        if (i % 2) {
+            EXPECT_EQ(data[i * 4], 25);
+            EXPECT_EQ(data[i * 4 + 1], 50);
+            EXPECT_EQ(data[i * 4 + 2], 75);
+            EXPECT_EQ(data[i * 4 + 3], 0);
+        } else {
+            EXPECT_EQ(std::memcmp(data + i * 4, pixels + i * 4, 4), 0);
+        }
+    }
+}
+
+namespace {
+    /// @brief Registers an io device for the scope of a test
+    struct DeviceGuard {
+        std::string name;
+
+        DeviceGuard(std::string name, std::shared_ptr<io::Device> device)
+            : name(std::move(name)) {
+            io::set_device(this->name, std::move(device));
+        }
+
+        ~DeviceGuard() {
+            io::remove_device(name);
+        }
+    };
+}
+
+TEST(ImageData, ReadAll) {
+    if (!std::filesystem::is_directory("res/textures")) {
+        GTEST_SKIP() << "res/textures not found";
+    }
+    DeviceGuard device(
+        "imgtest", std::make_shared<io::StdfsDevice>("res/textures", false)
+    );
+    std::vector<io::path> files;
+    for (const auto& entry :
+         std::filesystem::recursive_directory_iterator("res/textures")) {
+        auto path = std::filesystem::relative(entry.path(), "res/textures");
+        if (entry.is_regular_file() && path.extension() == imageio::PNG) {
+            files.push_back("imgtest:" + path.generic_u8string());
+        }
+    }
+    std::vector<std::unique_ptr<ImageData>> sequential;
+    for (const auto& file : files) {
+        sequential.push_back(imageio::read(file));
+    }
+    auto images = imageio::read_all(files);
+
+    ASSERT_EQ(images.size(), sequential.size());
+    for (size_t i = 0; i < images.size(); i++) {
+        ASSERT_EQ(images[i]->getDataSize(), sequential[i]->getDataSize());
+        EXPECT_EQ(
+            std::memcmp(
+                images[i]->getData(),
+                sequential[i]->getData(),
+                images[i]->getDataSize()
+            ),
+            0
+        );
+    }
+}
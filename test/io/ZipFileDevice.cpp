@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+#include "io/devices/StdfsDevice.hpp"
+#include "io/devices/ZipFileDevice.hpp"
+#include "io/MappedFile.hpp"
+#include "io/io.hpp"
+
+namespace fs = std::filesystem;
+
+static std::string read_all(std::istream& stream) {
+    return std::string(std::istreambuf_iterator<char>(stream), {});
+}
+
+static std::vector<std::string> list(io::Device& device, std::string_view path) {
+    std::vector<std::string> names;
+    auto generator = device.list(path);
+    io::path name;
+    while (generator->next(name)) {
+        names.push_back(name.string());
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+static void check_device(io::ZipFileDevice& device, const std::string& large) {
+    EXPECT_TRUE(device.isdir("dir"));
+    EXPECT_TRUE(device.isdir("dir/sub"));
+    EXPECT_TRUE(device.isfile("dir/sub/c.txt"));
+    EXPECT_EQ(list(device, ""), std::vector<std::string>({"a.txt", "dir"}));
+    EXPECT_EQ(
+        list(device, "dir"), std::vector<std::string>({"large.txt", "sub"})
+    );
+    EXPECT_EQ(device.size("dir/large.txt"), large.length());
+
+    EXPECT_EQ(read_all(*device.read("a.txt")), "Hello, world!");
+    EXPECT_EQ(read_all(*device.read("a.txt")), "Hello, world!");
+    EXPECT_EQ(device.getCacheHits(), 1);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> failed = 0;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < 10; j++) {
+                if (read_all(*device.read("dir/sub/c.txt")) != "nested" ||
+                    read_all(*device.read("dir/large.txt")) != large) {
+                    failed++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(failed, 0);
+}
+
+TEST(io, ZipFileDevice) {
+    auto root = fs::temp_directory_path() / "voxelcore-zip-test";
+    fs::remove_all(root);
+    fs::create_directories(root / "src" / "dir" / "sub");
+    io::set_device("zipsrc", std::make_shared<io::StdfsDevice>(root / "src"));
+    io::set_device("zipout", std::make_shared<io::StdfsDevice>(root));
+
+    std::string large;
+    for (int i = 0; i < 100'000; i++) {
+        large += std::to_string(i);
+    }
+    io::write_string("zipsrc:a.txt", "Hello, world!");
+    io::write_string("zipsrc:dir/large.txt", large);
+    io::write_string("zipsrc:dir/sub/c.txt", "nested");
+    io::write_zip("zipsrc:", "zipout:test.zip");
+
+    {
+        io::ZipFileDevice device(io::MappedFile::open(root / "test.zip"));
+        check_device(device, large);
+    }
+    {
+        io::ZipFileDevice device(io::read("zipout:test.zip"));
+        check_device(device, large);
+    }
+    io::remove_device("zipsrc");
+    io::remove_device("zipout");
+    fs::remove_all(root);
+}
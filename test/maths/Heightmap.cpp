@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include "maths/Heightmap.hpp"
+
+static Heightmap create_map(uint width, uint height) {
+    Heightmap map(width, height);
+    float* values = map.getValues();
+    for (uint y = 0; y < height; y++) {
+        for (uint x = 0; x < width; x++) {
+            values[y * width + x] = std::sin(x * 0.7f) * std::cos(y * 0.3f);
+        }
+    }
+    return map;
+}
+
+TEST(Heightmap, ResampleTo) {
+    auto source = create_map(19, 13);
+    for (auto interpolation :
+         {InterpolationType::NEAREST,
+          InterpolationType::LINEAR,
+          InterpolationType::CUBIC}) {
+        // zone is not scaled with bpd = 1
+        for (uint bpd : {4, 2, 1}) {
+            uint zoneWidth = 8 / bpd + 1;
+            uint zoneHeight = 4 / bpd + 1;
+            for (uint zoneX = 0; zoneX + zoneWidth <= 19; zoneX += 5) {
+                Heightmap expected(zoneWidth, zoneHeight);
+                for (uint y = 0; y < zoneHeight; y++) {
+                    for (uint x = 0; x < zoneWidth; x++) {
+                        expected.getValues()[y * zoneWidth + x] =
+                            source.get(zoneX + x, 3 + y);
+                    }
+                }
+                expected.resize(8 + bpd, 4 + bpd, interpolation);
+                expected.crop(0, 0, 8, 4);
+
+                Heightmap resampled(8, 4);
+                source.resampleTo(
+                    resampled,
+                    zoneX, 3,
+                    zoneWidth, zoneHeight,
+                    8 + bpd, 4 + bpd,
+                    interpolation
+                );
+                for (uint i = 0; i < 8 * 4; i++) {
+                    ASSERT_EQ(resampled.getValues()[i], expected.getValues()[i])
+                        << "bpd " << bpd << " zone " << zoneX << " index " << i;
+                }
+            }
+        }
+    }
+}
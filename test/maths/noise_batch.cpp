@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "maths/FastNoiseLite.h"
+#include "maths/noise_batch.hpp"
+
+static void make_points(
+    std::vector<float>& xs, std::vector<float>& ys, uint size, float scale
+) {
+    xs.resize(size * size);
+    ys.resize(size * size);
+    for (uint y = 0; y < size; y++) {
+        for (uint x = 0; x < size; x++) {
+            xs[y * size + x] = (static_cast<int>(x) - 100.3f) * scale;
+            ys[y * size + x] = (static_cast<int>(y) - 71.7f) * scale;
+        }
+    }
+}
+
+static void check_state(fnl_state state) {
+    std::vector<float> xs, ys;
+    // odd size to cover the scalar tail
+    make_points(xs, ys, 67, 3.7f);
+    std::vector<float> values(xs.size());
+    noise_batch::noise2d(state, xs.data(), ys.data(), xs.size(), values.data());
+    for (size_t i = 0; i < xs.size(); i++) {
+        float expected = fnlGetNoise2D(&state, xs[i], ys[i]);
+        ASSERT_NEAR(values[i], expected, 1e-5f) << "point " << i;
+    }
+}
+
+TEST(noise_batch, OpenSimplex2) {
+    auto state = fnlCreateState();
+    state.noise_type = FNL_NOISE_OPENSIMPLEX2;
+    for (int seed : {0, 1337, -52, 982374}) {
+        state.seed = seed;
+        check_state(state);
+    }
+}
+
+TEST(noise_batch, Cellular) {
+    auto state = fnlCreateState();
+    state.noise_type = FNL_NOISE_CELLULAR;
+    for (auto type :
+         {FNL_CELLULAR_RETURN_VALUE_CELLVALUE,
+          FNL_CELLULAR_RETURN_VALUE_DISTANCE,
+          FNL_CELLULAR_RETURN_VALUE_DISTANCE2,
+          FNL_CELLULAR_RETURN_VALUE_DISTANCE2SUB,
+          FNL_CELLULAR_RETURN_VALUE_DISTANCE2DIV}) {
+        state.cellular_return_type = type;
+        for (int seed : {0, 1337, -52}) {
+            state.seed = seed;
+            check_state(state);
+        }
+    }
+}
+
+TEST(noise_batch, Fallback) {
+    auto state = fnlCreateState();
+    state.noise_type = FNL_NOISE_PERLIN;
+    EXPECT_FALSE(noise_batch::is_vectorized(state));
+    check_state(state);
+}
+
+TEST(noise_batch, OpenSimplex2_3D) {
+    auto state = fnlCreateState();
+    state.noise_type = FNL_NOISE_OPENSIMPLEX2;
+    EXPECT_EQ(
+        noise_batch::is_vectorized3d(state),
+        noise_batch::is_vectorized(state)
+    );
+    std::vector<float> xs, ys, zs;
+    // odd size to cover the scalar tail
+    make_points(xs, ys, 37, 5.3f);
+    zs.resize(xs.size());
+    for (size_t i = 0; i < zs.size(); i++) {
+        zs[i] = (static_cast<int>(i % 29) - 13.1f) * 4.1f;
+    }
+    std::vector<float> values(xs.size());
+    for (int seed : {0, 1337, -52, 982374}) {
+        state.seed = seed;
+        noise_batch::noise3d(
+            state, xs.data(), ys.data(), zs.data(), xs.size(), values.data()
+        );
+        for (size_t i = 0; i < xs.size(); i++) {
+            float expected = fnlGetNoise3D(&state, xs[i], ys[i], zs[i]);
+            ASSERT_NEAR(values[i], expected, 1e-5f) << "point " << i;
+        }
+    }
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "network/ChunksStream.hpp"
+#include "network/Network.hpp"
+
+using namespace network;
+
+template <typename Predicate>
+static bool wait_for(
+    Network& network,
+    ChunksStreamServer& server,
+    ChunksStreamClient& client,
+    Predicate predicate
+) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        server.update();
+        network.update();
+        client.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+static std::shared_ptr<Chunk> create_chunk(int x, int z) {
+    auto chunk = std::make_shared<Chunk>(x, z);
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        chunk->voxels[i].id = i % 7;
+    }
+    chunk->blocksMetadata.allocate(42, 4);
+    return chunk;
+}
+
+TEST(ChunksStream, FullAndDelta) {
+    NetworkSettings settings {};
+    auto network = Network::create(settings);
+
+    // set by the network I/O thread
+    std::atomic<u64id_t> accepted = 0;
+    u64id_t serverid = network->openServer(0, [&](u64id_t, u64id_t id) {
+        accepted = id;
+    });
+    u64id_t clientid = network->connect(
+        "127.0.0.1", network->getServer(serverid)->getPort(), [](u64id_t) {}
+    );
+
+    auto chunk = create_chunk(3, -7);
+
+    std::vector<Chunk> received;
+    std::vector<uint> versions;
+    ChunksStreamServer server(*network, 1);
+    ChunksStreamClient client(*network, clientid, [&](StreamedChunk& streamed) {
+        auto& dst = received.emplace_back(streamed.x, streamed.z);
+        dst.decode(streamed.voxelData);
+        dst.blocksMetadata = streamed.metadata;
+        versions.push_back(streamed.version);
+    }, 1);
+
+    ASSERT_TRUE(wait_for(*network, server, client, [&]() {
+        return accepted != 0;
+    }));
+    server.subscribe(accepted, chunk);
+    ASSERT_TRUE(wait_for(*network, server, client, [&]() {
+        return received.size() == 1;
+    }));
+
+    chunk->voxels[100].id = 1000;
+    server.markModified(*chunk);
+    ASSERT_TRUE(wait_for(*network, server, client, [&]() {
+        return received.size() == 2;
+    }));
+
+    EXPECT_EQ(versions, std::vector<uint>({1, 2}));
+    EXPECT_EQ(received[0].x, 3);
+    EXPECT_EQ(received[0].z, -7);
+    EXPECT_EQ(received[0].voxels[100].id, 100 % 7);
+    for (uint i = 0; i < CHUNK_VOL; i++) {
+        EXPECT_EQ(received[1].voxels[i].id, chunk->voxels[i].id);
+    }
+    EXPECT_TRUE(received[1].blocksMetadata == chunk->blocksMetadata);
+
+    server.unsubscribeAll(accepted);
+    EXPECT_EQ(server.getChunksCount(), 0);
+}
+
+TEST(ChunksStream, ModificationsAndLimit) {
+    NetworkSettings settings {};
+    auto network = Network::create(settings);
+
+    std::atomic<u64id_t> accepted = 0;
+    u64id_t serverid = network->openServer(0, [&](u64id_t, u64id_t id) {
+        accepted = id;
+    });
+    u64id_t clientid = network->connect(
+        "127.0.0.1", network->getServer(serverid)->getPort(), [](u64id_t) {}
+    );
+    auto first = create_chunk(0, 0);
+    auto second = create_chunk(1, 0);
+
+    std::vector<glm::ivec2> received;
+    ChunksStreamServer server(*network, 1);
+    ChunksStreamClient client(*network, clientid, [&](StreamedChunk& streamed) {
+        received.emplace_back(streamed.x, streamed.z);
+    }, 1, 1);
+
+    ASSERT_TRUE(wait_for(*network, server, client, [&]() {
+        return accepted != 0;
+    }));
+    server.subscribe(accepted, first);
+    ASSERT_TRUE(wait_for(*network, server, client, [&]() {
+        return received.size() == 1;
+    }));
+
+    // detected without markModified
+    first->voxels[0].id = 3;
+    first->setModifiedAndUnsaved();
+    ASSERT_TRUE(wait_for(*network, server, client, [&]() {
+        return received.size() == 2;
+    }));
+
+    // client tracks one chunk at most
+    size_t uploaded = network->getTotalUpload();
+    server.subscribe(accepted, second);
+    ASSERT_TRUE(wait_for(*network, server, client, [&]() {
+        return network->getTotalUpload() > uploaded &&
+               network->getTotalDownload() == network->getTotalUpload();
+    }));
+    client.update();
+    EXPECT_EQ(received.size(), 2);
+    EXPECT_EQ(client.getChunksCount(), 1);
+
+    // destroyed chunks are unsubscribed
+    first = nullptr;
+    second = nullptr;
+    ASSERT_TRUE(wait_for(*network, server, client, [&]() {
+        return server.getChunksCount() == 0;
+    }));
+}
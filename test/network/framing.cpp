@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "network/framing.hpp"
+#include "util/data_io.hpp"
+
+using namespace network;
+
+static std::vector<ubyte> to_bytes(const std::string& string) {
+    return std::vector<ubyte>(string.begin(), string.end());
+}
+
+TEST(framing, Roundtrip) {
+    util::RingBuffer<char> buffer;
+    auto first = to_bytes("first message");
+    auto second = to_bytes(std::string(1000, 'x'));
+
+    framing::write_message(
+        buffer, first.data(), first.size(), compression::Method::NONE
+    );
+    framing::write_message(
+        buffer, second.data(), second.size(), compression::Method::GZIP
+    );
+    // compressed payload
+    EXPECT_LT(buffer.size(), first.size() + second.size());
+
+    std::vector<ubyte> message;
+    EXPECT_TRUE(framing::read_message(buffer, message));
+    EXPECT_EQ(message, first);
+    EXPECT_TRUE(framing::read_message(buffer, message));
+    EXPECT_EQ(message, second);
+    EXPECT_FALSE(framing::read_message(buffer, message));
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(framing, EmptyMessage) {
+    util::RingBuffer<char> buffer;
+    framing::write_message(buffer, nullptr, 0, compression::Method::NONE);
+
+    std::vector<ubyte> message {1, 2, 3};
+    EXPECT_TRUE(framing::read_message(buffer, message));
+    EXPECT_TRUE(message.empty());
+}
+
+TEST(framing, PartialFrame) {
+    util::RingBuffer<char> source;
+    auto bytes = to_bytes("partially received message");
+    framing::write_message(
+        source, bytes.data(), bytes.size(), compression::Method::NONE
+    );
+    std::vector<char> frame(source.size());
+    source.read(frame.data(), frame.size());
+
+    util::RingBuffer<char> buffer;
+    std::vector<ubyte> message;
+    for (char c : frame) {
+        EXPECT_FALSE(framing::read_message(buffer, message));
+        buffer.write(&c, 1);
+    }
+    EXPECT_TRUE(framing::read_message(buffer, message));
+    EXPECT_EQ(message, bytes);
+}
+
+TEST(framing, Malformed) {
+    util::RingBuffer<char> buffer;
+    buffer.write("\x7F\xFF\xFF\xFF\x00", 5);
+    std::vector<ubyte> message;
+    EXPECT_THROW(framing::read_message(buffer, message), std::runtime_error);
+}
+
+static void write_gzip_frame(
+    util::RingBuffer<char>& buffer,
+    const std::vector<ubyte>& payload,
+    size_t srclen
+) {
+    ubyte header[9];
+    dataio::write_int32_big(5 + payload.size(), header, 0);
+    header[4] = static_cast<ubyte>(compression::Method::GZIP);
+    dataio::write_int32_big(srclen, header, 5);
+    buffer.write(reinterpret_cast<const char*>(header), sizeof(header));
+    buffer.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+}
+
+TEST(framing, MalformedGzip) {
+    auto bytes = to_bytes("next message");
+    std::vector<ubyte> message;
+
+    // shorter than gzip header and footer
+    util::RingBuffer<char> buffer;
+    write_gzip_frame(buffer, {0x1F, 0x8B, 8, 0}, 10);
+    framing::write_message(
+        buffer, bytes.data(), bytes.size(), compression::Method::NONE
+    );
+    EXPECT_THROW(framing::read_message(buffer, message), std::runtime_error);
+    EXPECT_TRUE(framing::read_message(buffer, message));
+    EXPECT_EQ(message, bytes);
+
+    // gzip footer claims more than the message size limit
+    std::vector<ubyte> payload(18);
+    payload[0] = 0x1F;
+    payload[1] = 0x8B;
+    payload[14] = payload[15] = payload[16] = payload[17] = 0xFF;
+    write_gzip_frame(buffer, payload, 10);
+    framing::write_message(
+        buffer, bytes.data(), bytes.size(), compression::Method::NONE
+    );
+    EXPECT_THROW(framing::read_message(buffer, message), std::runtime_error);
+    EXPECT_TRUE(framing::read_message(buffer, message));
+    EXPECT_EQ(message, bytes);
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(framing, MalformedSizeClearsBuffer) {
+    util::RingBuffer<char> buffer;
+    buffer.write("\x7F\xFF\xFF\xFF\x00", 5);
+    buffer.write("rest", 4);
+    std::vector<ubyte> message;
+    EXPECT_THROW(framing::read_message(buffer, message), framing::stream_error);
+    EXPECT_TRUE(buffer.empty());
+}
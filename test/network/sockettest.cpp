@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "debug/Logger.hpp"
+#include "network/Network.hpp"
+
+using namespace network;
+
+static debug::Logger logger("sockettest");
+
+/// @brief Number of simultaneous loopback connections
+static constexpr int CLIENTS_COUNT = 256;
+
+template <typename Predicate>
+static bool wait_for(Network& network, Predicate predicate) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        network.update();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST(sockettest, loopback_load) {
+    NetworkSettings settings {};
+    auto network = Network::create(settings);
+
+    std::mutex mutex;
+    std::vector<u64id_t> accepted;
+    std::atomic<int> connected = 0;
+
+    u64id_t serverid = network->openServer(0, [&](u64id_t, u64id_t id) {
+        std::lock_guard lock(mutex);
+        accepted.push_back(id);
+    });
+    auto server = network->getServer(serverid);
+    ASSERT_NE(server, nullptr);
+    int port = server->getPort();
+    ASSERT_NE(port, 0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<u64id_t> clients;
+    for (int i = 0; i < CLIENTS_COUNT; i++) {
+        clients.push_back(network->connect("127.0.0.1", port, [&](u64id_t) {
+            connected++;
+        }));
+    }
+    ASSERT_TRUE(wait_for(*network, [&]() {
+        std::lock_guard lock(mutex);
+        return connected == CLIENTS_COUNT &&
+               accepted.size() == static_cast<size_t>(CLIENTS_COUNT);
+    }));
+
+    const std::string message = "ping";
+    for (u64id_t id : clients) {
+        auto connection = network->getConnection(id);
+        ASSERT_NE(connection, nullptr);
+        connection->send(message.data(), message.length());
+    }
+    ASSERT_TRUE(wait_for(*network, [&]() {
+        for (u64id_t id : accepted) {
+            auto connection = network->getConnection(id);
+            if (connection == nullptr ||
+                static_cast<size_t>(connection->available()) <
+                    message.length()) {
+                return false;
+            }
+        }
+        return true;
+    }));
+    for (u64id_t id : accepted) {
+        char buffer[16] {};
+        auto connection = network->getConnection(id);
+        EXPECT_EQ(
+            connection->recv(buffer, sizeof(buffer)),
+            static_cast<int>(message.length())
+        );
+        EXPECT_EQ(std::string(buffer, message.length()), message);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start
+    );
+    logger.info() << CLIENTS_COUNT << " connections: " << elapsed.count()
+                  << " ms";
+
+    server->close();
+    EXPECT_TRUE(wait_for(*network, [&]() {
+        for (u64id_t id : clients) {
+            if (network->getConnection(id) != nullptr) {
+                return false;
+            }
+        }
+        return true;
+    }));
+}
+
+TEST(sockettest, framed_messages) {
+    NetworkSettings settings {};
+    auto network = Network::create(settings);
+
+    std::atomic<u64id_t> accepted = 0;
+    u64id_t serverid = network->openServer(0, [&](u64id_t, u64id_t id) {
+        accepted = id;
+    });
+    auto server = network->getServer(serverid);
+    u64id_t client = network->connect(
+        "127.0.0.1", server->getPort(), [](u64id_t) {}
+    );
+    ASSERT_TRUE(wait_for(*network, [&]() {
+        auto connection = network->getConnection(client);
+        return accepted != 0 &&
+               connection->getState() == ConnectionState::CONNECTED;
+    }));
+
+    constexpr int MESSAGES_COUNT = 100;
+    auto connection = network->getConnection(client);
+    for (int i = 0; i < MESSAGES_COUNT; i++) {
+        auto text = std::to_string(i);
+        connection->sendMessage(
+            reinterpret_cast<const ubyte*>(text.data()), text.length()
+        );
+    }
+    std::vector<ubyte> large(100'000, 42);
+    connection->sendMessage(
+        large.data(), large.size(), compression::Method::GZIP
+    );
+
+    auto receiver = network->getConnection(accepted);
+    std::vector<std::vector<ubyte>> received;
+    ASSERT_TRUE(wait_for(*network, [&]() {
+        std::vector<ubyte> message;
+        while (receiver->recvMessage(message)) {
+            received.push_back(message);
+        }
+        return received.size() == MESSAGES_COUNT + 1;
+    }));
+    for (int i = 0; i < MESSAGES_COUNT; i++) {
+        auto text = std::to_string(i);
+        EXPECT_EQ(std::string(received[i].begin(), received[i].end()), text);
+    }
+    EXPECT_EQ(received.back(), large);
+    server->close();
+}
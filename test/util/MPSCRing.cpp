@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "util/MPSCRing.hpp"
+
+TEST(MPSCRing, SingleThread) {
+    util::MPSCRing<int> ring(4);
+    int value;
+    EXPECT_FALSE(ring.tryPop(value));
+    for (int i = 0; i < 4; i++) {
+        int item = i;
+        EXPECT_TRUE(ring.tryPush(std::move(item)));
+    }
+    int extra = 4;
+    EXPECT_FALSE(ring.tryPush(std::move(extra)));
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.tryPop(value));
+    EXPECT_THROW(util::MPSCRing<int>(6), std::invalid_argument);
+}
+
+TEST(MPSCRing, MultipleProducers) {
+    constexpr int PRODUCERS = 4;
+    constexpr int ITEMS = 20000;
+    util::MPSCRing<std::pair<int, int>> ring(64);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < ITEMS; i++) {
+                std::pair<int, int> item(p, i);
+                while (!ring.tryPush(std::move(item))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<int> next(PRODUCERS, 0);
+    int received = 0;
+    int misordered = 0;
+    std::pair<int, int> item;
+    while (received < PRODUCERS * ITEMS) {
+        if (!ring.tryPop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        // order is preserved for each producer
+        if (item.second != next[item.first]) {
+            misordered++;
+        }
+        next[item.first] = item.second + 1;
+        received++;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(misordered, 0);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+#include "util/RingBuffer.hpp"
+
+using namespace util;
+
+TEST(RingBuffer, WriteRead) {
+    RingBuffer<char> buffer;
+    EXPECT_TRUE(buffer.empty());
+
+    buffer.write("hello", 5);
+    EXPECT_EQ(buffer.size(), 5);
+
+    char dst[8] {};
+    EXPECT_EQ(buffer.read(dst, sizeof(dst)), 5);
+    EXPECT_EQ(std::string(dst, 5), "hello");
+    EXPECT_TRUE(buffer.empty());
+}
+
+TEST(RingBuffer, WrapAround) {
+    RingBuffer<int> buffer(16);
+    std::vector<int> values(12);
+    std::iota(values.begin(), values.end(), 0);
+
+    buffer.write(values.data(), values.size());
+    int dst[16] {};
+    buffer.read(dst, 8);
+
+    // 4 elements left at the end, next write wraps
+    buffer.write(values.data(), values.size());
+    EXPECT_EQ(buffer.getCapacity(), 16);
+    EXPECT_EQ(buffer.size(), 16);
+    EXPECT_EQ(buffer.readable(), 8);
+
+    EXPECT_EQ(buffer.read(dst, 16), 16);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(dst[i], 8 + i);
+    }
+    for (int i = 0; i < 12; i++) {
+        EXPECT_EQ(dst[4 + i], i);
+    }
+}
+
+TEST(RingBuffer, Grow) {
+    RingBuffer<int> buffer(16);
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+
+    int dst[3];
+    buffer.write(values.data(), 10);
+    buffer.read(dst, 3);
+    buffer.write(values.data() + 10, values.size() - 10);
+    EXPECT_EQ(buffer.size(), values.size() - 3);
+
+    std::vector<int> result(buffer.size());
+    buffer.read(result.data(), result.size());
+    for (size_t i = 0; i < result.size(); i++) {
+        EXPECT_EQ(result[i], i + 3);
+    }
+}
+
+TEST(RingBuffer, PrepareCommit) {
+    RingBuffer<char> buffer(16);
+    buffer.write("0123456789", 10);
+    buffer.skip(8);
+
+    // contiguous space at the end is not enough, buffer is realigned
+    char* dst = buffer.prepare(12);
+    EXPECT_GE(buffer.writable(), 12);
+    EXPECT_EQ(buffer.getCapacity(), 16);
+    std::memcpy(dst, "abcdefghijkl", 12);
+    buffer.commit(12);
+
+    EXPECT_EQ(buffer.readable(), 14);
+    EXPECT_EQ(std::string(buffer.front(), 14), "89abcdefghijkl");
+}
+
+TEST(RingBuffer, Peek) {
+    RingBuffer<char> buffer;
+    buffer.write("abcdef", 6);
+    char dst[4] {};
+    EXPECT_EQ(buffer.peek(dst, 3, 2), 3);
+    EXPECT_EQ(std::string(dst, 3), "cde");
+    EXPECT_EQ(buffer.size(), 6);
+    EXPECT_EQ(buffer.peek(dst, 3, 6), 0);
+}
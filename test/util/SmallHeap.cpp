@@ -82,3 +82,40 @@ TEST(SmallHeap, Iterator) {
     }
     EXPECT_EQ(sum, 44);
 }
+
+TEST(SmallHeap, DecodeChecked) {
+    SmallHeap<uint16_t, uint8_t> map;
+    map.allocate(1, 10);
+    map.allocate(5, 3);
+    auto bytes = map.serialize();
+
+    SmallHeap<uint16_t, uint8_t> out;
+    out.deserializeChecked(bytes.data(), bytes.size());
+    EXPECT_EQ(map, out);
+
+    // truncated entry
+    EXPECT_THROW(
+        out.deserializeChecked(bytes.data(), bytes.size() - 1),
+        std::runtime_error
+    );
+    // trailing garbage
+    std::vector<ubyte> extended(bytes.data(), bytes.data() + bytes.size());
+    extended.push_back(0);
+    EXPECT_THROW(
+        out.deserializeChecked(extended.data(), extended.size()),
+        std::runtime_error
+    );
+    // entries count larger than the data
+    std::vector<ubyte> garbage {0xFF, 0xFF, 1, 0, 200};
+    EXPECT_THROW(
+        out.deserializeChecked(garbage.data(), garbage.size()),
+        std::runtime_error
+    );
+    // unsorted entries
+    std::vector<ubyte> unsorted {2, 0, 5, 0, 1, 7, 1, 0, 1, 8};
+    EXPECT_THROW(
+        out.deserializeChecked(unsorted.data(), unsorted.size()),
+        std::runtime_error
+    );
+    EXPECT_EQ(map, out);
+}
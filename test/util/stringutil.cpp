@@ -47,3 +47,16 @@ TEST(stringutil, base64_urlsafe) {
         }
     }
 }
+
+TEST(stringutil, find_any_of) {
+    std::string text(100, 'a');
+    EXPECT_EQ(util::find_any_of(text, '"', '\\', '\n'), text.length());
+    for (size_t i : {0, 5, 15, 16, 17, 31, 32, 63, 99}) {
+        text[i] = "\"\\\n"[i % 3];
+        EXPECT_EQ(util::find_any_of(text, '"', '\\', '\n'), i);
+        std::string_view prefix(text.data(), i);
+        EXPECT_EQ(util::find_any_of(prefix, '"', '\\', '\n'), i);
+        text[i] = 'a';
+    }
+    EXPECT_EQ(util::find_any_of("", 'a', 'b', 'c'), 0);
+}
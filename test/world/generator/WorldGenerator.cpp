@@ -0,0 +1,646 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "content/Content.hpp"
+#include "content/ContentBuilder.hpp"
+#include "core_defs.hpp"
+#include "io/devices/StdfsDevice.hpp"
+#include "io/io.hpp"
+#include "logic/scripting/scripting.hpp"
+#include "objects/rigging.hpp"
+#include "voxels/Block.hpp"
+#include "voxels/Chunk.hpp"
+#include "world/generator/GeneratorDef.hpp"
+#include "world/generator/PrototypesStorage.hpp"
+#include "world/generator/VoxelFragment.hpp"
+#include "world/generator/WorldGenerator.hpp"
+
+/// @brief Generator script depending on the world position only
+class TestGeneratorScript : public GeneratorScript {
+public:
+    int heightmapCalls = 0;
+    int parameterCalls = 0;
+    /// @brief Placements of the chunk 0, 0
+    std::vector<Placement> placements;
+
+    std::unique_ptr<GeneratorScript> createWorker() const override {
+        auto worker = std::make_unique<TestGeneratorScript>();
+        worker->placements = placements;
+        return worker;
+    }
+
+    void initialize(uint64_t) override {
+    }
+
+    std::shared_ptr<Heightmap> generateHeightmap(
+        const glm::ivec2& offset,
+        const glm::ivec2& size,
+        uint bpd,
+        const std::vector<std::shared_ptr<Heightmap>>& inputs
+    ) override {
+        heightmapCalls++;
+        auto map = std::make_shared<Heightmap>(size.x, size.y);
+        float* values = map->getValues();
+        for (int y = 0; y < size.y; y++) {
+            for (int x = 0; x < size.x; x++) {
+                float gx = (offset.x + x) * static_cast<float>(bpd);
+                float gy = (offset.y + y) * static_cast<float>(bpd);
+                float value = 0.3f + std::sin(gx * 0.05f) *
+                                         std::cos(gy * 0.043f) * 0.15f;
+                if (!inputs.empty()) {
+                    value += inputs[0]->getUnchecked(x, y) * 0.1f;
+                }
+                values[y * size.x + x] = value;
+            }
+        }
+        return map;
+    }
+
+    std::vector<std::shared_ptr<Heightmap>> generateParameterMaps(
+        const glm::ivec2& offset, const glm::ivec2& size, uint bpd
+    ) override {
+        parameterCalls++;
+        auto map = std::make_shared<Heightmap>(size.x, size.y);
+        float* values = map->getValues();
+        for (int y = 0; y < size.y; y++) {
+            for (int x = 0; x < size.x; x++) {
+                float gx = (offset.x + x) * static_cast<float>(bpd);
+                float gy = (offset.y + y) * static_cast<float>(bpd);
+                values[y * size.x + x] =
+                    0.5f + std::sin(gx * 0.021f + gy * 0.017f) * 0.5f;
+            }
+        }
+        return {map};
+    }
+
+    std::vector<Placement> placeStructuresWide(
+        const glm::ivec2&, const glm::ivec2&, uint
+    ) override {
+        return {};
+    }
+
+    std::vector<Placement> placeStructures(
+        const glm::ivec2& offset,
+        const glm::ivec2&,
+        const std::shared_ptr<Heightmap>&,
+        uint
+    ) override {
+        if (offset == glm::ivec2(0, 0)) {
+            return placements;
+        }
+        return {};
+    }
+};
+
+class TestPrototypesStorage : public PrototypesStorage {
+public:
+    std::unordered_map<glm::ivec2, util::Buffer<ubyte>> prototypes;
+
+    util::Buffer<ubyte> loadPrototype(int x, int z) override {
+        const auto& found = prototypes.find({x, z});
+        if (found == prototypes.end()) {
+            return nullptr;
+        }
+        return util::Buffer<ubyte>(found->second);
+    }
+
+    void storePrototype(int x, int z, util::Buffer<ubyte> data) override {
+        prototypes[{x, z}] = std::move(data);
+    }
+};
+
+static std::unique_ptr<Content> create_content() {
+    ContentBuilder builder;
+    {
+        Block& block = builder.blocks.create(CORE_AIR);
+        block.obstacle = false;
+        block.defaults.model.type = BlockModelType::NONE;
+        block.pickingItem = CORE_EMPTY;
+    }
+    builder.items.create(CORE_EMPTY);
+    for (const auto& name : {CORE_OBSTACLE, CORE_STRUCT_AIR}) {
+        Block& block = builder.blocks.create(name);
+        block.pickingItem = CORE_EMPTY;
+    }
+    for (const auto& name : {"test:stone", "test:grass", "test:water"}) {
+        Block& block = builder.blocks.create(name);
+        block.pickingItem = CORE_EMPTY;
+    }
+    return builder.build();
+}
+
+static Biome create_biome(
+    const std::string& name, float parameter, const std::string& top
+) {
+    Biome biome {};
+    biome.name = name;
+    biome.parameters = {BiomeParameter {parameter, 1.0f}};
+    biome.groundLayers.layers = {
+        BlocksLayer {top, 1, false, {}},
+        BlocksLayer {"test:stone", -1, true, {}},
+    };
+    biome.groundLayers.lastLayersHeight = 0;
+    biome.seaLayers.layers = {BlocksLayer {"test:water", -1, true, {}}};
+    biome.seaLayers.lastLayersHeight = 0;
+    return biome;
+}
+
+static std::unique_ptr<GeneratorDef> create_generator(
+    const Content& content, uint batchChunks
+) {
+    auto def = std::make_unique<GeneratorDef>("test:generator");
+    def->script = std::make_unique<TestGeneratorScript>();
+    def->seaLevel = 64;
+    def->biomeParameters = 1;
+    def->heightmapInputs = {0};
+    def->wideStructsChunksRadius = 1;
+    def->batchChunks = batchChunks;
+    def->biomes.push_back(create_biome("test:plains", 0.2f, "test:grass"));
+    def->biomes.push_back(create_biome("test:rocks", 0.8f, "test:stone"));
+    def->prepare(&content);
+    return def;
+}
+
+static std::vector<std::unique_ptr<voxel[]>> generate_area(
+    WorldGenerator& generator, int size
+) {
+    std::vector<std::unique_ptr<voxel[]>> chunks;
+    generator.update(0, 0, size);
+    for (int z = -size / 2; z < size / 2; z++) {
+        for (int x = -size / 2; x < size / 2; x++) {
+            auto voxels = std::make_unique<voxel[]>(CHUNK_VOL);
+            generator.generate(voxels.get(), x, z);
+            chunks.push_back(std::move(voxels));
+        }
+    }
+    return chunks;
+}
+
+/// @brief Compare generated chunks voxel-wise
+static void expect_same_chunks(
+    const std::vector<std::unique_ptr<voxel[]>>& chunks,
+    const std::vector<std::unique_ptr<voxel[]>>& expected
+) {
+    ASSERT_EQ(chunks.size(), expected.size());
+    for (size_t i = 0; i < chunks.size(); i++) {
+        EXPECT_EQ(
+            std::memcmp(
+                chunks[i].get(), expected[i].get(), CHUNK_VOL * sizeof(voxel)
+            ),
+            0
+        ) << "chunk " << i;
+    }
+}
+
+TEST(WorldGenerator, BatchedPrototypes) {
+    auto content = create_content();
+    const int size = 8;
+
+    auto def = create_generator(*content, 1);
+    WorldGenerator generator(*def, *content, 0);
+    auto expected = generate_area(generator, size);
+    auto script = dynamic_cast<TestGeneratorScript*>(def->script.get());
+
+    auto batchedDef = create_generator(*content, 4);
+    WorldGenerator batchedGenerator(*batchedDef, *content, 0);
+    auto chunks = generate_area(batchedGenerator, size);
+    auto batchedScript =
+        dynamic_cast<TestGeneratorScript*>(batchedDef->script.get());
+
+    expect_same_chunks(chunks, expected);
+    EXPECT_LT(batchedScript->heightmapCalls, script->heightmapCalls);
+    EXPECT_LT(batchedScript->parameterCalls, script->parameterCalls);
+}
+
+TEST(WorldGenerator, ReusedPrototypes) {
+    auto content = create_content();
+    const int size = 8;
+
+    auto def = create_generator(*content, 4);
+    WorldGenerator generator(*def, *content, 0);
+    auto expected = generate_area(generator, size);
+
+    // prototypes and heightmaps released by moving away are reused
+    generator.update(100, -37, size);
+    for (int z = -37 - size / 2; z < -37 + size / 2; z++) {
+        for (int x = 100 - size / 2; x < 100 + size / 2; x++) {
+            auto voxels = std::make_unique<voxel[]>(CHUNK_VOL);
+            generator.generate(voxels.get(), x, z);
+        }
+    }
+    auto chunks = generate_area(generator, size);
+    expect_same_chunks(chunks, expected);
+}
+
+TEST(WorldGenerator, ParallelVoxels) {
+    auto content = create_content();
+    const int size = 8;
+
+    auto def = create_generator(*content, 1);
+    WorldGenerator generator(*def, *content, 0);
+    auto expected = generate_area(generator, size);
+
+    auto parallelDef = create_generator(*content, 1);
+    WorldGenerator parallelGenerator(*parallelDef, *content, 0);
+    parallelGenerator.update(0, 0, size);
+    std::vector<std::unique_ptr<voxel[]>> chunks;
+    for (int z = -size / 2; z < size / 2; z++) {
+        for (int x = -size / 2; x < size / 2; x++) {
+            parallelGenerator.prepare(x, z);
+            chunks.push_back(std::make_unique<voxel[]>(CHUNK_VOL));
+        }
+    }
+    const int threadsCount = 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadsCount; t++) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = t; i < chunks.size(); i += threadsCount) {
+                int x = static_cast<int>(i % size) - size / 2;
+                int z = static_cast<int>(i / size) - size / 2;
+                parallelGenerator.generateVoxels(chunks[i].get(), x, z);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    expect_same_chunks(chunks, expected);
+}
+
+TEST(WorldGenerator, DensityCarving) {
+    auto content = create_content();
+    const int size = 4;
+
+    auto def = create_generator(*content, 1);
+    WorldGenerator generator(*def, *content, 0);
+    auto chunks = generate_area(generator, size);
+
+    auto carvedDef = create_generator(*content, 1);
+    carvedDef->density.enabled = true;
+    carvedDef->density.threshold = 0.2f;
+    carvedDef->density.surfaceDepth = 3;
+    carvedDef->prepare(content.get());
+    WorldGenerator carvedGenerator(*carvedDef, *content, 0);
+    auto carved = generate_area(carvedGenerator, size);
+
+    size_t carvedCount = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        for (uint y = 0; y < CHUNK_H; y++) {
+            for (uint z = 0; z < CHUNK_D; z++) {
+                for (uint x = 0; x < CHUNK_W; x++) {
+                    const auto& src = chunks[i][vox_index(x, y, z)];
+                    const auto& dst = carved[i][vox_index(x, y, z)];
+                    if (src.id == dst.id) {
+                        continue;
+                    }
+                    ASSERT_EQ(dst.id, BLOCK_AIR);
+                    ASSERT_GE(y, carvedDef->density.minHeight);
+                    // surface blocks are not carved
+                    ASSERT_NE(
+                        chunks[i][vox_index(x, y + 3, z)].id, BLOCK_AIR
+                    );
+                    carvedCount++;
+                }
+            }
+        }
+    }
+    EXPECT_GT(carvedCount, 0);
+
+    // same result when generated again
+    auto repeated = generate_area(carvedGenerator, size);
+    expect_same_chunks(carved, repeated);
+}
+
+TEST(WorldGenerator, LandColumns) {
+    auto content = create_content();
+    blockid_t water = content->blocks.require("test:water").rt.id;
+    const int size = 4;
+
+    auto def = create_generator(*content, 1);
+    WorldGenerator generator(*def, *content, 0);
+    auto chunks = generate_area(generator, size);
+    for (size_t i = 0; i < chunks.size(); i++) {
+        for (uint z = 0; z < CHUNK_D; z++) {
+            for (uint x = 0; x < CHUNK_W; x++) {
+                // column is solid from the bottom up to the surface
+                uint y = 0;
+                while (y < CHUNK_H && chunks[i][vox_index(x, y, z)].id) {
+                    ASSERT_NE(
+                        chunks[i][vox_index(x, y, z)].id, BLOCK_STRUCT_AIR
+                    );
+                    y++;
+                }
+                ASSERT_GE(y, def->seaLevel + 1) << "chunk " << i;
+                if (y > 0 && y - 1 > def->seaLevel) {
+                    ASSERT_NE(chunks[i][vox_index(x, y - 1, z)].id, water);
+                }
+                for (; y < CHUNK_H; y++) {
+                    ASSERT_EQ(chunks[i][vox_index(x, y, z)].id, BLOCK_AIR);
+                }
+            }
+        }
+    }
+}
+
+TEST(WorldGenerator, StructuresBlit) {
+    auto content = create_content();
+    const int size = 4;
+
+    auto def = create_generator(*content, 1);
+    WorldGenerator generator(*def, *content, 0);
+    auto chunks = generate_area(generator, size);
+
+    // random fragment with air gaps
+    glm::ivec3 fragmentSize {7, 5, 4};
+    std::vector<std::string> names {
+        CORE_AIR, "test:stone", CORE_STRUCT_AIR, "test:grass"};
+    std::vector<voxel> fragmentVoxels(
+        fragmentSize.x * fragmentSize.y * fragmentSize.z
+    );
+    std::mt19937 random(42);
+    for (auto& voxel : fragmentVoxels) {
+        voxel = {static_cast<blockid_t>(random() % names.size()), {}};
+        voxel.state.rotation = random() % 4;
+    }
+    auto structuresDef = create_generator(*content, 1);
+    structuresDef->structuresIndices["test:fragment"] = 0;
+    structuresDef->structures.push_back(std::make_unique<VoxelStructure>(
+        VoxelStructureMeta {"test:fragment"},
+        std::make_unique<VoxelFragment>(
+            fragmentSize, std::move(fragmentVoxels), names
+        )
+    ));
+    structuresDef->prepare(content.get());
+    auto script =
+        dynamic_cast<TestGeneratorScript*>(structuresDef->script.get());
+    std::vector<StructurePlacement> placements {
+        {0, {-3, 70, -2}, 0},
+        {0, {12, 60, 13}, 1},
+        {0, {5, 254, 5}, 2},
+        {0, {-2, -2, 14}, 3},
+    };
+    for (const auto& placement : placements) {
+        script->placements.emplace_back(1, placement);
+    }
+    WorldGenerator structuresGenerator(*structuresDef, *content, 0);
+    auto generated = generate_area(structuresGenerator, size);
+
+    // per-voxel placement to compare with
+    for (int z = -size / 2; z < size / 2; z++) {
+        for (int x = -size / 2; x < size / 2; x++) {
+            auto& voxels = chunks[(z + size / 2) * size + x + size / 2];
+            for (const auto& placement : placements) {
+                const auto& fragment =
+                    *structuresDef->structures[0]->fragments[placement.rotation];
+                const auto& fragmentSize = fragment.getSize();
+                const auto& structVoxels = fragment.getRuntimeVoxels();
+                auto offset = placement.position -
+                              glm::ivec3(x * CHUNK_W, 0, z * CHUNK_D);
+                for (int fy = 0; fy < fragmentSize.y; fy++) {
+                    for (int fz = 0; fz < fragmentSize.z; fz++) {
+                        for (int fx = 0; fx < fragmentSize.x; fx++) {
+                            auto pos = offset + glm::ivec3(fx, fy, fz);
+                            if (pos.x < 0 || pos.x >= CHUNK_W || pos.y < 0 ||
+                                pos.y >= CHUNK_H || pos.z < 0 ||
+                                pos.z >= CHUNK_D) {
+                                continue;
+                            }
+                            auto src = structVoxels[vox_index(
+                                fx, fy, fz, fragmentSize.x, fragmentSize.z
+                            )];
+                            if (src.id == BLOCK_AIR) {
+                                continue;
+                            }
+                            if (src.id == BLOCK_STRUCT_AIR) {
+                                src.id = BLOCK_AIR;
+                            }
+                            voxels[vox_index(pos.x, pos.y, pos.z)] = src;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    expect_same_chunks(chunks, generated);
+}
+
+TEST(WorldGenerator, StoredPrototypes) {
+    auto content = create_content();
+    const int size = 8;
+    TestPrototypesStorage storage;
+
+    auto def = create_generator(*content, 1);
+    WorldGenerator generator(*def, *content, 0);
+    generator.setPrototypesStorage(&storage);
+    auto expected = generate_area(generator, size);
+    EXPECT_FALSE(storage.prototypes.empty());
+
+    // restarted world
+    auto cachedDef = create_generator(*content, 4);
+    WorldGenerator cachedGenerator(*cachedDef, *content, 0);
+    cachedGenerator.setPrototypesStorage(&storage);
+    auto chunks = generate_area(cachedGenerator, size);
+    auto script = dynamic_cast<TestGeneratorScript*>(def->script.get());
+    auto cachedScript =
+        dynamic_cast<TestGeneratorScript*>(cachedDef->script.get());
+    EXPECT_EQ(cachedScript->heightmapCalls, 0);
+    // only the outer ring of prototypes not reaching heightmaps generation
+    EXPECT_LT(cachedScript->parameterCalls, script->parameterCalls);
+    expect_same_chunks(chunks, expected);
+
+    // prototypes stored with another script or heightmap settings
+    // are discarded
+    for (int variant = 0; variant < 2; variant++) {
+        auto changedDef = create_generator(*content, 1);
+        if (variant == 0) {
+            changedDef->scriptHash = 1;
+        } else {
+            changedDef->heightsBPD = 8;
+        }
+        WorldGenerator changedGenerator(*changedDef, *content, 0);
+        changedGenerator.setPrototypesStorage(&storage);
+        generate_area(changedGenerator, size);
+        auto changedScript =
+            dynamic_cast<TestGeneratorScript*>(changedDef->script.get());
+        EXPECT_GT(changedScript->heightmapCalls, 0) << "variant " << variant;
+    }
+
+    // prototypes stored with another seed are discarded
+    auto otherDef = create_generator(*content, 1);
+    WorldGenerator otherGenerator(*otherDef, *content, 1);
+    otherGenerator.setPrototypesStorage(&storage);
+    generate_area(otherGenerator, size);
+    auto otherScript =
+        dynamic_cast<TestGeneratorScript*>(otherDef->script.get());
+    EXPECT_EQ(otherScript->heightmapCalls, script->heightmapCalls);
+}
+
+static void add_pillar_structure(GeneratorDef& def) {
+    glm::ivec3 size {1, 6, 1};
+    std::vector<voxel> voxels(size.y, voxel {1, {}});
+    def.structuresIndices["test:pillar"] = 0;
+    def.structures.push_back(std::make_unique<VoxelStructure>(
+        VoxelStructureMeta {"test:pillar"},
+        std::make_unique<VoxelFragment>(
+            size,
+            std::move(voxels),
+            std::vector<std::string> {CORE_AIR, "test:stone"}
+        )
+    ));
+    if (auto script = dynamic_cast<TestGeneratorScript*>(def.script.get())) {
+        script->placements.emplace_back(
+            1, StructurePlacement {0, {3, 80, 4}, 0}
+        );
+    }
+}
+
+TEST(WorldGenerator, ParallelScripts) {
+    auto content = create_content();
+    const int size = 8;
+
+    for (uint batchChunks : {1, 4}) {
+        auto def = create_generator(*content, batchChunks);
+        add_pillar_structure(*def);
+        def->prepare(content.get());
+        WorldGenerator generator(*def, *content, 0);
+        auto expected = generate_area(generator, size);
+
+        auto parallelDef = create_generator(*content, batchChunks);
+        add_pillar_structure(*parallelDef);
+        parallelDef->prepare(content.get());
+        WorldGenerator parallelGenerator(*parallelDef, *content, 0);
+        ASSERT_TRUE(parallelGenerator.createWorkers(4));
+        parallelGenerator.update(0, 0, size);
+        // completed chunks with biomes-only ring of 3 chunks
+        std::vector<glm::ivec2> aheadChunks;
+        for (int z = -size / 2 - 3; z < size / 2 + 3; z++) {
+            for (int x = -size / 2 - 3; x < size / 2 + 3; x++) {
+                aheadChunks.emplace_back(x, z);
+            }
+        }
+        parallelGenerator.generateAhead(aheadChunks);
+        auto chunks = generate_area(parallelGenerator, size);
+
+        auto script =
+            dynamic_cast<TestGeneratorScript*>(parallelDef->script.get());
+        EXPECT_EQ(script->heightmapCalls, 0);
+        EXPECT_EQ(script->parameterCalls, 0);
+        SCOPED_TRACE("batch " + std::to_string(batchChunks));
+        expect_same_chunks(chunks, expected);
+    }
+}
+
+/// @brief Places pillars using the global math.random
+static const char* LUA_GENERATOR_SCRIPT = R"(
+function place_structures(x, z, w, d, hmap, chunk_height)
+    local placements = {}
+    for i = 1, 3 do
+        table.insert(placements, {
+            "test:pillar",
+            {math.random() * w, 70 + math.random() * 20, math.random() * d},
+            0
+        })
+    end
+    return placements
+end
+)";
+
+TEST(WorldGenerator, LuaWorkers) {
+    if (!std::filesystem::is_directory("res/scripts")) {
+        GTEST_SKIP() << "res not found";
+    }
+    io::set_device("res", std::make_shared<io::StdfsDevice>("res"));
+    auto root = std::filesystem::temp_directory_path() / "luagentest";
+    std::filesystem::create_directories(root);
+    io::set_device("luagentest", std::make_shared<io::StdfsDevice>(root));
+    io::write_string("luagentest:script.lua", LUA_GENERATOR_SCRIPT);
+
+    auto content = create_content();
+    const int size = 8;
+    auto create_lua_generator = [&content](uint batchChunks) {
+        auto def = create_generator(*content, batchChunks);
+        def->script = scripting::load_generator(
+            *def, "luagentest:script.lua", "luagentest:"
+        );
+        add_pillar_structure(*def);
+        def->prepare(content.get());
+        return def;
+    };
+
+    for (uint batchChunks : {1, 4}) {
+        SCOPED_TRACE("batch " + std::to_string(batchChunks));
+        auto def = create_lua_generator(batchChunks);
+        WorldGenerator generator(*def, *content, 0);
+        auto expected = generate_area(generator, size);
+
+        // placements of ahead prototypes are made by other Lua states
+        // in another order
+        auto parallelDef = create_lua_generator(batchChunks);
+        WorldGenerator parallelGenerator(*parallelDef, *content, 0);
+        ASSERT_TRUE(parallelGenerator.createWorkers(4));
+        parallelGenerator.update(0, 0, size);
+        std::vector<glm::ivec2> aheadChunks;
+        for (int z = size / 2 + 2; z >= -size / 2 - 3; z--) {
+            for (int x = size / 2 + 2; x >= -size / 2 - 3; x--) {
+                aheadChunks.emplace_back(x, z);
+            }
+        }
+        parallelGenerator.generateAhead(aheadChunks);
+        auto chunks = generate_area(parallelGenerator, size);
+        expect_same_chunks(chunks, expected);
+
+        size_t pillarVoxels = 0;
+        for (const auto& voxels : expected) {
+            for (uint y = 70; y < CHUNK_H; y++) {
+                for (uint i = 0; i < CHUNK_W * CHUNK_D; i++) {
+                    pillarVoxels += voxels[y * CHUNK_W * CHUNK_D + i].id != 0;
+                }
+            }
+        }
+        EXPECT_GT(pillarVoxels, 0);
+    }
+    io::remove_device("luagentest");
+}
+
+TEST(WorldGenerator, Profile) {
+    auto content = create_content();
+    const int size = 4;
+
+    auto def = create_generator(*content, 1);
+    WorldGenerator generator(*def, *content, 0);
+    generate_area(generator, size);
+    // interval is not completed yet
+    EXPECT_EQ(generator.getProfile().total().calls, 0);
+    generator.setProfileInterval(0);
+    generator.update(0, 0, size);
+
+    const auto& profile = generator.getProfile();
+    EXPECT_GT(profile.interval, 0);
+    auto stage = [&profile](GeneratorStage stage) {
+        return profile.stages[static_cast<size_t>(stage)];
+    };
+    EXPECT_EQ(stage(GeneratorStage::LAND).calls, size * size);
+    EXPECT_EQ(stage(GeneratorStage::PLANTS).calls, size * size);
+    EXPECT_EQ(stage(GeneratorStage::DENSITY).calls, 0);
+    EXPECT_GE(stage(GeneratorStage::HEIGHTMAP).calls, size * size);
+    for (const auto& stats : profile.stages) {
+        EXPECT_LE(stats.scriptTime, stats.time);
+    }
+
+    auto root = profile.serialize();
+    EXPECT_EQ(
+        root["stages"]["land"]["calls"].asInteger(),
+        static_cast<dv::integer_t>(size * size)
+    );
+    EXPECT_EQ(
+        root["total"]["calls"].asInteger(),
+        static_cast<dv::integer_t>(profile.total().calls)
+    );
+}